@@ -19,7 +19,10 @@
 #define FREE_FLEET__INCLUDE__FREE_FLEET__CLIENT_HPP
 
 #include <memory>
+#include <cstdint>
 
+#include <free_fleet/Tracer.hpp>
+#include <free_fleet/Metrics.hpp>
 #include <free_fleet/ClientConfig.hpp>
 
 #include <free_fleet/messages/RobotState.hpp>
@@ -63,6 +66,21 @@ public:
   ///   True if a new mode request was received, false otherwise.
   bool read_mode_request(messages::ModeRequest& mode_request);
 
+  /// Waits for a new mode request on the reliable priority topic, which only
+  /// carries the requests that pause, resume or stop the robot, so that they
+  /// can be handled as soon as they arrive by a dedicated thread. Returns
+  /// false immediately when priority mode requests are not configured.
+  ///
+  /// \param[out] mode_request
+  ///   Newly received priority mode request from the free fleet server.
+  /// \param[in] timeout
+  ///   Maximum time to wait for a request, in seconds.
+  /// \return
+  ///   True if a new priority mode request was received before the timeout,
+  ///   false otherwise.
+  bool wait_priority_mode_request(
+      messages::ModeRequest& mode_request, double timeout);
+
   /// Attempts to read and receive a new path request from the free fleet
   /// server, for commanding the robot client.
   ///
@@ -84,6 +102,33 @@ public:
   bool read_destination_request(
       messages::DestinationRequest& destination_request);
 
+  /// Gets the current estimate of the offset of this client's clock from the
+  /// server's clock, measured using the source timestamps of the requests
+  /// received so far, such that client time = server time + offset. The
+  /// estimate includes the smallest latency observed between the two.
+  ///
+  /// \param[out] offset_nanosec
+  ///   Estimated clock offset in nanoseconds.
+  /// \return
+  ///   True if an estimate is available, false if no requests have been
+  ///   received yet.
+  bool get_server_clock_offset(int64_t& offset_nanosec) const;
+
+  /// Gets the tracer of this client. Requests with a trace are stamped with
+  /// the "client_receive" stage as soon as they are read.
+  ///
+  /// \return
+  ///   Shared pointer to the tracer of this client.
+  Tracer::SharedPtr get_tracer() const;
+
+  /// Gets the metrics of this client, which count the samples taken and
+  /// written on every topic, their size, drops and conversion times. Users
+  /// may register their own metrics in the same registry.
+  ///
+  /// \return
+  ///   Shared pointer to the metrics registry of this client.
+  Metrics::SharedPtr get_metrics() const;
+
   /// Destructor
   ~Client();
 
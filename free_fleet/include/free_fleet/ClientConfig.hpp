@@ -30,6 +30,46 @@ struct ClientConfig
   std::string dds_path_request_topic = "path_request";
   std::string dds_destination_request_topic = "destination_request";
 
+  /// Uses Cyclone's shared memory transport with the other processes on the
+  /// same host instead of loopback networking, see common::create_participant
+  bool dds_shared_memory = false;
+
+  /// Publishes robot states on the extended robot state topic instead, with
+  /// their paths in the compressed form quantized to 1 mm, 1 mrad and 1 us,
+  /// and also reads path requests from the extended path request topic.
+  /// Servers need to enable it as well.
+  bool dds_compress_paths = false;
+  std::string dds_extended_state_topic = "extended_robot_state";
+  std::string dds_extended_path_request_topic = "extended_path_request";
+
+  /// Also reads mode, path and destination requests from the extended
+  /// request topics, which carry their traces. Servers need to enable it as
+  /// well.
+  bool dds_trace_requests = false;
+  std::string dds_extended_mode_request_topic = "extended_mode_request";
+  std::string dds_extended_destination_request_topic =
+      "extended_destination_request";
+
+  /// Publishes robot states on the compact topic instead, which refers to
+  /// names through numeric IDs that are announced once on the name registry
+  /// topic. Servers need to enable it as well to read them.
+  bool dds_compact_state = false;
+  std::string dds_compact_state_topic = "compact_robot_state";
+  std::string dds_name_registry_topic = "name_registry";
+
+  /// Receives PAUSE, EMERGENCY and RESUME mode requests on their own
+  /// reliable topic, through Client::wait_priority_mode_request. Path and
+  /// destination requests written before the last stop are then ignored.
+  bool dds_priority_mode_request = false;
+  std::string dds_priority_mode_request_topic = "priority_mode_request";
+
+  /// Also reads path requests from the reliable fleet path request topic,
+  /// picking out the newest entry of the robot with the given name among
+  /// all the batches received.
+  bool dds_fleet_path_request = false;
+  std::string dds_fleet_path_request_topic = "fleet_path_request";
+  std::string robot_name = "";
+
   void print_config() const;
 };
 
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET__INCLUDE__FREE_FLEET__METRICS_HPP
+#define FREE_FLEET__INCLUDE__FREE_FLEET__METRICS_HPP
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+namespace free_fleet {
+
+/// Registry of counters, gauges and histograms that can be exported in the
+/// Prometheus text format.
+///
+/// Registering a metric takes a lock, and returns a reference that stays
+/// valid for the lifetime of the registry. Updating a metric through that
+/// reference never takes a lock, hence callers are expected to register
+/// their metrics once and keep the references around. A metric name must
+/// only ever be used for a single type of metric.
+class Metrics
+{
+public:
+
+  using SharedPtr = std::shared_ptr<Metrics>;
+  using Labels = std::vector<std::pair<std::string, std::string>>;
+
+  /// Monotonically increasing count.
+  class Counter
+  {
+  public:
+
+    Counter();
+
+    void increment(uint64_t value = 1);
+
+    uint64_t get() const;
+
+  private:
+
+    std::atomic<uint64_t> value;
+
+  };
+
+  /// Value that can go up and down.
+  class Gauge
+  {
+  public:
+
+    Gauge();
+
+    void set(double value);
+
+    void add(double value);
+
+    double get() const;
+
+  private:
+
+    std::atomic<double> value;
+
+  };
+
+  /// Distribution of observed values over fixed buckets. Observations are
+  /// spread over a few shards picked by thread, so threads observing the
+  /// same histogram rarely contend on the same cache lines.
+  class Histogram
+  {
+  public:
+
+    /// \param[in] upper_bounds
+    ///   Sorted inclusive upper bounds of the buckets, a bucket for all
+    ///   larger values is always added.
+    explicit Histogram(const std::vector<double>& upper_bounds);
+
+    void observe(double value);
+
+    struct Snapshot
+    {
+      std::vector<double> upper_bounds;
+
+      /// Cumulative counts, one per upper bound and one last for all values
+      std::vector<uint64_t> cumulative_counts;
+
+      double sum;
+    };
+
+    Snapshot get_snapshot() const;
+
+  private:
+
+    static constexpr std::size_t ShardNum = 8;
+
+    struct Shard
+    {
+      std::unique_ptr<std::atomic<uint64_t>[]> counts;
+      std::atomic<double> sum;
+
+      /// Keeps shards on separate cache lines
+      char padding[64];
+    };
+
+    std::vector<double> upper_bounds;
+
+    std::unique_ptr<Shard[]> shards;
+
+  };
+
+  /// Default histogram buckets for latencies, in seconds.
+  static const std::vector<double> LatencyBuckets;
+
+  /// Factory function that creates an empty registry.
+  static SharedPtr make();
+
+  /// Gets the counter with the given name and labels, registering it first
+  /// if needed.
+  Counter& counter(
+      const std::string& name,
+      const std::string& help,
+      const Labels& labels = {});
+
+  /// Gets the gauge with the given name and labels, registering it first if
+  /// needed.
+  Gauge& gauge(
+      const std::string& name,
+      const std::string& help,
+      const Labels& labels = {});
+
+  /// Gets the histogram with the given name and labels, registering it first
+  /// with the given bucket upper bounds if needed.
+  Histogram& histogram(
+      const std::string& name,
+      const std::string& help,
+      const Labels& labels = {},
+      const std::vector<double>& upper_bounds = LatencyBuckets);
+
+  /// Formats all the registered metrics in the Prometheus text exposition
+  /// format, version 0.0.4.
+  std::string to_prometheus_text() const;
+
+  /// Writes all the registered metrics in the Prometheus text format to a
+  /// file. The file is replaced atomically, so readers never see a
+  /// partially written file.
+  ///
+  /// \param[in] path
+  ///   Path of the file to be written.
+  /// \return
+  ///   True if the file was written, false otherwise.
+  bool write_to_file(const std::string& path) const;
+
+private:
+
+  struct Family
+  {
+    std::string type;
+    std::string help;
+    std::map<std::string, std::unique_ptr<Counter>> counters;
+    std::map<std::string, std::unique_ptr<Gauge>> gauges;
+    std::map<std::string, std::unique_ptr<Histogram>> histograms;
+  };
+
+  mutable std::mutex mutex;
+
+  std::map<std::string, Family> families;
+
+  Family& get_family(
+      const std::string& name,
+      const std::string& type,
+      const std::string& help);
+
+  Metrics();
+
+};
+
+} // namespace free_fleet
+
+#endif // FREE_FLEET__INCLUDE__FREE_FLEET__METRICS_HPP
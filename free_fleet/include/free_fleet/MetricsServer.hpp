@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET__INCLUDE__FREE_FLEET__METRICSSERVER_HPP
+#define FREE_FLEET__INCLUDE__FREE_FLEET__METRICSSERVER_HPP
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <free_fleet/Metrics.hpp>
+
+namespace free_fleet {
+
+/// Minimal HTTP endpoint which answers every request with the metrics of a
+/// registry in the Prometheus text format, served from its own thread.
+class MetricsServer
+{
+public:
+
+  using SharedPtr = std::shared_ptr<MetricsServer>;
+
+  /// Factory function that starts serving metrics.
+  ///
+  /// \param[in] metrics
+  ///   Registry of the metrics to be served.
+  /// \param[in] port
+  ///   TCP port to listen on.
+  /// \param[in] address
+  ///   IPv4 address to listen on, only the local machine by default.
+  /// \return
+  ///   Shared pointer to the metrics server, nullptr if the port could not
+  ///   be listened on.
+  static SharedPtr make(
+      Metrics::SharedPtr metrics,
+      int port,
+      const std::string& address = "127.0.0.1");
+
+  /// Destructor, stops serving metrics.
+  ~MetricsServer();
+
+private:
+
+  Metrics::SharedPtr metrics;
+
+  int socket_fd;
+
+  std::atomic<bool> running;
+
+  std::thread serve_thread;
+
+  void serve_thread_fn();
+
+  void respond(int connection_fd);
+
+  MetricsServer(Metrics::SharedPtr metrics, int socket_fd);
+
+};
+
+} // namespace free_fleet
+
+#endif // FREE_FLEET__INCLUDE__FREE_FLEET__METRICSSERVER_HPP
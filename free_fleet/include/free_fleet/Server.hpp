@@ -18,9 +18,15 @@
 #ifndef FREE_FLEET__INCLUDE__FREE_FLEET__SERVER_HPP
 #define FREE_FLEET__INCLUDE__FREE_FLEET__SERVER_HPP
 
+#include <string>
+#include <future>
 #include <memory>
 #include <vector>
+#include <cstdint>
+#include <functional>
 
+#include <free_fleet/Tracer.hpp>
+#include <free_fleet/Metrics.hpp>
 #include <free_fleet/ServerConfig.hpp>
 
 #include <free_fleet/messages/RobotState.hpp>
@@ -36,6 +42,74 @@ public:
 
   using SharedPtr = std::shared_ptr<Server>;
 
+  /// Outcome of a request tracked until its acknowledgement, see
+  /// ServerConfig::request_ack_timeout.
+  struct DeliveryReport
+  {
+    enum class Status
+    {
+      /// The robot echoed the task ID of the request in its state
+      Delivered,
+
+      /// No acknowledgement came after every retransmission
+      TimedOut,
+
+      /// A request for another task was sent to the robot before this one
+      /// was acknowledged
+      Superseded
+    };
+
+    Status status;
+
+    std::string robot_name;
+
+    std::string task_id;
+
+    /// Number of times the request was sent again
+    uint32_t retransmissions;
+
+    /// Time from the first send until the outcome
+    int64_t latency_nanosec;
+  };
+
+  using DeliveryCallback = std::function<void(const DeliveryReport&)>;
+
+  /// Called with the outcome of a request sent asynchronously, true if it
+  /// was successfully sent.
+  using SendCallback = std::function<void(bool)>;
+
+  /// Robot states of one shard that were taken from DDS but not deserialized
+  /// yet, see take_robot_states. Best reused between takes so that it only
+  /// allocates while it grows.
+  struct RobotStateBatch
+  {
+    struct Sample
+    {
+      /// Offset and size of the sample in data, encapsulation header
+      /// included
+      std::size_t offset;
+
+      std::size_t size;
+
+      /// Whether the sample has the layout of the extended robot state
+      bool extended;
+    };
+
+    /// Serialized samples, back to back
+    std::vector<uint8_t> data;
+
+    std::vector<Sample> samples;
+
+    /// Robot states that are converted while they are taken, such as compact
+    /// robot states which refer to the names announced so far
+    std::vector<messages::RobotState> robot_states;
+
+    void clear();
+  };
+
+  /// Gets the index of the batch for the states of a robot.
+  using ShardFn = std::function<std::size_t(const std::string&)>;
+
   /// Factory function that creates an instance of the Free Fleet Server.
   ///
   /// \param[in] config
@@ -54,6 +128,34 @@ public:
   ///   True if new robot states were received, false otherwise.
   bool read_robot_states(std::vector<messages::RobotState>& new_robot_states);
 
+  /// Attempts to take new incoming robot states like read_robot_states, but
+  /// only reads their robot names to sort them into batches, leaving the
+  /// rest of their deserialization to deserialize_robot_states so that
+  /// batches may be deserialized on several threads. Tracked requests that
+  /// timed out are sent again from here.
+  ///
+  /// \param[in] get_shard
+  ///   Gets the index of the batch for the states of a robot, which must be
+  ///   less than the number of batches.
+  /// \param[in,out] batches
+  ///   Batches the new robot states are appended to.
+  /// \return
+  ///   True if new robot states were taken, false otherwise.
+  bool take_robot_states(
+      const ShardFn& get_shard, std::vector<RobotStateBatch>& batches);
+
+  /// Deserializes a batch of robot states taken by take_robot_states, and
+  /// acknowledges the tracked requests with them. Different batches may be
+  /// deserialized concurrently.
+  ///
+  /// \param[in,out] batch
+  ///   Batch to be deserialized, cleared afterwards.
+  /// \param[out] new_robot_states
+  ///   Robot states of the batch, appended to.
+  void deserialize_robot_states(
+      RobotStateBatch& batch,
+      std::vector<messages::RobotState>& new_robot_states);
+
   /// Attempts to send a new mode request to all the clients. Clients are in
   /// charge to identify if requests are targetted towards them.
   /// 
@@ -82,6 +184,112 @@ public:
   bool send_destination_request(
       const messages::DestinationRequest& destination_request);
 
+  /// Attempts to send new path requests for several robots at once. They
+  /// are written as a single sample per fleet when fleet path requests are
+  /// configured, see ServerConfig::dds_fleet_path_request, and one by one
+  /// otherwise.
+  ///
+  /// \param[in] path_requests
+  ///   New path requests to be sent out to the clients.
+  /// \return
+  ///   True if every path request was successfully sent, false otherwise.
+  bool send_batch(const std::vector<messages::PathRequest>& path_requests);
+
+  /// Queues a new mode request to be sent to the clients from the writer
+  /// thread of this server, and returns without waiting for it to be
+  /// converted or written. Requests are sent in the order they were queued,
+  /// whichever thread queued them, except for PAUSE, EMERGENCY and RESUME
+  /// mode requests when ServerConfig::dds_priority_mode_request is set,
+  /// which are sent right away. A stop sent that way drops the path and
+  /// destination requests of its robot that are still queued, and the
+  /// retransmissions of its tracked request.
+  ///
+  /// \param[in] mode_request
+  ///   New mode request to be sent out to the clients.
+  /// \return
+  ///   Future result of send_mode_request.
+  std::future<bool> send_mode_request_async(
+      const messages::ModeRequest& mode_request);
+
+  /// Queues a new mode request to be sent to the clients from the writer
+  /// thread of this server.
+  ///
+  /// \param[in] mode_request
+  ///   New mode request to be sent out to the clients.
+  /// \param[in] callback
+  ///   Called from the writer thread with the result of send_mode_request,
+  ///   it should not block.
+  void send_mode_request_async(
+      const messages::ModeRequest& mode_request, SendCallback callback);
+
+  /// Queues a new path request to be sent to the clients from the writer
+  /// thread of this server, see send_mode_request_async.
+  ///
+  /// \param[in] path_request
+  ///   New path request to be sent out to the clients.
+  /// \return
+  ///   Future result of send_path_request.
+  std::future<bool> send_path_request_async(
+      const messages::PathRequest& path_request);
+
+  /// Queues a new path request to be sent to the clients from the writer
+  /// thread of this server, see send_mode_request_async.
+  ///
+  /// \param[in] path_request
+  ///   New path request to be sent out to the clients.
+  /// \param[in] callback
+  ///   Called from the writer thread with the result of send_path_request,
+  ///   it should not block.
+  void send_path_request_async(
+      const messages::PathRequest& path_request, SendCallback callback);
+
+  /// Queues a new destination request to be sent to the clients from the
+  /// writer thread of this server, see send_mode_request_async.
+  ///
+  /// \param[in] destination_request
+  ///   New destination request to be sent out to the clients.
+  /// \return
+  ///   Future result of send_destination_request.
+  std::future<bool> send_destination_request_async(
+      const messages::DestinationRequest& destination_request);
+
+  /// Queues a new destination request to be sent to the clients from the
+  /// writer thread of this server, see send_mode_request_async.
+  ///
+  /// \param[in] destination_request
+  ///   New destination request to be sent out to the clients.
+  /// \param[in] callback
+  ///   Called from the writer thread with the result of
+  ///   send_destination_request, it should not block.
+  void send_destination_request_async(
+      const messages::DestinationRequest& destination_request,
+      SendCallback callback);
+
+  /// Sets the callback called with the outcome of every tracked request.
+  /// Outcomes are only known when reading, taking or deserializing robot
+  /// states or sending requests, and the callback is called from within
+  /// those calls, including from the writer thread for requests sent
+  /// asynchronously.
+  ///
+  /// \param[in] callback
+  ///   Callback to be called, replacing any previous one.
+  void set_delivery_callback(DeliveryCallback callback);
+
+  /// Gets the tracer of this server. Requests with a trace are stamped with
+  /// the "server_send" stage right before they are sent out.
+  ///
+  /// \return
+  ///   Shared pointer to the tracer of this server.
+  Tracer::SharedPtr get_tracer() const;
+
+  /// Gets the metrics of this server, which count the samples taken and
+  /// written on every topic, their size, drops and conversion times. Users
+  /// may register their own metrics in the same registry.
+  ///
+  /// \return
+  ///   Shared pointer to the metrics registry of this server.
+  Metrics::SharedPtr get_metrics() const;
+
   /// Destructor
   ~Server();
 
@@ -19,17 +19,76 @@
 #define FREE_FLEET__INCLUDE__FREE_FLEET__SERVERCONFIG_HPP
 
 #include <string>
+#include <vector>
 
 namespace free_fleet {
 
 struct ServerConfig
 {
   int dds_domain = 42;
+
+  /// Further domains joined alongside dds_domain, for sites that split their
+  /// robots across domains to limit discovery traffic. Robot states are
+  /// merged from all domains, and requests are sent on the domain where each
+  /// robot was last seen, or on all of them for robots not seen yet.
+  std::vector<int> dds_extra_domains;
+
   std::string dds_robot_state_topic = "robot_state";
   std::string dds_mode_request_topic = "mode_request";
   std::string dds_path_request_topic = "path_request";
   std::string dds_destination_request_topic = "destination_request";
 
+  /// Uses Cyclone's shared memory transport with the other processes on the
+  /// same host instead of loopback networking, see common::create_participant
+  bool dds_shared_memory = false;
+
+  /// Sends path requests on the extended path request topic instead, with
+  /// their paths in the compressed form quantized to 1 mm, 1 mrad and 1 us,
+  /// and also reads robot states from the extended robot state topic. The
+  /// extended topics carry their own types, so peers that only know the
+  /// regular ones are unaffected. Clients need to enable it as well.
+  bool dds_compress_paths = false;
+  std::string dds_extended_robot_state_topic = "extended_robot_state";
+  std::string dds_extended_path_request_topic = "extended_path_request";
+
+  /// Sends mode and destination requests on the extended request topics
+  /// instead, along with their traces, see Tracer. Path requests are sent on
+  /// the extended path request topic as well. Clients need to enable it as
+  /// well.
+  bool dds_trace_requests = false;
+  std::string dds_extended_mode_request_topic = "extended_mode_request";
+  std::string dds_extended_destination_request_topic =
+      "extended_destination_request";
+
+  /// Requests are tracked until the robot acknowledges them by echoing their
+  /// task ID in its state, and sent again every timeout in seconds until
+  /// then, up to the maximum number of retransmissions. Requests for a task
+  /// that is already pending or acknowledged are not sent again. Disabled
+  /// when the timeout is not positive.
+  double request_ack_timeout = 0.0;
+  int request_max_retransmissions = 3;
+
+  /// Also reads robot states from the compact topic, resolving the IDs they
+  /// refer to with the names announced on the name registry topic. Clients
+  /// that still publish the regular robot states keep being supported.
+  bool dds_compact_robot_state = false;
+  std::string dds_compact_robot_state_topic = "compact_robot_state";
+  std::string dds_name_registry_topic = "name_registry";
+
+  /// Sends PAUSE, EMERGENCY and RESUME mode requests on their own reliable
+  /// topic instead, so that they are neither lost nor queued behind other
+  /// requests. Path and destination requests queued before a stop are
+  /// dropped. The topic always carries the extended mode request type.
+  /// Clients need to enable it as well.
+  bool dds_priority_mode_request = false;
+  std::string dds_priority_mode_request_topic = "priority_mode_request";
+
+  /// Writes the path requests given together to Server::send_batch as one
+  /// sample per fleet on the reliable fleet path request topic, instead of
+  /// one sample per robot. Clients need to enable it as well to read them.
+  bool dds_fleet_path_request = false;
+  std::string dds_fleet_path_request_topic = "fleet_path_request";
+
   void print_config() const;
 };
 
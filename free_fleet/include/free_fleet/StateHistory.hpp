@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET__INCLUDE__FREE_FLEET__STATEHISTORY_HPP
+#define FREE_FLEET__INCLUDE__FREE_FLEET__STATEHISTORY_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <free_fleet/messages/RobotState.hpp>
+
+namespace free_fleet {
+
+/// History of robot states, kept in a memory mapped ring file of fixed size
+/// records. Once the ring is full, every new state overwrites the oldest.
+///
+/// A single process appends to the history, while any number of processes
+/// can open the same file read-only and query it concurrently. Records are
+/// ordered by the time they were appended at, which is expected to be
+/// non-decreasing for time range queries to be exact.
+class StateHistory
+{
+public:
+
+  using SharedPtr = std::shared_ptr<StateHistory>;
+
+  static constexpr std::size_t NameSize = 32;
+
+  /// Single entry of the history, stored as is in the file. Names longer
+  /// than NameSize - 1 characters are truncated.
+  struct Record
+  {
+    /// Time at which the state was appended, in nanoseconds since epoch
+    int64_t stamp;
+
+    int32_t location_sec;
+    uint32_t location_nanosec;
+    float x;
+    float y;
+    float yaw;
+    float battery_percent;
+    uint32_t mode;
+    uint32_t reserved;
+
+    char robot_name[NameSize];
+    char level_name[NameSize];
+    char task_id[NameSize];
+  };
+
+  /// Opens a history for appending, creating it if needed. An existing
+  /// history with the same capacity is kept and appended to, any other file
+  /// at the path is overwritten.
+  ///
+  /// \param[in] path
+  ///   Path of the ring file.
+  /// \param[in] capacity
+  ///   Maximum number of records kept.
+  /// \return
+  ///   Shared pointer to the history, nullptr if the file could not be
+  ///   created or mapped.
+  static SharedPtr make(const std::string& path, std::size_t capacity);
+
+  /// Opens an existing history read-only, for querying.
+  ///
+  /// \param[in] path
+  ///   Path of the ring file.
+  /// \return
+  ///   Shared pointer to the history, nullptr if the file could not be
+  ///   mapped or is not a state history.
+  static SharedPtr open(const std::string& path);
+
+  ~StateHistory();
+
+  /// Appends a robot state, never blocks nor allocates. Must only be called
+  /// from a single thread, and never on a history opened read-only.
+  ///
+  /// \param[in] state
+  ///   Robot state to be appended, its path and model are not kept.
+  /// \param[in] stamp
+  ///   Time at which the state was ingested, in nanoseconds since epoch.
+  /// \return
+  ///   True if the state was appended, false if the history is read-only.
+  bool append(const messages::RobotState& state, int64_t stamp);
+
+  /// Gets the records appended within a time range, oldest first.
+  ///
+  /// \param[in] start
+  ///   Start of the time range, inclusive, in nanoseconds since epoch.
+  /// \param[in] end
+  ///   End of the time range, inclusive, in nanoseconds since epoch.
+  /// \param[out] records
+  ///   Records within the time range, replacing any previous content.
+  /// \param[in] robot_name
+  ///   Only keeps the records of this robot when not empty.
+  /// \return
+  ///   Number of records found.
+  std::size_t query(
+      int64_t start,
+      int64_t end,
+      std::vector<Record>& records,
+      const std::string& robot_name = "") const;
+
+  /// Gets the number of records currently kept.
+  std::size_t size() const;
+
+  /// Gets the maximum number of records kept.
+  std::size_t capacity() const;
+
+private:
+
+  /// Layout of the ring file, a FileHeader followed by capacity Slots
+  struct FileHeader;
+  struct Slot;
+
+  FileHeader* header;
+
+  Slot* slots;
+
+  std::size_t mapped_size;
+
+  bool writable;
+
+  StateHistory(void* mapped, std::size_t mapped_size, bool writable);
+
+  /// Copies the record at an absolute index, false if it was overwritten
+  bool read_slot(uint64_t index, Record& record) const;
+
+};
+
+} // namespace free_fleet
+
+#endif // FREE_FLEET__INCLUDE__FREE_FLEET__STATEHISTORY_HPP
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET__INCLUDE__FREE_FLEET__TRACER_HPP
+#define FREE_FLEET__INCLUDE__FREE_FLEET__TRACER_HPP
+
+#include <map>
+#include <array>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <free_fleet/messages/Trace.hpp>
+
+namespace free_fleet {
+
+/// Records the hops of traced requests, and keeps a latency histogram for
+/// every pair of consecutive stages, as well as from the first stage of a
+/// trace to every later stage.
+///
+/// Hops are stamped with the wall clock, in the same epoch as the DDS source
+/// timestamps. The hops of a request received from another process, possibly
+/// on another machine, are converted to the local clock with the estimated
+/// offset of the sender's clock before any latency across the two is
+/// recorded, see stamp_received().
+class Tracer
+{
+public:
+
+  using SharedPtr = std::shared_ptr<Tracer>;
+
+  /// Latency summary of a single stage transition, in milliseconds.
+  struct StageStatistics
+  {
+    std::string name;
+    uint64_t count;
+    double mean;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+  };
+
+  /// Factory function that creates a new tracer.
+  static SharedPtr make();
+
+  /// Gets the current time of the wall clock used to stamp hops.
+  ///
+  /// \return
+  ///   Nanoseconds since the Unix epoch.
+  static int64_t now();
+
+  /// Starts tracing a request, replacing any previous hops with the first
+  /// hop of the new trace.
+  ///
+  /// \param[out] trace
+  ///   Trace of the request to be started.
+  /// \param[in] id
+  ///   Identifier of the new trace, must not be empty.
+  /// \param[in] stage
+  ///   Name of the first stage of the trace.
+  /// \param[in] stamp
+  ///   Time at which the first stage was reached, defaults to now.
+  void start(
+      messages::Trace& trace,
+      const std::string& id,
+      const std::string& stage,
+      int64_t stamp = now());
+
+  /// Adds a hop to a traced request and records the latency since the
+  /// previous hop, and since the first hop. Requests that are not traced are
+  /// left untouched.
+  ///
+  /// \param[in,out] trace
+  ///   Trace of the request.
+  /// \param[in] stage
+  ///   Name of the stage that was just reached.
+  /// \return
+  ///   True if the request is traced and the hop was added, false otherwise.
+  bool stamp(messages::Trace& trace, const std::string& stage);
+
+  /// Same as stamp(), for the first hop of a request received from another
+  /// process. The hops stamped by the sender are first converted to the
+  /// local clock, so that the latencies across the two processes, and those
+  /// of the hops added later, compare stamps of the same clock.
+  ///
+  /// As the offset is estimated from the fastest recent samples, the latency
+  /// of the transition across processes only counts the time beyond the
+  /// fastest delivery.
+  ///
+  /// \param[in] remote_offset_nanosec
+  ///   Estimated offset of the sender's clock, such that local time = remote
+  ///   time + offset.
+  bool stamp_received(
+      messages::Trace& trace,
+      const std::string& stage,
+      int64_t remote_offset_nanosec);
+
+  /// Same as above, when the offset of the sender's clock is not known. The
+  /// hops stamped by the sender are dropped instead, so that no latency is
+  /// recorded across the two clocks, and the trace goes on from this hop.
+  bool stamp_received(messages::Trace& trace, const std::string& stage);
+
+  /// Gets the latency statistics of all the stage transitions seen so far.
+  std::vector<StageStatistics> get_statistics() const;
+
+  /// Gets the latency statistics formatted as a human readable table.
+  std::string dump() const;
+
+  /// Clears all the recorded latencies.
+  void reset();
+
+private:
+
+  /// Histogram of latencies with 8 linear sub-buckets per power of two
+  /// microseconds, which keeps the relative error of percentiles under 12.5%
+  /// over the whole range.
+  struct Histogram
+  {
+    static constexpr std::size_t BucketNum = 320;
+
+    std::array<uint64_t, BucketNum> buckets;
+    uint64_t count;
+    int64_t sum_nanosec;
+    int64_t max_nanosec;
+
+    Histogram();
+
+    void add(int64_t latency_nanosec);
+
+    /// Upper bound in nanoseconds of the bucket holding the given quantile.
+    int64_t quantile(double q) const;
+  };
+
+  mutable std::mutex mutex;
+
+  std::map<std::string, Histogram> histograms;
+
+  void record(const std::string& name, int64_t latency_nanosec);
+
+  Tracer();
+
+};
+
+} // namespace free_fleet
+
+#endif // FREE_FLEET__INCLUDE__FREE_FLEET__TRACER_HPP
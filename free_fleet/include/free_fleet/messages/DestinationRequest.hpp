@@ -19,6 +19,7 @@
 #define FREE_FLEET__INCLUDE__FREE_FLEET__MESSAGES__DESTINATIONREQUEST_HPP
 
 #include "Location.hpp"
+#include "Trace.hpp"
 
 namespace free_fleet {
 namespace messages {
@@ -29,6 +30,7 @@ struct DestinationRequest
   std::string robot_name;
   Location destination;
   std::string task_id;
+  Trace trace;
 };
 
 } // namespace messages
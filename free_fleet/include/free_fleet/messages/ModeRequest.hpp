@@ -23,6 +23,7 @@
 
 #include "RobotMode.hpp"
 #include "ModeParameter.hpp"
+#include "Trace.hpp"
 
 namespace free_fleet {
 namespace messages {
@@ -34,6 +35,7 @@ struct ModeRequest
   RobotMode mode;
   std::string task_id;
   std::vector<ModeParameter> parameters;
+  Trace trace;
 };
 
 } // namespace messages
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "Location.hpp"
+#include "Trace.hpp"
 
 namespace free_fleet {
 namespace messages {
@@ -31,6 +32,7 @@ struct PathRequest
   std::string robot_name;
   std::vector<Location> path;
   std::string task_id;
+  Trace trace;
 };
 
 } // namespace messages
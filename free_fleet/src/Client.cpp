@@ -20,8 +20,10 @@
 #include <free_fleet/Client.hpp>
 
 #include "ClientImpl.hpp"
+#include "TypedTopics.hpp"
 
 #include "messages/FleetMessages.h"
+#include "dds_utils/common.hpp"
 #include "dds_utils/DDSPublishHandler.hpp"
 #include "dds_utils/DDSSubscribeHandler.hpp"
 
@@ -31,49 +33,145 @@ Client::SharedPtr Client::make(const ClientConfig& _config)
 {
   SharedPtr client = SharedPtr(new Client(_config));
 
-  dds_entity_t participant = dds_create_participant(
-      static_cast<dds_domainid_t>(_config.dds_domain), NULL, NULL);
+  dds_entity_t participant = common::create_participant(
+      _config.dds_domain, _config.dds_shared_memory);
   if (participant < 0)
   {
     DDS_FATAL("dds_create_participant: %s\n", dds_strretcode(-participant));
     return nullptr;
   }
 
-  dds::DDSPublishHandler<FreeFleetData_RobotState>::SharedPtr state_pub(
-      new dds::DDSPublishHandler<FreeFleetData_RobotState>(
-          participant, &FreeFleetData_RobotState_desc,
-          _config.dds_state_topic));
-
-  dds::DDSSubscribeHandler<FreeFleetData_ModeRequest>::SharedPtr 
-      mode_request_sub(
-          new dds::DDSSubscribeHandler<FreeFleetData_ModeRequest>(
-              participant, &FreeFleetData_ModeRequest_desc,
-              _config.dds_mode_request_topic));
-
-  dds::DDSSubscribeHandler<FreeFleetData_PathRequest>::SharedPtr 
-      path_request_sub(
-          new dds::DDSSubscribeHandler<FreeFleetData_PathRequest>(
-              participant, &FreeFleetData_PathRequest_desc,
-              _config.dds_path_request_topic));
-
-  dds::DDSSubscribeHandler<FreeFleetData_DestinationRequest>::SharedPtr
-      destination_request_sub(
-          new dds::DDSSubscribeHandler<FreeFleetData_DestinationRequest>(
-              participant, &FreeFleetData_DestinationRequest_desc,
-              _config.dds_destination_request_topic));
-
-  if (!state_pub->is_ready() ||
+  TypedPublisher<messages::RobotState>::SharedPtr state_pub;
+  dds::DDSPublishHandler<FreeFleetData_CompactRobotState>::SharedPtr
+      compact_state_pub;
+  dds::DDSPublishHandler<FreeFleetData_NameRegistryEntry>::SharedPtr
+      name_registry_pub;
+  if (_config.dds_compact_state)
+  {
+    compact_state_pub =
+        make_sample_publisher<FreeFleetData_CompactRobotState>(
+            participant,
+            messages::MessageTraits<FreeFleetData_CompactRobotState>::topic(
+                _config));
+    name_registry_pub =
+        make_sample_publisher<FreeFleetData_NameRegistryEntry>(
+            participant,
+            messages::MessageTraits<FreeFleetData_NameRegistryEntry>::topic(
+                _config),
+            dds::Qos::Durable);
+  }
+  else
+  {
+    // States with compressed paths go to a separate topic of the extended
+    // type, which only servers configured the same way read
+    using RobotStateTraits = messages::MessageTraits<messages::RobotState>;
+    state_pub = make_publisher<messages::RobotState>(
+        participant,
+        _config.dds_compress_paths ?
+            RobotStateTraits::extended_topic(_config) :
+            RobotStateTraits::topic(_config),
+        dds::Qos::BestEffort, _config.dds_compress_paths);
+  }
+
+  auto mode_request_sub = make_subscriber<messages::ModeRequest>(
+      participant,
+      messages::MessageTraits<messages::ModeRequest>::topic(_config));
+
+  auto path_request_sub = make_subscriber<messages::PathRequest>(
+      participant,
+      messages::MessageTraits<messages::PathRequest>::topic(_config));
+
+  // Requests carrying a trace or a compressed path come on separate topics
+  // of their extended types
+  TypedSubscriber<messages::ModeRequest>::SharedPtr
+      extended_mode_request_sub;
+  TypedSubscriber<messages::DestinationRequest>::SharedPtr
+      extended_destination_request_sub;
+  if (_config.dds_trace_requests)
+  {
+    extended_mode_request_sub = make_subscriber<messages::ModeRequest>(
+        participant,
+        messages::MessageTraits<messages::ModeRequest>::extended_topic(
+            _config),
+        dds::Qos::BestEffort, true);
+    extended_destination_request_sub =
+        make_subscriber<messages::DestinationRequest>(
+            participant,
+            messages::MessageTraits<messages::DestinationRequest>::
+                extended_topic(_config),
+            dds::Qos::BestEffort, true);
+  }
+
+  TypedSubscriber<messages::PathRequest>::SharedPtr
+      extended_path_request_sub;
+  if (_config.dds_compress_paths || _config.dds_trace_requests)
+  {
+    extended_path_request_sub = make_subscriber<messages::PathRequest>(
+        participant,
+        messages::MessageTraits<messages::PathRequest>::extended_topic(
+            _config),
+        dds::Qos::BestEffort, true);
+  }
+
+  auto destination_request_sub =
+      make_subscriber<messages::DestinationRequest>(
+          participant,
+          messages::MessageTraits<messages::DestinationRequest>::topic(
+              _config));
+
+  dds::DDSSubscribeHandler<FreeFleetData_FleetPathRequest>::SharedPtr
+      fleet_path_request_sub;
+  if (_config.dds_fleet_path_request)
+  {
+    fleet_path_request_sub =
+        make_sample_subscriber<FreeFleetData_FleetPathRequest>(
+            participant,
+            messages::MessageTraits<FreeFleetData_FleetPathRequest>::topic(
+                _config),
+            dds::Qos::Reliable);
+  }
+
+  TypedSubscriber<messages::ModeRequest>::SharedPtr
+      priority_mode_request_sub;
+  if (_config.dds_priority_mode_request)
+  {
+    priority_mode_request_sub = make_subscriber<messages::ModeRequest>(
+        participant, _config.dds_priority_mode_request_topic,
+        dds::Qos::Reliable, true);
+  }
+
+  if ((state_pub && !state_pub->is_ready()) ||
+      (compact_state_pub && !compact_state_pub->is_ready()) ||
+      (name_registry_pub && !name_registry_pub->is_ready()) ||
       !mode_request_sub->is_ready() ||
       !path_request_sub->is_ready() ||
-      !destination_request_sub->is_ready())
+      (extended_mode_request_sub &&
+          !extended_mode_request_sub->is_ready()) ||
+      (extended_path_request_sub &&
+          !extended_path_request_sub->is_ready()) ||
+      (extended_destination_request_sub &&
+          !extended_destination_request_sub->is_ready()) ||
+      !destination_request_sub->is_ready() ||
+      (fleet_path_request_sub && !fleet_path_request_sub->is_ready()) ||
+      (priority_mode_request_sub && !priority_mode_request_sub->is_ready()))
+  {
+    common::delete_participant(participant);
     return nullptr;
+  }
 
   client->impl->start(ClientImpl::Fields{
       std::move(participant),
       std::move(state_pub),
       std::move(mode_request_sub),
       std::move(path_request_sub),
-      std::move(destination_request_sub)});
+      std::move(destination_request_sub),
+      std::move(compact_state_pub),
+      std::move(name_registry_pub),
+      std::move(fleet_path_request_sub),
+      std::move(priority_mode_request_sub),
+      std::move(extended_mode_request_sub),
+      std::move(extended_path_request_sub),
+      std::move(extended_destination_request_sub)});
   return client;
 }
 
@@ -95,6 +193,12 @@ bool Client::read_mode_request(messages::ModeRequest& _mode_request)
   return impl->read_mode_request(_mode_request);
 }
 
+bool Client::wait_priority_mode_request(
+    messages::ModeRequest& _mode_request, double _timeout)
+{
+  return impl->wait_priority_mode_request(_mode_request, _timeout);
+}
+
 bool Client::read_path_request(messages::PathRequest& _path_request)
 {
   return impl->read_path_request(_path_request);
@@ -106,4 +210,19 @@ bool Client::read_destination_request(
   return impl->read_destination_request(_destination_request);
 }
 
+bool Client::get_server_clock_offset(int64_t& _offset_nanosec) const
+{
+  return impl->get_server_clock_offset(_offset_nanosec);
+}
+
+Tracer::SharedPtr Client::get_tracer() const
+{
+  return impl->get_tracer();
+}
+
+Metrics::SharedPtr Client::get_metrics() const
+{
+  return impl->get_metrics();
+}
+
 } // namespace free_fleet
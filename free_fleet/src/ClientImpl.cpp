@@ -15,18 +15,66 @@
  *
  */
 
+#include <algorithm>
+
 #include "ClientImpl.hpp"
+#include "TypedTopics.hpp"
+#include "dds_utils/common.hpp"
 #include "messages/message_utils.hpp"
 
 namespace free_fleet {
 
 Client::ClientImpl::ClientImpl(const ClientConfig& _config) :
+  tracer(Tracer::make()),
+  metrics(Metrics::make()),
+  state_metrics(
+      TopicMetrics::make_writer(
+          *metrics,
+          _config.dds_compress_paths ?
+              _config.dds_extended_state_topic :
+              _config.dds_state_topic)),
+  mode_request_metrics(
+      TopicMetrics::make_reader(*metrics, _config.dds_mode_request_topic)),
+  extended_mode_request_metrics(
+      TopicMetrics::make_reader(
+          *metrics, _config.dds_extended_mode_request_topic)),
+  path_request_metrics(
+      TopicMetrics::make_reader(*metrics, _config.dds_path_request_topic)),
+  extended_path_request_metrics(
+      TopicMetrics::make_reader(
+          *metrics, _config.dds_extended_path_request_topic)),
+  destination_request_metrics(
+      TopicMetrics::make_reader(
+          *metrics, _config.dds_destination_request_topic)),
+  extended_destination_request_metrics(
+      TopicMetrics::make_reader(
+          *metrics, _config.dds_extended_destination_request_topic)),
+  compact_state_metrics(
+      TopicMetrics::make_writer(*metrics, _config.dds_compact_state_topic)),
+  name_registry_metrics(
+      TopicMetrics::make_writer(*metrics, _config.dds_name_registry_topic)),
+  fleet_path_request_metrics(
+      TopicMetrics::make_reader(
+          *metrics, _config.dds_fleet_path_request_topic)),
+  priority_mode_request_metrics(
+      TopicMetrics::make_reader(
+          *metrics, _config.dds_priority_mode_request_topic)),
+  priority_mode_request_delay(&metrics->histogram(
+      "free_fleet_priority_mode_request_delay_seconds",
+      "Time from the source timestamp of a priority mode request until it "
+      "was taken, assuming synchronized clocks.")),
+  priority_waitset(0),
+  last_stop_time(0),
+  stale_requests(&metrics->counter(
+      "free_fleet_stale_requests_total",
+      "Path and destination requests ignored, as they were sent before the "
+      "last stop.")),
   client_config(_config)
 {}
 
 Client::ClientImpl::~ClientImpl()
 {
-  dds_return_t return_code = dds_delete(fields.participant);
+  dds_return_t return_code = common::delete_participant(fields.participant);
   if (return_code != DDS_RETCODE_OK)
   {
     DDS_FATAL("dds_delete: %s", dds_strretcode(-return_code));
@@ -36,25 +84,138 @@ Client::ClientImpl::~ClientImpl()
 void Client::ClientImpl::start(Fields _fields)
 {
   fields = std::move(_fields);
+
+  if (!fields.priority_mode_request_sub)
+    return;
+
+  // Both are children of the participant, deleted along with it
+  priority_waitset = dds_create_waitset(fields.participant);
+  if (priority_waitset < 0)
+  {
+    DDS_FATAL("dds_create_waitset: %s\n", dds_strretcode(-priority_waitset));
+    return;
+  }
+  dds_entity_t read_condition = dds_create_readcondition(
+      fields.priority_mode_request_sub->get_reader(), DDS_ANY_STATE);
+  if (read_condition < 0)
+  {
+    DDS_FATAL(
+        "dds_create_readcondition: %s\n", dds_strretcode(-read_condition));
+    return;
+  }
+  dds_return_t return_code =
+      dds_waitset_attach(priority_waitset, read_condition, 0);
+  if (return_code != DDS_RETCODE_OK)
+  {
+    DDS_FATAL("dds_waitset_attach: %s\n", dds_strretcode(-return_code));
+  }
 }
 
 bool Client::ClientImpl::send_robot_state(
     const messages::RobotState& _new_robot_state)
 {
-  FreeFleetData_RobotState* new_rs = FreeFleetData_RobotState__alloc();
-  convert(_new_robot_state, *new_rs);
-  bool sent = fields.state_pub->write(new_rs);
-  FreeFleetData_RobotState_free(new_rs, DDS_FREE_ALL);
-  return sent;
+  if (fields.compact_state_pub)
+    return send_compact_robot_state(_new_robot_state);
+
+  return publish(
+      *fields.state_pub, _new_robot_state, client_config.dds_compress_paths,
+      state_metrics);
+}
+
+bool Client::ClientImpl::send_compact_robot_state(
+    const messages::RobotState& _new_robot_state)
+{
+  // New names are announced before the first state that refers to them
+  messages::register_names(_new_robot_state, name_registry);
+  for (const auto& entry : name_registry.take_new_entries())
+    publish(*fields.name_registry_pub, entry, false, name_registry_metrics);
+
+  return publish(
+      *fields.compact_state_pub, _new_robot_state, false,
+      compact_state_metrics, name_registry);
 }
 
 bool Client::ClientImpl::read_mode_request
     (messages::ModeRequest& _mode_request)
 {
-  auto mode_requests = fields.mode_request_sub->read();
-  if (!mode_requests.empty())
+  dds_sample_info_t sample_info;
+  if (!take(
+      *fields.mode_request_sub, mode_request_metrics, _mode_request,
+      &sample_info) &&
+      !(fields.extended_mode_request_sub &&
+          take(
+              *fields.extended_mode_request_sub,
+              extended_mode_request_metrics, _mode_request, &sample_info)))
+    return false;
+
+  add_clock_offset_sample(sample_info);
+  stamp_received(_mode_request.trace);
+  return true;
+}
+
+bool Client::ClientImpl::wait_priority_mode_request(
+    messages::ModeRequest& _mode_request, double _timeout)
+{
+  if (!fields.priority_mode_request_sub || priority_waitset <= 0)
+    return false;
+
+  if (take_priority_mode_request(_mode_request))
+    return true;
+
+  dds_return_t return_code = dds_waitset_wait(
+      priority_waitset, NULL, 0,
+      static_cast<dds_duration_t>(DDS_SECS(std::max(_timeout, 0.0))));
+  if (return_code < 0)
   {
-    convert(*(mode_requests[0]), _mode_request);
+    DDS_FATAL("dds_waitset_wait: %s\n", dds_strretcode(-return_code));
+    return false;
+  }
+  return return_code > 0 && take_priority_mode_request(_mode_request);
+}
+
+bool Client::ClientImpl::take_priority_mode_request(
+    messages::ModeRequest& _mode_request)
+{
+  const dds_time_t receive_time = dds_time();
+  dds_sample_info_t sample_info;
+  if (!take(
+      *fields.priority_mode_request_sub, priority_mode_request_metrics,
+      _mode_request, &sample_info))
+    return false;
+
+  add_clock_offset_sample(sample_info);
+  priority_mode_request_delay->observe(
+      std::max<dds_time_t>(
+          receive_time - sample_info.source_timestamp, 0) / 1e9);
+  stamp_received(_mode_request.trace);
+
+  if (_mode_request.mode.mode == messages::RobotMode::MODE_PAUSED ||
+      _mode_request.mode.mode == messages::RobotMode::MODE_EMERGENCY)
+    last_stop_time = sample_info.source_timestamp;
+  return true;
+}
+
+bool Client::ClientImpl::is_stale(const dds_sample_info_t& _sample_info)
+{
+  if (_sample_info.source_timestamp >= last_stop_time)
+    return false;
+  stale_requests->increment();
+  return true;
+}
+
+template<typename Message>
+bool Client::ClientImpl::take_request(
+    TypedSubscriber<Message>& _subscriber,
+    TopicMetrics& _topic_metrics,
+    Message& _request)
+{
+  dds_sample_info_t sample_info;
+  while (take(_subscriber, _topic_metrics, _request, &sample_info))
+  {
+    add_clock_offset_sample(sample_info);
+    if (is_stale(sample_info))
+      continue;
+    stamp_received(_request.trace);
     return true;
   }
   return false;
@@ -63,25 +224,91 @@ bool Client::ClientImpl::read_mode_request
 bool Client::ClientImpl::read_path_request(
     messages::PathRequest& _path_request)
 {
-  auto path_requests = fields.path_request_sub->read();
-  if (!path_requests.empty())
-  {
-    convert(*(path_requests[0]), _path_request);
+  if (take_request(
+      *fields.path_request_sub, path_request_metrics, _path_request))
     return true;
-  }
+
+  if (fields.extended_path_request_sub &&
+      take_request(
+          *fields.extended_path_request_sub, extended_path_request_metrics,
+          _path_request))
+    return true;
+
+  if (fields.fleet_path_request_sub)
+    return read_fleet_path_request(_path_request);
   return false;
 }
 
+bool Client::ClientImpl::read_fleet_path_request(
+    messages::PathRequest& _path_request)
+{
+  // Every batch is taken, as any of them may hold an entry for this
+  // client's robot, and only the newest entry is kept
+  std::vector<messages::PathRequest> path_requests;
+  std::vector<dds_sample_info_t> sample_infos;
+  if (!take(
+      *fields.fleet_path_request_sub, fleet_path_request_metrics,
+      path_requests, &sample_infos, client_config.robot_name))
+    return false;
+
+  std::size_t newest = 0;
+  for (std::size_t i = 1; i < sample_infos.size(); ++i)
+  {
+    if (sample_infos[i].source_timestamp >=
+        sample_infos[newest].source_timestamp)
+      newest = i;
+  }
+  add_clock_offset_sample(sample_infos[newest]);
+  if (is_stale(sample_infos[newest]))
+    return false;
+  _path_request = std::move(path_requests[newest]);
+  stamp_received(_path_request.trace);
+  return true;
+}
+
 bool Client::ClientImpl::read_destination_request(
     messages::DestinationRequest& _destination_request)
 {
-  auto destination_requests = fields.destination_request_sub->read();
-  if (!destination_requests.empty())
-  {
-    convert(*(destination_requests[0]), _destination_request);
+  if (take_request(
+      *fields.destination_request_sub, destination_request_metrics,
+      _destination_request))
     return true;
-  }
-  return false;
+
+  return fields.extended_destination_request_sub &&
+      take_request(
+          *fields.extended_destination_request_sub,
+          extended_destination_request_metrics, _destination_request);
+}
+
+bool Client::ClientImpl::get_server_clock_offset(
+    int64_t& _offset_nanosec) const
+{
+  return server_clock_offset.get_offset(_offset_nanosec);
+}
+
+Tracer::SharedPtr Client::ClientImpl::get_tracer() const
+{
+  return tracer;
+}
+
+Metrics::SharedPtr Client::ClientImpl::get_metrics() const
+{
+  return metrics;
+}
+
+void Client::ClientImpl::stamp_received(messages::Trace& _trace)
+{
+  int64_t offset_nanosec;
+  if (server_clock_offset.get_offset(offset_nanosec))
+    tracer->stamp_received(_trace, "client_receive", offset_nanosec);
+  else
+    tracer->stamp_received(_trace, "client_receive");
+}
+
+void Client::ClientImpl::add_clock_offset_sample(
+    const dds_sample_info_t& _sample_info)
+{
+  server_clock_offset.add_sample(_sample_info.source_timestamp, dds_time());
 }
 
 } // namespace free_fleet
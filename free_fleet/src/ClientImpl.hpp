@@ -18,15 +18,23 @@
 #ifndef FREE_FLEET__SRC__CLIENTIMPL_HPP
 #define FREE_FLEET__SRC__CLIENTIMPL_HPP
 
+#include <atomic>
+
 #include <free_fleet/messages/RobotState.hpp>
 #include <free_fleet/messages/ModeRequest.hpp>
 #include <free_fleet/messages/PathRequest.hpp>
 #include <free_fleet/messages/DestinationRequest.hpp>
 #include <free_fleet/Client.hpp>
+#include <free_fleet/Tracer.hpp>
+#include <free_fleet/Metrics.hpp>
 #include <free_fleet/ClientConfig.hpp>
 
 #include <dds/dds.h>
 
+#include "NameRegistry.hpp"
+#include "TopicMetrics.hpp"
+#include "TypedTopics.hpp"
+#include "ClockOffsetEstimator.hpp"
 #include "messages/FleetMessages.h"
 #include "dds_utils/DDSPublishHandler.hpp"
 #include "dds_utils/DDSSubscribeHandler.hpp"
@@ -45,20 +53,48 @@ public:
 
     /// DDS publisher that handles sending out current robot states to the 
     /// server
-    dds::DDSPublishHandler<FreeFleetData_RobotState>::SharedPtr
-        state_pub;
+    TypedPublisher<messages::RobotState>::SharedPtr state_pub;
 
     /// DDS subscriber for mode requests coming from the server
-    dds::DDSSubscribeHandler<FreeFleetData_ModeRequest>::SharedPtr 
-        mode_request_sub;
+    TypedSubscriber<messages::ModeRequest>::SharedPtr mode_request_sub;
 
     /// DDS subscriber for path requests coming from the server
-    dds::DDSSubscribeHandler<FreeFleetData_PathRequest>::SharedPtr 
-        path_request_sub;
+    TypedSubscriber<messages::PathRequest>::SharedPtr path_request_sub;
 
     /// DDS subscriber for destination requests coming from the server
-    dds::DDSSubscribeHandler<FreeFleetData_DestinationRequest>::SharedPtr
+    TypedSubscriber<messages::DestinationRequest>::SharedPtr
         destination_request_sub;
+
+    /// DDS publishers of the compact robot states and the names they refer
+    /// to, only set instead of state_pub when compact states are configured
+    dds::DDSPublishHandler<FreeFleetData_CompactRobotState>::SharedPtr
+        compact_state_pub;
+
+    dds::DDSPublishHandler<FreeFleetData_NameRegistryEntry>::SharedPtr
+        name_registry_pub;
+
+    /// DDS subscriber for path requests batched for the whole fleet, only
+    /// set when fleet path requests are configured
+    dds::DDSSubscribeHandler<FreeFleetData_FleetPathRequest>::SharedPtr
+        fleet_path_request_sub;
+
+    /// DDS subscriber for the reliable mode requests that stop or resume the
+    /// robot, only set when priority mode requests are configured
+    TypedSubscriber<messages::ModeRequest>::SharedPtr
+        priority_mode_request_sub;
+
+    /// DDS subscribers for requests of their extended types, which carry
+    /// traces and compressed paths. Mode and destination requests are only
+    /// set when traced requests are configured, path requests when either
+    /// traced requests or compressed paths are.
+    TypedSubscriber<messages::ModeRequest>::SharedPtr
+        extended_mode_request_sub;
+
+    TypedSubscriber<messages::PathRequest>::SharedPtr
+        extended_path_request_sub;
+
+    TypedSubscriber<messages::DestinationRequest>::SharedPtr
+        extended_destination_request_sub;
   };
 
   ClientImpl(const ClientConfig& config);
@@ -71,15 +107,92 @@ public:
 
   bool read_mode_request(messages::ModeRequest& mode_request);
 
+  bool wait_priority_mode_request(
+      messages::ModeRequest& mode_request, double timeout);
+
   bool read_path_request(messages::PathRequest& path_request);
 
   bool read_destination_request(
       messages::DestinationRequest& destination_request);
 
+  bool get_server_clock_offset(int64_t& offset_nanosec) const;
+
+  Tracer::SharedPtr get_tracer() const;
+
+  Metrics::SharedPtr get_metrics() const;
+
 private:
 
   Fields fields;
 
+  Tracer::SharedPtr tracer;
+
+  Metrics::SharedPtr metrics;
+
+  TopicMetrics state_metrics;
+
+  TopicMetrics mode_request_metrics;
+
+  TopicMetrics extended_mode_request_metrics;
+
+  TopicMetrics path_request_metrics;
+
+  TopicMetrics extended_path_request_metrics;
+
+  TopicMetrics destination_request_metrics;
+
+  TopicMetrics extended_destination_request_metrics;
+
+  /// Takes the next path or destination request of a subscriber that was
+  /// not written before the last stop, and stamps its receipt.
+  template<typename Message>
+  bool take_request(
+      TypedSubscriber<Message>& subscriber,
+      TopicMetrics& topic_metrics,
+      Message& request);
+
+  TopicMetrics compact_state_metrics;
+
+  TopicMetrics name_registry_metrics;
+
+  TopicMetrics fleet_path_request_metrics;
+
+  bool read_fleet_path_request(messages::PathRequest& path_request);
+
+  TopicMetrics priority_mode_request_metrics;
+
+  Metrics::Histogram* priority_mode_request_delay;
+
+  /// Only created when priority mode requests are configured, woken up as
+  /// soon as the priority subscriber has a sample
+  dds_entity_t priority_waitset;
+
+  bool take_priority_mode_request(messages::ModeRequest& mode_request);
+
+  /// Source timestamp of the last stop taken from the priority topic. Path
+  /// and destination requests written before it are ignored, as they would
+  /// get the robot moving again once they arrive.
+  std::atomic<dds_time_t> last_stop_time;
+
+  Metrics::Counter* stale_requests;
+
+  bool is_stale(const dds_sample_info_t& sample_info);
+
+  /// Names of this client's robot, model and levels
+  NameRegistry name_registry;
+
+  bool send_compact_robot_state(const messages::RobotState& new_robot_state);
+
+  /// Fed with the source timestamps of every request received from the
+  /// server
+  ClockOffsetEstimator server_clock_offset;
+
+  void add_clock_offset_sample(const dds_sample_info_t& sample_info);
+
+  /// Stamps the receipt of a traced request, converting the hops stamped by
+  /// the server to the local clock with the estimated offset.
+  void stamp_received(messages::Trace& trace);
+
   ClientConfig client_config;
 
 };
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+
+#include "ClockOffsetEstimator.hpp"
+
+namespace free_fleet {
+
+ClockOffsetEstimator::ClockOffsetEstimator(std::size_t _window_size) :
+  window_size(std::max<std::size_t>(_window_size, 1))
+{}
+
+void ClockOffsetEstimator::add_sample(
+    int64_t _remote_send_nanosec, int64_t _local_receive_nanosec)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  deltas.push_back(_local_receive_nanosec - _remote_send_nanosec);
+  while (deltas.size() > window_size)
+    deltas.pop_front();
+}
+
+bool ClockOffsetEstimator::get_offset(int64_t& _offset_nanosec) const
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  if (deltas.empty())
+    return false;
+  _offset_nanosec = *std::min_element(deltas.begin(), deltas.end());
+  return true;
+}
+
+} // namespace free_fleet
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET__SRC__CLOCKOFFSETESTIMATOR_HPP
+#define FREE_FLEET__SRC__CLOCKOFFSETESTIMATOR_HPP
+
+#include <mutex>
+#include <deque>
+#include <cstdint>
+
+namespace free_fleet {
+
+/// Estimates the offset of the local clock from a remote clock, using pairs
+/// of remote send timestamps and local receive timestamps of the same
+/// messages. Each pair gives the offset plus the one way latency, so the
+/// minimum over a window of recent pairs is used as the estimate, which is
+/// biased by the smallest latency seen in that window.
+class ClockOffsetEstimator
+{
+public:
+
+  ClockOffsetEstimator(std::size_t window_size = 16);
+
+  /// Adds a new pair of timestamps, both in nanoseconds since epoch.
+  void add_sample(int64_t remote_send_nanosec, int64_t local_receive_nanosec);
+
+  /// Gets the current estimate, such that local time = remote time + offset.
+  ///
+  /// \param[out] offset_nanosec
+  ///   Estimated offset in nanoseconds.
+  /// \return
+  ///   True if there is an estimate, false if no samples were added yet.
+  bool get_offset(int64_t& offset_nanosec) const;
+
+private:
+
+  mutable std::mutex mutex;
+
+  std::size_t window_size;
+
+  std::deque<int64_t> deltas;
+
+};
+
+} // namespace free_fleet
+
+#endif // FREE_FLEET__SRC__CLOCKOFFSETESTIMATOR_HPP
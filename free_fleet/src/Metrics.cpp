@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cstdio>
+#include <thread>
+#include <algorithm>
+
+#include <free_fleet/Metrics.hpp>
+
+namespace free_fleet {
+
+namespace {
+
+std::size_t get_thread_shard_index(std::size_t _shard_num)
+{
+  static std::atomic<std::size_t> next_index(0);
+  thread_local const std::size_t index = next_index++;
+  return index % _shard_num;
+}
+
+void atomic_add(std::atomic<double>& _target, double _value)
+{
+  double current = _target.load(std::memory_order_relaxed);
+  while (!_target.compare_exchange_weak(
+      current, current + _value, std::memory_order_relaxed))
+  {}
+}
+
+std::string to_label_text(const Metrics::Labels& _labels)
+{
+  std::string text;
+  for (const auto& label : _labels)
+  {
+    if (!text.empty())
+      text += ",";
+    text += label.first + "=\"";
+    for (const char c : label.second)
+    {
+      if (c == '\\')
+        text += "\\\\";
+      else if (c == '"')
+        text += "\\\"";
+      else if (c == '\n')
+        text += "\\n";
+      else
+        text += c;
+    }
+    text += "\"";
+  }
+  return text;
+}
+
+std::string to_value_text(double _value)
+{
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.9g", _value);
+  return buffer;
+}
+
+std::string to_series_text(
+    const std::string& _name,
+    const std::string& _label_text,
+    const std::string& _value_text)
+{
+  if (_label_text.empty())
+    return _name + " " + _value_text + "\n";
+  return _name + "{" + _label_text + "} " + _value_text + "\n";
+}
+
+} // namespace
+
+const std::vector<double> Metrics::LatencyBuckets = {
+    0.00001, 0.00005, 0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1.0,
+    5.0};
+
+Metrics::Counter::Counter() :
+  value(0)
+{}
+
+void Metrics::Counter::increment(uint64_t _value)
+{
+  value.fetch_add(_value, std::memory_order_relaxed);
+}
+
+uint64_t Metrics::Counter::get() const
+{
+  return value.load(std::memory_order_relaxed);
+}
+
+Metrics::Gauge::Gauge() :
+  value(0.0)
+{}
+
+void Metrics::Gauge::set(double _value)
+{
+  value.store(_value, std::memory_order_relaxed);
+}
+
+void Metrics::Gauge::add(double _value)
+{
+  atomic_add(value, _value);
+}
+
+double Metrics::Gauge::get() const
+{
+  return value.load(std::memory_order_relaxed);
+}
+
+Metrics::Histogram::Histogram(const std::vector<double>& _upper_bounds) :
+  upper_bounds(_upper_bounds),
+  shards(new Shard[ShardNum])
+{
+  std::sort(upper_bounds.begin(), upper_bounds.end());
+  for (std::size_t i = 0; i < ShardNum; ++i)
+  {
+    shards[i].counts.reset(
+        new std::atomic<uint64_t>[upper_bounds.size() + 1]);
+    for (std::size_t j = 0; j <= upper_bounds.size(); ++j)
+      shards[i].counts[j].store(0);
+    shards[i].sum.store(0.0);
+  }
+}
+
+void Metrics::Histogram::observe(double _value)
+{
+  const std::size_t bucket = static_cast<std::size_t>(
+      std::lower_bound(upper_bounds.begin(), upper_bounds.end(), _value) -
+      upper_bounds.begin());
+
+  Shard& shard = shards[get_thread_shard_index(ShardNum)];
+  shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+  atomic_add(shard.sum, _value);
+}
+
+Metrics::Histogram::Snapshot Metrics::Histogram::get_snapshot() const
+{
+  Snapshot snapshot;
+  snapshot.upper_bounds = upper_bounds;
+  snapshot.cumulative_counts.assign(upper_bounds.size() + 1, 0);
+  snapshot.sum = 0.0;
+  for (std::size_t i = 0; i < ShardNum; ++i)
+  {
+    for (std::size_t j = 0; j <= upper_bounds.size(); ++j)
+      snapshot.cumulative_counts[j] +=
+          shards[i].counts[j].load(std::memory_order_relaxed);
+    snapshot.sum += shards[i].sum.load(std::memory_order_relaxed);
+  }
+  for (std::size_t j = 1; j < snapshot.cumulative_counts.size(); ++j)
+    snapshot.cumulative_counts[j] += snapshot.cumulative_counts[j - 1];
+  return snapshot;
+}
+
+Metrics::SharedPtr Metrics::make()
+{
+  return SharedPtr(new Metrics());
+}
+
+Metrics::Metrics()
+{}
+
+Metrics::Family& Metrics::get_family(
+    const std::string& _name,
+    const std::string& _type,
+    const std::string& _help)
+{
+  Family& family = families[_name];
+  if (family.type.empty())
+  {
+    family.type = _type;
+    family.help = _help;
+  }
+  return family;
+}
+
+Metrics::Counter& Metrics::counter(
+    const std::string& _name,
+    const std::string& _help,
+    const Labels& _labels)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  auto& series = get_family(_name, "counter", _help).counters;
+  auto& counter = series[to_label_text(_labels)];
+  if (!counter)
+    counter.reset(new Counter());
+  return *counter;
+}
+
+Metrics::Gauge& Metrics::gauge(
+    const std::string& _name,
+    const std::string& _help,
+    const Labels& _labels)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  auto& series = get_family(_name, "gauge", _help).gauges;
+  auto& gauge = series[to_label_text(_labels)];
+  if (!gauge)
+    gauge.reset(new Gauge());
+  return *gauge;
+}
+
+Metrics::Histogram& Metrics::histogram(
+    const std::string& _name,
+    const std::string& _help,
+    const Labels& _labels,
+    const std::vector<double>& _upper_bounds)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  auto& series = get_family(_name, "histogram", _help).histograms;
+  auto& histogram = series[to_label_text(_labels)];
+  if (!histogram)
+    histogram.reset(new Histogram(_upper_bounds));
+  return *histogram;
+}
+
+std::string Metrics::to_prometheus_text() const
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  std::string text;
+  for (const auto& it : families)
+  {
+    const std::string& name = it.first;
+    const Family& family = it.second;
+    text += "# HELP " + name + " " + family.help + "\n";
+    text += "# TYPE " + name + " " + family.type + "\n";
+
+    for (const auto& series : family.counters)
+      text += to_series_text(
+          name, series.first, std::to_string(series.second->get()));
+
+    for (const auto& series : family.gauges)
+      text += to_series_text(
+          name, series.first, to_value_text(series.second->get()));
+
+    for (const auto& series : family.histograms)
+    {
+      const Histogram::Snapshot snapshot = series.second->get_snapshot();
+      const std::string separator = series.first.empty() ? "" : ",";
+      for (std::size_t i = 0; i < snapshot.cumulative_counts.size(); ++i)
+      {
+        const std::string upper_bound =
+            i < snapshot.upper_bounds.size() ?
+                to_value_text(snapshot.upper_bounds[i]) : "+Inf";
+        text += to_series_text(
+            name + "_bucket",
+            series.first + separator + "le=\"" + upper_bound + "\"",
+            std::to_string(snapshot.cumulative_counts[i]));
+      }
+      text += to_series_text(
+          name + "_sum", series.first, to_value_text(snapshot.sum));
+      text += to_series_text(
+          name + "_count", series.first,
+          std::to_string(snapshot.cumulative_counts.back()));
+    }
+  }
+  return text;
+}
+
+bool Metrics::write_to_file(const std::string& _path) const
+{
+  const std::string text = to_prometheus_text();
+  const std::string tmp_path = _path + ".tmp";
+
+  FILE* file = fopen(tmp_path.c_str(), "w");
+  if (!file)
+    return false;
+  const bool written =
+      fwrite(text.data(), 1, text.size(), file) == text.size();
+  if (fclose(file) != 0 || !written)
+    return false;
+  return rename(tmp_path.c_str(), _path.c_str()) == 0;
+}
+
+} // namespace free_fleet
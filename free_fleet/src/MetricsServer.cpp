@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <free_fleet/MetricsServer.hpp>
+
+namespace free_fleet {
+
+MetricsServer::SharedPtr MetricsServer::make(
+    Metrics::SharedPtr _metrics, int _port, const std::string& _address)
+{
+  if (!_metrics)
+    return nullptr;
+
+  int socket_fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (socket_fd < 0)
+  {
+    fprintf(stderr, "metrics server: socket: %s\n", strerror(errno));
+    return nullptr;
+  }
+
+  int reuse = 1;
+  setsockopt(socket_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(static_cast<uint16_t>(_port));
+  if (inet_pton(AF_INET, _address.c_str(), &address.sin_addr) != 1 ||
+      bind(socket_fd, reinterpret_cast<sockaddr*>(&address),
+          sizeof(address)) < 0 ||
+      listen(socket_fd, 8) < 0)
+  {
+    fprintf(stderr, "metrics server: unable to listen on %s:%d: %s\n",
+        _address.c_str(), _port, strerror(errno));
+    close(socket_fd);
+    return nullptr;
+  }
+
+  return SharedPtr(new MetricsServer(std::move(_metrics), socket_fd));
+}
+
+MetricsServer::MetricsServer(Metrics::SharedPtr _metrics, int _socket_fd) :
+  metrics(std::move(_metrics)),
+  socket_fd(_socket_fd),
+  running(true)
+{
+  serve_thread = std::thread(&MetricsServer::serve_thread_fn, this);
+}
+
+MetricsServer::~MetricsServer()
+{
+  running = false;
+  if (serve_thread.joinable())
+    serve_thread.join();
+  close(socket_fd);
+}
+
+void MetricsServer::serve_thread_fn()
+{
+  while (running)
+  {
+    // Wakes up regularly to check if the server is being stopped
+    pollfd poll_fd;
+    poll_fd.fd = socket_fd;
+    poll_fd.events = POLLIN;
+    if (poll(&poll_fd, 1, 200) <= 0)
+      continue;
+
+    int connection_fd = accept(socket_fd, nullptr, nullptr);
+    if (connection_fd < 0)
+      continue;
+    respond(connection_fd);
+    close(connection_fd);
+  }
+}
+
+void MetricsServer::respond(int _connection_fd)
+{
+  // Scrapers are not expected to misbehave, but they should never be able to
+  // stall the serving thread either
+  timeval timeout;
+  timeout.tv_sec = 1;
+  timeout.tv_usec = 0;
+  setsockopt(
+      _connection_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(
+      _connection_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+  // The request itself does not matter, it only needs to be read until the
+  // end of its headers
+  std::string request;
+  char buffer[1024];
+  while (request.find("\r\n\r\n") == std::string::npos &&
+      request.size() < 16384)
+  {
+    const ssize_t received = recv(_connection_fd, buffer, sizeof(buffer), 0);
+    if (received <= 0)
+      return;
+    request.append(buffer, static_cast<std::size_t>(received));
+  }
+
+  const std::string body = metrics->to_prometheus_text();
+  const std::string response =
+      "HTTP/1.0 200 OK\r\n"
+      "Content-Type: text/plain; version=0.0.4\r\n"
+      "Content-Length: " + std::to_string(body.size()) + "\r\n"
+      "Connection: close\r\n"
+      "\r\n" + body;
+
+  std::size_t sent_total = 0;
+  while (sent_total < response.size())
+  {
+    const ssize_t sent = send(
+        _connection_fd, response.data() + sent_total,
+        response.size() - sent_total, MSG_NOSIGNAL);
+    if (sent <= 0)
+      return;
+    sent_total += static_cast<std::size_t>(sent);
+  }
+}
+
+} // namespace free_fleet
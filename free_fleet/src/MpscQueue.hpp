@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#ifndef FREE_FLEET__SRC__MPSCQUEUE_HPP
+#define FREE_FLEET__SRC__MPSCQUEUE_HPP
+
+#include <atomic>
+#include <utility>
+
+namespace free_fleet {
+
+/// Unbounded multiple producer, single consumer queue. Pushing never takes a
+/// lock, it only swaps the head of a linked list of nodes, so producers never
+/// wait on each other nor on the consumer.
+///
+/// The consumer always owns one node, whose value was already popped. A push
+/// that has swapped the head but not yet linked its node makes the queue
+/// look non empty while nothing can be popped yet, consumers are expected to
+/// try again in that case.
+template<typename T>
+class MpscQueue
+{
+public:
+
+  MpscQueue() :
+    head(new Node),
+    tail(head.load(std::memory_order_relaxed))
+  {}
+
+  MpscQueue(const MpscQueue&) = delete;
+
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  ~MpscQueue()
+  {
+    while (tail)
+    {
+      Node* next = tail->next.load(std::memory_order_relaxed);
+      delete tail;
+      tail = next;
+    }
+  }
+
+  /// Pushes a value, may be called from any thread.
+  void push(T _value)
+  {
+    Node* node = new Node;
+    node->value = std::move(_value);
+    Node* previous = head.exchange(node, std::memory_order_seq_cst);
+    previous->next.store(node, std::memory_order_release);
+  }
+
+  /// Pops the oldest value, only called from the consumer thread.
+  ///
+  /// \return
+  ///   False if no value could be popped.
+  bool pop(T& _value_out)
+  {
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (!next)
+      return false;
+
+    _value_out = std::move(next->value);
+    next->value = T();
+    delete tail;
+    tail = next;
+    return true;
+  }
+
+  /// Checks if every pushed value was popped, only called from the consumer
+  /// thread.
+  bool empty() const
+  {
+    return head.load(std::memory_order_seq_cst) == tail;
+  }
+
+private:
+
+  struct Node
+  {
+    std::atomic<Node*> next{nullptr};
+
+    T value;
+  };
+
+  /// Last pushed node, swapped by the producers
+  std::atomic<Node*> head;
+
+  /// Node owned by the consumer, followed by the oldest value
+  Node* tail;
+
+};
+
+} // namespace free_fleet
+
+#endif // FREE_FLEET__SRC__MPSCQUEUE_HPP
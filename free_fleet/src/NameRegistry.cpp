@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "NameRegistry.hpp"
+
+namespace free_fleet {
+
+uint32_t NameRegistry::make_id(Kind _kind, const std::string& _name)
+{
+  if (_name.empty())
+    return 0;
+
+  // 32 bit FNV-1a, seeded with the kind so that a robot and a level sharing
+  // a name still get different IDs
+  uint32_t hash = 2166136261u ^ static_cast<uint32_t>(_kind);
+  for (const char c : _name)
+  {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619u;
+  }
+  return hash == 0 ? 1 : hash;
+}
+
+uint64_t NameRegistry::make_key(Kind _kind, uint32_t _id)
+{
+  return (static_cast<uint64_t>(_kind) << 32) | _id;
+}
+
+uint32_t NameRegistry::register_name(Kind _kind, const std::string& _name)
+{
+  const uint32_t id = make_id(_kind, _name);
+  if (id == 0)
+    return id;
+
+  std::unique_lock<std::mutex> lock(mutex);
+  if (names.emplace(make_key(_kind, id), _name).second)
+    new_entries.push_back(Entry{_kind, id, _name});
+  return id;
+}
+
+bool NameRegistry::add_entry(const Entry& _entry)
+{
+  if (_entry.id == 0)
+    return true;
+
+  std::unique_lock<std::mutex> lock(mutex);
+  auto inserted = names.emplace(make_key(_entry.kind, _entry.id), _entry.name);
+  return inserted.second || inserted.first->second == _entry.name;
+}
+
+bool NameRegistry::get_name(
+    Kind _kind, uint32_t _id, std::string& _name) const
+{
+  if (_id == 0)
+  {
+    _name.clear();
+    return true;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  auto it = names.find(make_key(_kind, _id));
+  if (it == names.end())
+    return false;
+  _name = it->second;
+  return true;
+}
+
+std::vector<NameRegistry::Entry> NameRegistry::take_new_entries()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  std::vector<Entry> entries;
+  entries.swap(new_entries);
+  return entries;
+}
+
+} // namespace free_fleet
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET__SRC__NAMEREGISTRY_HPP
+#define FREE_FLEET__SRC__NAMEREGISTRY_HPP
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+namespace free_fleet {
+
+/// Maps the names of robots, models and levels to the numeric IDs used by
+/// the compact robot state. IDs are hashes of the names, so that clients
+/// never have to wait for an ID to be assigned, and each client announces
+/// the names it uses once so that the server can map the IDs back.
+class NameRegistry
+{
+public:
+
+  /// Matches FreeFleetData_NameKind_Constants
+  enum class Kind : uint32_t
+  {
+    Robot = 0,
+    Model = 1,
+    Level = 2
+  };
+
+  struct Entry
+  {
+    Kind kind;
+    uint32_t id;
+    std::string name;
+  };
+
+  /// Gets the ID of a name, the same in every process. Empty names always
+  /// map to 0, which is never registered.
+  static uint32_t make_id(Kind kind, const std::string& name);
+
+  /// Gets the ID of a local name, registering it first if it is new.
+  uint32_t register_name(Kind kind, const std::string& name);
+
+  /// Adds an entry announced by a remote registry.
+  ///
+  /// \return
+  ///   False if the ID already maps to another name, in which case the
+  ///   existing entry is kept.
+  bool add_entry(const Entry& entry);
+
+  /// Gets the name an ID maps to.
+  ///
+  /// \return
+  ///   True if the ID is 0 or known, false otherwise.
+  bool get_name(Kind kind, uint32_t id, std::string& name) const;
+
+  /// Takes the entries registered locally since the last call, which still
+  /// need to be announced.
+  std::vector<Entry> take_new_entries();
+
+private:
+
+  static uint64_t make_key(Kind kind, uint32_t id);
+
+  mutable std::mutex mutex;
+
+  std::unordered_map<uint64_t, std::string> names;
+
+  std::vector<Entry> new_entries;
+
+};
+
+} // namespace free_fleet
+
+#endif // FREE_FLEET__SRC__NAMEREGISTRY_HPP
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "RequestTracker.hpp"
+
+namespace free_fleet {
+
+RequestTracker::RequestTracker(
+    Clock::duration _timeout, uint32_t _max_retransmissions) :
+  timeout(_timeout),
+  max_retransmissions(_max_retransmissions)
+{}
+
+bool RequestTracker::is_redundant(
+    const std::string& _robot_name, const std::string& _task_id) const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  auto pending_it = pending_requests.find(_robot_name);
+  if (pending_it != pending_requests.end() &&
+      pending_it->second.task_id == _task_id)
+    return true;
+
+  auto echoed_it = echoed_task_ids.find(_robot_name);
+  return echoed_it != echoed_task_ids.end() && echoed_it->second == _task_id;
+}
+
+void RequestTracker::add(
+    const std::string& _robot_name,
+    const std::string& _task_id,
+    Resend _resend,
+    Clock::time_point _now,
+    std::vector<Report>& _reports)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  auto inserted = pending_requests.insert({_robot_name, Pending()});
+  Pending& pending = inserted.first->second;
+  if (!inserted.second)
+  {
+    _reports.push_back(
+        make_report(Report::Status::Superseded, _robot_name, pending, _now));
+  }
+
+  pending.task_id = _task_id;
+  pending.resend = std::move(_resend);
+  pending.first_send_time = _now;
+  pending.deadline = _now + timeout;
+  pending.retransmissions = 0;
+}
+
+void RequestTracker::acknowledge(
+    const std::string& _robot_name,
+    const std::string& _task_id,
+    Clock::time_point _now,
+    std::vector<Report>& _reports)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  std::string& echoed_task_id = echoed_task_ids[_robot_name];
+  if (echoed_task_id != _task_id)
+    echoed_task_id = _task_id;
+
+  auto it = pending_requests.find(_robot_name);
+  if (it == pending_requests.end() || it->second.task_id != _task_id)
+    return;
+
+  _reports.push_back(
+      make_report(Report::Status::Delivered, _robot_name, it->second, _now));
+  pending_requests.erase(it);
+}
+
+void RequestTracker::cancel(
+    const std::string& _robot_name,
+    Clock::time_point _now,
+    std::vector<Report>& _reports)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = pending_requests.find(_robot_name);
+  if (it == pending_requests.end())
+    return;
+
+  _reports.push_back(
+      make_report(Report::Status::Superseded, _robot_name, it->second, _now));
+  pending_requests.erase(it);
+}
+
+void RequestTracker::update(
+    Clock::time_point _now,
+    std::vector<Resend>& _resends,
+    std::vector<Report>& _reports)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto it = pending_requests.begin(); it != pending_requests.end();)
+  {
+    Pending& pending = it->second;
+    if (_now < pending.deadline)
+    {
+      ++it;
+      continue;
+    }
+
+    if (pending.retransmissions >= max_retransmissions)
+    {
+      _reports.push_back(
+          make_report(Report::Status::TimedOut, it->first, pending, _now));
+      it = pending_requests.erase(it);
+      continue;
+    }
+
+    ++pending.retransmissions;
+    pending.deadline = _now + timeout;
+    _resends.push_back(pending.resend);
+    ++it;
+  }
+}
+
+std::size_t RequestTracker::get_pending_num() const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  return pending_requests.size();
+}
+
+RequestTracker::Report RequestTracker::make_report(
+    Report::Status _status,
+    const std::string& _robot_name,
+    const Pending& _pending,
+    Clock::time_point _now) const
+{
+  Report report;
+  report.status = _status;
+  report.robot_name = _robot_name;
+  report.task_id = _pending.task_id;
+  report.retransmissions = _pending.retransmissions;
+  report.latency_nanosec =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          _now - _pending.first_send_time).count();
+  return report;
+}
+
+} // namespace free_fleet
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET__SRC__REQUESTTRACKER_HPP
+#define FREE_FLEET__SRC__REQUESTTRACKER_HPP
+
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include <free_fleet/Server.hpp>
+
+namespace free_fleet {
+
+/// Tracks the latest request sent to each robot until the robot echoes its
+/// task ID in a robot state, which clients do once they accept a request.
+/// Requests that are not acknowledged in time are sent again, a bounded
+/// number of times.
+///
+/// Nothing is sent from within the tracker, the requests due to be sent
+/// again are handed back to the caller instead, so that no lock is held
+/// while writing.
+class RequestTracker
+{
+public:
+
+  using Clock = std::chrono::steady_clock;
+  using Resend = std::function<bool()>;
+  using Report = Server::DeliveryReport;
+
+  RequestTracker(Clock::duration timeout, uint32_t max_retransmissions);
+
+  /// Checks if sending a request would be redundant, as the robot already
+  /// echoes its task ID or a request for the same task is already pending.
+  bool is_redundant(
+      const std::string& robot_name, const std::string& task_id) const;
+
+  /// Starts tracking a request that was just sent, superseding the request
+  /// pending for the same robot if any.
+  ///
+  /// \param[in] resend
+  ///   Sends the request again.
+  /// \param[out] reports
+  ///   Outcome of the superseded request, if any, is appended.
+  void add(
+      const std::string& robot_name,
+      const std::string& task_id,
+      Resend resend,
+      Clock::time_point now,
+      std::vector<Report>& reports);
+
+  /// Acknowledges the request pending for a robot if the task ID echoed in
+  /// its state matches.
+  ///
+  /// \param[out] reports
+  ///   Outcome of the acknowledged request, if any, is appended.
+  void acknowledge(
+      const std::string& robot_name,
+      const std::string& task_id,
+      Clock::time_point now,
+      std::vector<Report>& reports);
+
+  /// Stops tracking the request pending for a robot, if any, so that it is
+  /// not sent again.
+  ///
+  /// \param[out] reports
+  ///   Outcome of the cancelled request, if any, is appended as superseded.
+  void cancel(
+      const std::string& robot_name,
+      Clock::time_point now,
+      std::vector<Report>& reports);
+
+  /// Finds the requests that timed out, to be sent again or given up on.
+  ///
+  /// \param[out] resends
+  ///   Requests to be sent again are appended.
+  /// \param[out] reports
+  ///   Outcomes of the requests given up on are appended.
+  void update(
+      Clock::time_point now,
+      std::vector<Resend>& resends,
+      std::vector<Report>& reports);
+
+  std::size_t get_pending_num() const;
+
+private:
+
+  struct Pending
+  {
+    std::string task_id;
+    Resend resend;
+    Clock::time_point first_send_time;
+    Clock::time_point deadline;
+    uint32_t retransmissions;
+  };
+
+  Report make_report(
+      Report::Status status,
+      const std::string& robot_name,
+      const Pending& pending,
+      Clock::time_point now) const;
+
+  mutable std::mutex mutex;
+
+  Clock::duration timeout;
+
+  uint32_t max_retransmissions;
+
+  std::unordered_map<std::string, Pending> pending_requests;
+
+  /// Latest task ID echoed by each robot
+  std::unordered_map<std::string, std::string> echoed_task_ids;
+
+};
+
+} // namespace free_fleet
+
+#endif // FREE_FLEET__SRC__REQUESTTRACKER_HPP
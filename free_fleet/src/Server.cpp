@@ -20,8 +20,10 @@
 #include <free_fleet/Server.hpp>
 
 #include "ServerImpl.hpp"
+#include "TypedTopics.hpp"
 
 #include "messages/FleetMessages.h"
+#include "dds_utils/common.hpp"
 #include "dds_utils/DDSPublishHandler.hpp"
 #include "dds_utils/DDSSubscribeHandler.hpp"
 
@@ -31,49 +33,137 @@ Server::SharedPtr Server::make(const ServerConfig& _config)
 {
   SharedPtr server = SharedPtr(new Server(_config));
 
-  dds_entity_t participant = dds_create_participant(
-      static_cast<dds_domainid_t>(_config.dds_domain), NULL, NULL);
-  if (participant < 0)
+  auto make_domain = [&_config](int _domain, ServerImpl::DomainFields& _fields)
   {
-    DDS_FATAL("dds_create_participant: %s\n", dds_strretcode(-participant));
-    return nullptr;
+    _fields.participant = common::create_participant(
+        _domain, _config.dds_shared_memory);
+    if (_fields.participant < 0)
+    {
+      DDS_FATAL("dds_create_participant: %s\n",
+          dds_strretcode(-_fields.participant));
+      return false;
+    }
+
+    _fields.robot_state_sub =
+        make_subscriber<messages::RobotState, 10>(
+            _fields.participant,
+            messages::MessageTraits<messages::RobotState>::topic(_config));
+
+    // Clients that compress their paths publish their states on a separate
+    // topic of the extended type, peers that do not know it are unaffected
+    if (_config.dds_compress_paths)
+    {
+      _fields.extended_robot_state_sub =
+          make_subscriber<messages::RobotState, 10>(
+              _fields.participant,
+              messages::MessageTraits<messages::RobotState>::extended_topic(
+                  _config),
+              dds::Qos::BestEffort, true);
+    }
+
+    // Requests are written on a separate topic of their extended type when
+    // they carry a trace or a compressed path
+    using ModeRequestTraits = messages::MessageTraits<messages::ModeRequest>;
+    _fields.mode_request_pub =
+        make_publisher<messages::ModeRequest>(
+            _fields.participant,
+            _config.dds_trace_requests ?
+                ModeRequestTraits::extended_topic(_config) :
+                ModeRequestTraits::topic(_config),
+            dds::Qos::BestEffort, _config.dds_trace_requests);
+
+    using PathRequestTraits = messages::MessageTraits<messages::PathRequest>;
+    const bool extended_path_request =
+        _config.dds_compress_paths || _config.dds_trace_requests;
+    _fields.path_request_pub =
+        make_publisher<messages::PathRequest>(
+            _fields.participant,
+            extended_path_request ?
+                PathRequestTraits::extended_topic(_config) :
+                PathRequestTraits::topic(_config),
+            dds::Qos::BestEffort, extended_path_request);
+
+    using DestinationRequestTraits =
+        messages::MessageTraits<messages::DestinationRequest>;
+    _fields.destination_request_pub =
+        make_publisher<messages::DestinationRequest>(
+            _fields.participant,
+            _config.dds_trace_requests ?
+                DestinationRequestTraits::extended_topic(_config) :
+                DestinationRequestTraits::topic(_config),
+            dds::Qos::BestEffort, _config.dds_trace_requests);
+
+    if (_config.dds_compact_robot_state)
+    {
+      _fields.compact_robot_state_sub =
+          make_sample_subscriber<FreeFleetData_CompactRobotState, 10>(
+              _fields.participant,
+              messages::MessageTraits<FreeFleetData_CompactRobotState>::topic(
+                  _config));
+      _fields.name_registry_sub =
+          make_sample_subscriber<FreeFleetData_NameRegistryEntry, 10>(
+              _fields.participant,
+              messages::MessageTraits<FreeFleetData_NameRegistryEntry>::topic(
+                  _config),
+              dds::Qos::Durable);
+    }
+
+    if (_config.dds_priority_mode_request)
+    {
+      _fields.priority_mode_request_pub =
+          make_publisher<messages::ModeRequest>(
+              _fields.participant, _config.dds_priority_mode_request_topic,
+              dds::Qos::Reliable, true);
+    }
+
+    if (_config.dds_fleet_path_request)
+    {
+      _fields.fleet_path_request_pub =
+          make_sample_publisher<FreeFleetData_FleetPathRequest>(
+              _fields.participant,
+              messages::MessageTraits<FreeFleetData_FleetPathRequest>::topic(
+                  _config),
+              dds::Qos::Reliable);
+    }
+
+    return _fields.robot_state_sub->is_ready() &&
+        (!_fields.extended_robot_state_sub ||
+            _fields.extended_robot_state_sub->is_ready()) &&
+        (!_fields.compact_robot_state_sub ||
+            _fields.compact_robot_state_sub->is_ready()) &&
+        (!_fields.name_registry_sub ||
+            _fields.name_registry_sub->is_ready()) &&
+        (!_fields.priority_mode_request_pub ||
+            _fields.priority_mode_request_pub->is_ready()) &&
+        (!_fields.fleet_path_request_pub ||
+            _fields.fleet_path_request_pub->is_ready()) &&
+        _fields.mode_request_pub->is_ready() &&
+        _fields.path_request_pub->is_ready() &&
+        _fields.destination_request_pub->is_ready();
+  };
+
+  std::vector<int> domains{_config.dds_domain};
+  domains.insert(
+      domains.end(),
+      _config.dds_extra_domains.begin(),
+      _config.dds_extra_domains.end());
+
+  ServerImpl::Fields fields;
+  for (int domain : domains)
+  {
+    fields.domains.emplace_back();
+    if (!make_domain(domain, fields.domains.back()))
+    {
+      for (const auto& domain_fields : fields.domains)
+      {
+        if (domain_fields.participant > 0)
+          common::delete_participant(domain_fields.participant);
+      }
+      return nullptr;
+    }
   }
 
-  dds::DDSSubscribeHandler<FreeFleetData_RobotState, 10>::SharedPtr state_sub(
-      new dds::DDSSubscribeHandler<FreeFleetData_RobotState, 10>(
-          participant, &FreeFleetData_RobotState_desc,
-          _config.dds_robot_state_topic));
-
-  dds::DDSPublishHandler<FreeFleetData_ModeRequest>::SharedPtr 
-      mode_request_pub(
-          new dds::DDSPublishHandler<FreeFleetData_ModeRequest>(
-              participant, &FreeFleetData_ModeRequest_desc,
-              _config.dds_mode_request_topic));
-
-  dds::DDSPublishHandler<FreeFleetData_PathRequest>::SharedPtr 
-      path_request_pub(
-          new dds::DDSPublishHandler<FreeFleetData_PathRequest>(
-              participant, &FreeFleetData_PathRequest_desc,
-              _config.dds_path_request_topic));
-
-  dds::DDSPublishHandler<FreeFleetData_DestinationRequest>::SharedPtr 
-      destination_request_pub(
-          new dds::DDSPublishHandler<FreeFleetData_DestinationRequest>(
-              participant, &FreeFleetData_DestinationRequest_desc,
-              _config.dds_destination_request_topic));
-
-  if (!state_sub->is_ready() ||
-      !mode_request_pub->is_ready() ||
-      !path_request_pub->is_ready() ||
-      !destination_request_pub->is_ready())
-    return nullptr;
-
-  server->impl->start(ServerImpl::Fields{
-      std::move(participant),
-      std::move(state_sub),
-      std::move(mode_request_pub),
-      std::move(path_request_pub),
-      std::move(destination_request_pub)});
+  server->impl->start(std::move(fields));
   return server;
 }
 
@@ -91,6 +181,26 @@ bool Server::read_robot_states(
   return impl->read_robot_states(_new_robot_states);
 }
 
+void Server::RobotStateBatch::clear()
+{
+  data.clear();
+  samples.clear();
+  robot_states.clear();
+}
+
+bool Server::take_robot_states(
+    const ShardFn& _get_shard, std::vector<RobotStateBatch>& _batches)
+{
+  return impl->take_robot_states(_get_shard, _batches);
+}
+
+void Server::deserialize_robot_states(
+    RobotStateBatch& _batch,
+    std::vector<messages::RobotState>& _new_robot_states)
+{
+  impl->deserialize_robot_states(_batch, _new_robot_states);
+}
+
 bool Server::send_mode_request(const messages::ModeRequest& _mode_request)
 {
   return impl->send_mode_request(_mode_request);
@@ -107,4 +217,63 @@ bool Server::send_destination_request(
   return impl->send_destination_request(_destination_request);
 }
 
+bool Server::send_batch(
+    const std::vector<messages::PathRequest>& _path_requests)
+{
+  return impl->send_batch(_path_requests);
+}
+
+std::future<bool> Server::send_mode_request_async(
+    const messages::ModeRequest& _mode_request)
+{
+  return impl->send_mode_request_async(_mode_request);
+}
+
+void Server::send_mode_request_async(
+    const messages::ModeRequest& _mode_request, SendCallback _callback)
+{
+  impl->send_mode_request_async(_mode_request, std::move(_callback));
+}
+
+std::future<bool> Server::send_path_request_async(
+    const messages::PathRequest& _path_request)
+{
+  return impl->send_path_request_async(_path_request);
+}
+
+void Server::send_path_request_async(
+    const messages::PathRequest& _path_request, SendCallback _callback)
+{
+  impl->send_path_request_async(_path_request, std::move(_callback));
+}
+
+std::future<bool> Server::send_destination_request_async(
+    const messages::DestinationRequest& _destination_request)
+{
+  return impl->send_destination_request_async(_destination_request);
+}
+
+void Server::send_destination_request_async(
+    const messages::DestinationRequest& _destination_request,
+    SendCallback _callback)
+{
+  impl->send_destination_request_async(
+      _destination_request, std::move(_callback));
+}
+
+void Server::set_delivery_callback(DeliveryCallback _callback)
+{
+  impl->set_delivery_callback(std::move(_callback));
+}
+
+Tracer::SharedPtr Server::get_tracer() const
+{
+  return impl->get_tracer();
+}
+
+Metrics::SharedPtr Server::get_metrics() const
+{
+  return impl->get_metrics();
+}
+
 } // namespace free_fleet
@@ -15,76 +15,875 @@
  *
  */
 
+#include <map>
+#include <chrono>
+#include <iterator>
+#include <algorithm>
+
 #include "ServerImpl.hpp"
+#include "TypedTopics.hpp"
+#include "dds_utils/common.hpp"
+#include "messages/CdrCodec.hpp"
 #include "messages/message_utils.hpp"
 
 namespace free_fleet {
 
+namespace {
+
+/// Modes that stop robots
+bool is_stop_mode(const messages::RobotMode& _mode)
+{
+  return _mode.mode == messages::RobotMode::MODE_PAUSED ||
+      _mode.mode == messages::RobotMode::MODE_EMERGENCY;
+}
+
+/// Modes that stop or resume robots, sent on the priority topic when it is
+/// configured. Resuming goes through the same topic, so that it is never
+/// overtaken by an earlier stop.
+bool is_priority_mode(const messages::RobotMode& _mode)
+{
+  return is_stop_mode(_mode) ||
+      _mode.mode == messages::RobotMode::MODE_MOVING;
+}
+
+} // namespace
+
 Server::ServerImpl::ServerImpl(const ServerConfig& _config) :
+  tracer(Tracer::make()),
+  metrics(Metrics::make()),
+  robot_state_metrics(
+      TopicMetrics::make_reader(*metrics, _config.dds_robot_state_topic)),
+  extended_robot_state_metrics(
+      TopicMetrics::make_reader(
+          *metrics, _config.dds_extended_robot_state_topic)),
+  mode_request_metrics(
+      TopicMetrics::make_writer(
+          *metrics,
+          _config.dds_trace_requests ?
+              _config.dds_extended_mode_request_topic :
+              _config.dds_mode_request_topic)),
+  path_request_metrics(
+      TopicMetrics::make_writer(
+          *metrics,
+          _config.dds_compress_paths || _config.dds_trace_requests ?
+              _config.dds_extended_path_request_topic :
+              _config.dds_path_request_topic)),
+  destination_request_metrics(
+      TopicMetrics::make_writer(
+          *metrics,
+          _config.dds_trace_requests ?
+              _config.dds_extended_destination_request_topic :
+              _config.dds_destination_request_topic)),
+  compact_robot_state_metrics(
+      TopicMetrics::make_reader(
+          *metrics, _config.dds_compact_robot_state_topic)),
+  name_registry_metrics(
+      TopicMetrics::make_reader(*metrics, _config.dds_name_registry_topic)),
+  fleet_path_request_metrics(
+      TopicMetrics::make_writer(
+          *metrics, _config.dds_fleet_path_request_topic)),
+  priority_mode_request_metrics(
+      TopicMetrics::make_writer(
+          *metrics, _config.dds_priority_mode_request_topic)),
+  name_collisions(&metrics->counter(
+      "free_fleet_name_collisions_total",
+      "Names announced with an ID already used by another name.")),
+  unrouted_requests(&metrics->counter(
+      "free_fleet_unrouted_requests_total",
+      "Requests sent on all domains, as their robot was not seen yet.")),
+  redundant_requests(&metrics->counter(
+      "free_fleet_redundant_requests_total",
+      "Requests not sent, as their task was already pending or acknowledged.")),
+  request_retransmissions(&metrics->counter(
+      "free_fleet_request_retransmissions_total",
+      "Requests sent again, as they were not acknowledged in time.")),
+  requests_delivered(&metrics->counter(
+      "free_fleet_requests_delivered_total",
+      "Requests acknowledged by their robot.")),
+  requests_timed_out(&metrics->counter(
+      "free_fleet_requests_timed_out_total",
+      "Requests never acknowledged after every retransmission.")),
+  requests_superseded(&metrics->counter(
+      "free_fleet_requests_superseded_total",
+      "Requests replaced by a request for another task before their ack.")),
+  request_delivery_time(&metrics->histogram(
+      "free_fleet_request_delivery_seconds",
+      "Time from the first send of a request until its acknowledgement.")),
+  stopped_requests(&metrics->counter(
+      "free_fleet_requests_stopped_total",
+      "Queued requests dropped, as a stop was sent to their robot first.")),
+  queued_requests(&metrics->gauge(
+      "free_fleet_queued_requests",
+      "Requests sent asynchronously, waiting for the writer thread.")),
+  writer_running(false),
+  writer_waiting(false),
   server_config(_config)
-{}
+{
+  if (_config.request_ack_timeout > 0.0)
+  {
+    request_tracker.reset(
+        new RequestTracker(
+            std::chrono::duration_cast<RequestTracker::Clock::duration>(
+                std::chrono::duration<double>(_config.request_ack_timeout)),
+            static_cast<uint32_t>(
+                std::max(_config.request_max_retransmissions, 0))));
+  }
+}
 
 Server::ServerImpl::~ServerImpl()
 {
-  dds_return_t return_code = dds_delete(fields.participant);
-  if (return_code != DDS_RETCODE_OK)
+  // Requests still queued are sent before the participants go away
+  if (writer_thread.joinable())
   {
-    DDS_FATAL("dds_delete: %s", dds_strretcode(-return_code));
+    {
+      std::unique_lock<std::mutex> lock(writer_mutex);
+      writer_running = false;
+    }
+    writer_cv.notify_one();
+    writer_thread.join();
+  }
+
+  for (const auto& domain : fields.domains)
+  {
+    dds_return_t return_code = common::delete_participant(domain.participant);
+    if (return_code != DDS_RETCODE_OK)
+    {
+      DDS_FATAL("dds_delete: %s", dds_strretcode(-return_code));
+    }
   }
 }
 
 void Server::ServerImpl::start(Fields _fields)
 {
   fields = std::move(_fields);
+  writer_running = true;
+  writer_thread = std::thread(&Server::ServerImpl::writer_thread_fn, this);
 }
 
 bool Server::ServerImpl::read_robot_states(
     std::vector<messages::RobotState>& _new_robot_states)
 {
-  auto robot_states = fields.robot_state_sub->read();
-  if (!robot_states.empty())
+  _new_robot_states.clear();
+  for (std::size_t d = 0; d < fields.domains.size(); ++d)
+  {
+    DomainFields& domain = fields.domains[d];
+    const std::size_t begin = _new_robot_states.size();
+
+    robot_state_metrics.drops->increment(
+        domain.robot_state_sub->get_dropped_samples_num());
+
+    take(*domain.robot_state_sub, robot_state_metrics, _new_robot_states);
+
+    if (domain.extended_robot_state_sub)
+    {
+      take(
+          *domain.extended_robot_state_sub, extended_robot_state_metrics,
+          _new_robot_states);
+    }
+
+    if (domain.compact_robot_state_sub)
+    {
+      // States referring to names that were not announced yet are dropped,
+      // the registry is reliable so this only happens for the first states
+      read_name_registry(domain);
+      take(
+          *domain.compact_robot_state_sub, compact_robot_state_metrics,
+          _new_robot_states, nullptr, name_registry);
+    }
+
+    if (fields.domains.size() > 1)
+      update_robot_domains(_new_robot_states, begin, d);
+  }
+
+  if (request_tracker)
+    update_request_tracker(_new_robot_states);
+  return !_new_robot_states.empty();
+}
+
+bool Server::ServerImpl::take_robot_states(
+    const ShardFn& _get_shard, std::vector<RobotStateBatch>& _batches)
+{
+  // Requests acknowledged by the batches taken before were acknowledged by
+  // now, unless they are still being deserialized
+  if (request_tracker)
+    resend_requests();
+
+  bool taken = false;
+  for (std::size_t d = 0; d < fields.domains.size(); ++d)
+  {
+    DomainFields& domain = fields.domains[d];
+    taken |= take_robot_state_samples(
+        *domain.robot_state_sub, robot_state_metrics, d, _get_shard,
+        _batches);
+
+    if (domain.extended_robot_state_sub)
+    {
+      taken |= take_robot_state_samples(
+          *domain.extended_robot_state_sub, extended_robot_state_metrics, d,
+          _get_shard, _batches);
+    }
+
+    if (domain.compact_robot_state_sub)
+    {
+      // Compact states are converted right away, as they refer to the names
+      // announced so far
+      thread_local std::vector<messages::RobotState> robot_states;
+      robot_states.clear();
+      read_name_registry(domain);
+      take(
+          *domain.compact_robot_state_sub, compact_robot_state_metrics,
+          robot_states, nullptr, name_registry);
+      if (fields.domains.size() > 1)
+        update_robot_domains(robot_states, 0, d);
+
+      for (auto& robot_state : robot_states)
+      {
+        _batches[_get_shard(robot_state.name)].robot_states.push_back(
+            std::move(robot_state));
+      }
+      taken |= !robot_states.empty();
+    }
+  }
+  return taken;
+}
+
+bool Server::ServerImpl::take_robot_state_samples(
+    TypedSubscriber<messages::RobotState, 10>& _subscriber,
+    TopicMetrics& _topic_metrics,
+    std::size_t _domain_index,
+    const ShardFn& _get_shard,
+    std::vector<RobotStateBatch>& _batches)
+{
+  thread_local std::vector<uint8_t> data;
+  thread_local std::string robot_name;
+
+  _topic_metrics.drops->increment(_subscriber.get_dropped_samples_num());
+
+  std::size_t taken_num = 0;
+  dds_sample_info_t sample_info;
+  while (taken_num < 10 && _subscriber.take(data, sample_info))
+  {
+    if (!messages::deserialize_robot_name(
+        data.data(), data.size(), robot_name))
+    {
+      _topic_metrics.drops->increment();
+      continue;
+    }
+
+    if (fields.domains.size() > 1)
+    {
+      std::lock_guard<std::mutex> lock(robot_domains_mutex);
+      robot_domains[robot_name] = _domain_index;
+    }
+
+    RobotStateBatch& batch = _batches[_get_shard(robot_name)];
+    batch.samples.push_back(
+        RobotStateBatch::Sample{
+            batch.data.size(), data.size(), _subscriber.is_extended()});
+    batch.data.insert(batch.data.end(), data.begin(), data.end());
+    ++taken_num;
+  }
+  return taken_num > 0;
+}
+
+void Server::ServerImpl::deserialize_robot_states(
+    RobotStateBatch& _batch,
+    std::vector<messages::RobotState>& _new_robot_states)
+{
+  using Traits = messages::MessageTraits<messages::RobotState>;
+
+  const std::size_t begin = _new_robot_states.size();
+  for (const auto& sample : _batch.samples)
   {
-    _new_robot_states.clear();
-    for (size_t i = 0; i < robot_states.size(); ++i)
+    TopicMetrics& topic_metrics =
+        sample.extended ? extended_robot_state_metrics : robot_state_metrics;
+    const auto start_time = TopicMetrics::Clock::now();
+    _new_robot_states.emplace_back();
+    if (!Traits::deserialize(
+        _batch.data.data() + sample.offset, sample.size, sample.extended,
+        _new_robot_states.back()))
     {
-      messages::RobotState tmp_robot_state;
-      convert(*(robot_states[i]), tmp_robot_state);
-      _new_robot_states.push_back(tmp_robot_state);
+      _new_robot_states.pop_back();
+      topic_metrics.drops->increment();
+      continue;
     }
+    topic_metrics.observe_conversion(start_time);
+    topic_metrics.samples->increment();
+    topic_metrics.bytes->increment(sample.size - 4);
+  }
+
+  _new_robot_states.insert(
+      _new_robot_states.end(),
+      std::make_move_iterator(_batch.robot_states.begin()),
+      std::make_move_iterator(_batch.robot_states.end()));
+  _batch.clear();
+
+  if (request_tracker)
+    acknowledge_requests(_new_robot_states, begin);
+}
+
+void Server::ServerImpl::update_robot_domains(
+    const std::vector<messages::RobotState>& _new_robot_states,
+    std::size_t _begin,
+    std::size_t _domain_index)
+{
+  std::lock_guard<std::mutex> lock(robot_domains_mutex);
+  for (std::size_t i = _begin; i < _new_robot_states.size(); ++i)
+    robot_domains[_new_robot_states[i].name] = _domain_index;
+}
+
+bool Server::ServerImpl::find_robot_domain(
+    const std::string& _robot_name, std::size_t& _domain_index)
+{
+  if (fields.domains.size() == 1)
+  {
+    _domain_index = 0;
     return true;
   }
-  return false;
+
+  std::lock_guard<std::mutex> lock(robot_domains_mutex);
+  auto it = robot_domains.find(_robot_name);
+  if (it == robot_domains.end())
+    return false;
+  _domain_index = it->second;
+  return true;
+}
+
+template<typename Publisher, typename... Args>
+bool Server::ServerImpl::write(
+    const std::string& _robot_name,
+    std::shared_ptr<Publisher> DomainFields::* _publisher,
+    const Args&... _args)
+{
+  std::size_t domain_index;
+  if (find_robot_domain(_robot_name, domain_index))
+    return (fields.domains[domain_index].*_publisher)->write(_args...);
+
+  unrouted_requests->increment();
+  bool sent = false;
+  for (auto& domain : fields.domains)
+    sent = (domain.*_publisher)->write(_args...) || sent;
+  return sent;
+}
+
+void Server::ServerImpl::read_name_registry(DomainFields& _domain)
+{
+  std::vector<NameRegistry::Entry> entries;
+  take(*_domain.name_registry_sub, name_registry_metrics, entries, nullptr);
+  for (const auto& entry : entries)
+  {
+    if (!name_registry.add_entry(entry))
+      name_collisions->increment();
+  }
 }
 
 bool Server::ServerImpl::send_mode_request(
     const messages::ModeRequest& _mode_request)
 {
-  FreeFleetData_ModeRequest* new_mr = FreeFleetData_ModeRequest__alloc();
-  convert(_mode_request, *new_mr);
-  bool sent = fields.mode_request_pub->write(new_mr);
-  FreeFleetData_ModeRequest_free(new_mr, DDS_FREE_ALL);
+  if (is_redundant(_mode_request.robot_name, _mode_request.task_id))
+    return true;
+
+  const messages::ModeRequest* mode_request = &_mode_request;
+  messages::ModeRequest traced_mode_request;
+  if (!_mode_request.trace.id.empty())
+  {
+    traced_mode_request = _mode_request;
+    tracer->stamp(traced_mode_request.trace, "server_send");
+    mode_request = &traced_mode_request;
+  }
+
+  bool sent = write_mode_request(*mode_request);
+  if (sent && request_tracker)
+  {
+    messages::ModeRequest copy = *mode_request;
+    track(
+        copy.robot_name, copy.task_id,
+        [this, copy]() { return write_mode_request(copy); });
+  }
   return sent;
 }
 
+bool Server::ServerImpl::write_mode_request(
+    const messages::ModeRequest& _mode_request)
+{
+  const bool priority =
+      fields.domains[0].priority_mode_request_pub &&
+      is_priority_mode(_mode_request.mode);
+  const auto publisher =
+      priority ?
+          &DomainFields::priority_mode_request_pub :
+          &DomainFields::mode_request_pub;
+  return publish(
+      _mode_request, (fields.domains[0].*publisher)->is_extended(), false,
+      priority ? priority_mode_request_metrics : mode_request_metrics,
+      [&](const uint8_t* _data, std::size_t _size)
+      {
+        return write(_mode_request.robot_name, publisher, _data, _size);
+      });
+}
+
 bool Server::ServerImpl::send_path_request(
     const messages::PathRequest& _path_request)
 {
-  FreeFleetData_PathRequest* new_pr = FreeFleetData_PathRequest__alloc();
-  convert(_path_request, *new_pr);
-  bool sent = fields.path_request_pub->write(new_pr);
-  FreeFleetData_PathRequest_free(new_pr, DDS_FREE_ALL);
+  if (is_redundant(_path_request.robot_name, _path_request.task_id))
+    return true;
+
+  const messages::PathRequest* path_request = &_path_request;
+  messages::PathRequest traced_path_request;
+  if (!_path_request.trace.id.empty())
+  {
+    traced_path_request = _path_request;
+    tracer->stamp(traced_path_request.trace, "server_send");
+    path_request = &traced_path_request;
+  }
+
+  bool sent = write_path_request(*path_request);
+  if (sent && request_tracker)
+  {
+    messages::PathRequest copy = *path_request;
+    track(
+        copy.robot_name, copy.task_id,
+        [this, copy]() { return write_path_request(copy); });
+  }
   return sent;
 }
 
+bool Server::ServerImpl::write_path_request(
+    const messages::PathRequest& _path_request)
+{
+  return publish(
+      _path_request, fields.domains[0].path_request_pub->is_extended(),
+      server_config.dds_compress_paths, path_request_metrics,
+      [&](const uint8_t* _data, std::size_t _size)
+      {
+        return write(
+            _path_request.robot_name, &DomainFields::path_request_pub,
+            _data, _size);
+      });
+}
+
+bool Server::ServerImpl::send_batch(
+    const std::vector<messages::PathRequest>& _path_requests)
+{
+  if (!fields.domains[0].fleet_path_request_pub)
+  {
+    bool sent = true;
+    for (const auto& path_request : _path_requests)
+      sent = send_path_request(path_request) && sent;
+    return sent;
+  }
+
+  std::vector<messages::PathRequest> path_requests;
+  path_requests.reserve(_path_requests.size());
+  for (const auto& path_request : _path_requests)
+  {
+    if (is_redundant(path_request.robot_name, path_request.task_id))
+      continue;
+    path_requests.push_back(path_request);
+    tracer->stamp(path_requests.back().trace, "server_send");
+  }
+  if (path_requests.empty())
+    return true;
+
+  // One batch per fleet and per domain, requests for robots that were not
+  // seen yet are added to the batches of every domain
+  using BatchKey = std::pair<std::string, std::size_t>;
+  std::map<BatchKey, std::vector<std::size_t>> batches;
+  for (std::size_t i = 0; i < path_requests.size(); ++i)
+  {
+    const messages::PathRequest& path_request = path_requests[i];
+    std::size_t domain_index;
+    if (find_robot_domain(path_request.robot_name, domain_index))
+    {
+      batches[BatchKey(path_request.fleet_name, domain_index)].push_back(i);
+      continue;
+    }
+
+    unrouted_requests->increment();
+    for (std::size_t d = 0; d < fields.domains.size(); ++d)
+      batches[BatchKey(path_request.fleet_name, d)].push_back(i);
+  }
+
+  std::vector<bool> sent_requests(path_requests.size(), false);
+  std::vector<const messages::PathRequest*> entries;
+  for (const auto& batch : batches)
+  {
+    entries.clear();
+    for (std::size_t i : batch.second)
+      entries.push_back(&path_requests[i]);
+    if (!write_fleet_path_request(
+        batch.first.first, entries, fields.domains[batch.first.second]))
+      continue;
+    for (std::size_t i : batch.second)
+      sent_requests[i] = true;
+  }
+
+  bool sent = true;
+  for (std::size_t i = 0; i < path_requests.size(); ++i)
+  {
+    if (!sent_requests[i])
+    {
+      sent = false;
+      continue;
+    }
+
+    // Batches are never sent again as a whole, each request that is not
+    // acknowledged in time is sent again on its own
+    if (request_tracker)
+    {
+      messages::PathRequest copy = path_requests[i];
+      track(
+          copy.robot_name, copy.task_id,
+          [this, copy]() { return write_path_request(copy); });
+    }
+  }
+  return sent;
+}
+
+bool Server::ServerImpl::write_fleet_path_request(
+    const std::string& _fleet_name,
+    const std::vector<const messages::PathRequest*>& _entries,
+    DomainFields& _domain)
+{
+  return publish(
+      *_domain.fleet_path_request_pub, _entries,
+      server_config.dds_compress_paths, fleet_path_request_metrics,
+      _fleet_name);
+}
+
 bool Server::ServerImpl::send_destination_request(
     const messages::DestinationRequest& _destination_request)
 {
-  FreeFleetData_DestinationRequest* new_dr = 
-      FreeFleetData_DestinationRequest__alloc();
-  convert(_destination_request, *new_dr);
-  bool sent = fields.destination_request_pub->write(new_dr);
-  FreeFleetData_DestinationRequest_free(new_dr, DDS_FREE_ALL);
+  if (is_redundant(
+      _destination_request.robot_name, _destination_request.task_id))
+    return true;
+
+  const messages::DestinationRequest* destination_request =
+      &_destination_request;
+  messages::DestinationRequest traced_destination_request;
+  if (!_destination_request.trace.id.empty())
+  {
+    traced_destination_request = _destination_request;
+    tracer->stamp(traced_destination_request.trace, "server_send");
+    destination_request = &traced_destination_request;
+  }
+
+  bool sent = write_destination_request(*destination_request);
+  if (sent && request_tracker)
+  {
+    messages::DestinationRequest copy = *destination_request;
+    track(
+        copy.robot_name, copy.task_id,
+        [this, copy]() { return write_destination_request(copy); });
+  }
   return sent;
 }
 
+bool Server::ServerImpl::write_destination_request(
+    const messages::DestinationRequest& _destination_request)
+{
+  return publish(
+      _destination_request,
+      fields.domains[0].destination_request_pub->is_extended(), false,
+      destination_request_metrics,
+      [&](const uint8_t* _data, std::size_t _size)
+      {
+        return write(
+            _destination_request.robot_name,
+            &DomainFields::destination_request_pub,
+            _data, _size);
+      });
+}
+
+std::future<bool> Server::ServerImpl::send_mode_request_async(
+    const messages::ModeRequest& _mode_request)
+{
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
+  send_mode_request_async(
+      _mode_request, [promise](bool _sent) { promise->set_value(_sent); });
+  return future;
+}
+
+void Server::ServerImpl::send_mode_request_async(
+    const messages::ModeRequest& _mode_request, SendCallback _callback)
+{
+  // Stopping and resuming robots never waits behind queued requests, these
+  // requests are small enough to be sent right away. The motion requests
+  // overtaken by a stop are dropped, as they would otherwise get the robot
+  // moving again right after it.
+  if (fields.domains[0].priority_mode_request_pub &&
+      is_priority_mode(_mode_request.mode))
+  {
+    if (is_stop_mode(_mode_request.mode))
+      supersede_motion_requests(_mode_request.robot_name);
+
+    const bool sent = send_mode_request(_mode_request);
+    if (_callback)
+      _callback(sent);
+    return;
+  }
+
+  messages::ModeRequest mode_request = _mode_request;
+  tracer->stamp(mode_request.trace, "server_enqueue");
+  enqueue(
+      [this, mode_request, callback = std::move(_callback)]()
+      {
+        const bool sent = send_mode_request(mode_request);
+        if (callback)
+          callback(sent);
+      });
+}
+
+std::future<bool> Server::ServerImpl::send_path_request_async(
+    const messages::PathRequest& _path_request)
+{
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
+  send_path_request_async(
+      _path_request, [promise](bool _sent) { promise->set_value(_sent); });
+  return future;
+}
+
+void Server::ServerImpl::send_path_request_async(
+    const messages::PathRequest& _path_request, SendCallback _callback)
+{
+  messages::PathRequest path_request = _path_request;
+  tracer->stamp(path_request.trace, "server_enqueue");
+  const uint64_t stop_count = get_stop_count(path_request.robot_name);
+  enqueue(
+      [this, path_request, stop_count, callback = std::move(_callback)]()
+      {
+        const bool sent =
+            !is_stopped_since(path_request.robot_name, stop_count) &&
+            send_path_request(path_request);
+        if (callback)
+          callback(sent);
+      });
+}
+
+std::future<bool> Server::ServerImpl::send_destination_request_async(
+    const messages::DestinationRequest& _destination_request)
+{
+  auto promise = std::make_shared<std::promise<bool>>();
+  std::future<bool> future = promise->get_future();
+  send_destination_request_async(
+      _destination_request,
+      [promise](bool _sent) { promise->set_value(_sent); });
+  return future;
+}
+
+void Server::ServerImpl::send_destination_request_async(
+    const messages::DestinationRequest& _destination_request,
+    SendCallback _callback)
+{
+  messages::DestinationRequest destination_request = _destination_request;
+  tracer->stamp(destination_request.trace, "server_enqueue");
+  const uint64_t stop_count =
+      get_stop_count(destination_request.robot_name);
+  enqueue(
+      [this, destination_request, stop_count,
+          callback = std::move(_callback)]()
+      {
+        const bool sent =
+            !is_stopped_since(destination_request.robot_name, stop_count) &&
+            send_destination_request(destination_request);
+        if (callback)
+          callback(sent);
+      });
+}
+
+uint64_t Server::ServerImpl::get_stop_count(const std::string& _robot_name)
+{
+  std::lock_guard<std::mutex> lock(stop_counts_mutex);
+  auto it = stop_counts.find(_robot_name);
+  return it == stop_counts.end() ? 0 : it->second;
+}
+
+void Server::ServerImpl::supersede_motion_requests(
+    const std::string& _robot_name)
+{
+  {
+    std::lock_guard<std::mutex> lock(stop_counts_mutex);
+    ++stop_counts[_robot_name];
+  }
+
+  if (!request_tracker)
+    return;
+
+  std::vector<RequestTracker::Report> reports;
+  request_tracker->cancel(
+      _robot_name, RequestTracker::Clock::now(), reports);
+  report_deliveries(reports);
+}
+
+bool Server::ServerImpl::is_stopped_since(
+    const std::string& _robot_name, uint64_t _stop_count)
+{
+  if (get_stop_count(_robot_name) == _stop_count)
+    return false;
+  stopped_requests->increment();
+  return true;
+}
+
+void Server::ServerImpl::enqueue(SendJob _job)
+{
+  queued_requests->add(1.0);
+  send_queue.push(std::move(_job));
+
+  // The writer mutex is only taken when the writer thread has nothing left
+  // to send, to make sure it does not miss this request
+  if (writer_waiting)
+  {
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    writer_cv.notify_one();
+  }
+}
+
+void Server::ServerImpl::writer_thread_fn()
+{
+  SendJob job;
+  while (true)
+  {
+    if (send_queue.pop(job))
+    {
+      queued_requests->add(-1.0);
+      job();
+      job = nullptr;
+      continue;
+    }
+
+    // A producer is still linking its request to the queue
+    if (!send_queue.empty())
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    if (!writer_running)
+      break;
+    writer_waiting = true;
+    writer_cv.wait(
+        lock,
+        [this]()
+        {
+          return !send_queue.empty() || !writer_running;
+        });
+    writer_waiting = false;
+  }
+}
+
+bool Server::ServerImpl::is_redundant(
+    const std::string& _robot_name, const std::string& _task_id)
+{
+  // Requests without a task cannot be acknowledged, idle robots echo an
+  // empty task ID
+  if (!request_tracker || _task_id.empty() ||
+      !request_tracker->is_redundant(_robot_name, _task_id))
+    return false;
+  redundant_requests->increment();
+  return true;
+}
+
+void Server::ServerImpl::track(
+    const std::string& _robot_name,
+    const std::string& _task_id,
+    RequestTracker::Resend _resend)
+{
+  if (_task_id.empty())
+    return;
+
+  std::vector<RequestTracker::Report> reports;
+  request_tracker->add(
+      _robot_name, _task_id, std::move(_resend),
+      RequestTracker::Clock::now(), reports);
+  report_deliveries(reports);
+}
+
+void Server::ServerImpl::update_request_tracker(
+    const std::vector<messages::RobotState>& _new_robot_states)
+{
+  acknowledge_requests(_new_robot_states, 0);
+  resend_requests();
+}
+
+void Server::ServerImpl::acknowledge_requests(
+    const std::vector<messages::RobotState>& _new_robot_states,
+    std::size_t _begin)
+{
+  const auto now = RequestTracker::Clock::now();
+  std::vector<RequestTracker::Report> reports;
+  for (std::size_t i = _begin; i < _new_robot_states.size(); ++i)
+  {
+    request_tracker->acknowledge(
+        _new_robot_states[i].name, _new_robot_states[i].task_id, now,
+        reports);
+  }
+  report_deliveries(reports);
+}
+
+void Server::ServerImpl::resend_requests()
+{
+  std::vector<RequestTracker::Report> reports;
+  std::vector<RequestTracker::Resend> resends;
+  request_tracker->update(RequestTracker::Clock::now(), resends, reports);
+  for (const auto& resend : resends)
+  {
+    request_retransmissions->increment();
+    resend();
+  }
+  report_deliveries(reports);
+}
+
+void Server::ServerImpl::report_deliveries(
+    const std::vector<RequestTracker::Report>& _reports)
+{
+  if (_reports.empty())
+    return;
+
+  DeliveryCallback callback;
+  {
+    std::lock_guard<std::mutex> lock(delivery_callback_mutex);
+    callback = delivery_callback;
+  }
+
+  for (const auto& report : _reports)
+  {
+    switch (report.status)
+    {
+      case DeliveryReport::Status::Delivered:
+        requests_delivered->increment();
+        request_delivery_time->observe(
+            static_cast<double>(report.latency_nanosec) * 1e-9);
+        break;
+      case DeliveryReport::Status::TimedOut:
+        requests_timed_out->increment();
+        break;
+      case DeliveryReport::Status::Superseded:
+        requests_superseded->increment();
+        break;
+    }
+
+    if (callback)
+      callback(report);
+  }
+}
+
+void Server::ServerImpl::set_delivery_callback(DeliveryCallback _callback)
+{
+  std::lock_guard<std::mutex> lock(delivery_callback_mutex);
+  delivery_callback = std::move(_callback);
+}
+
+Tracer::SharedPtr Server::ServerImpl::get_tracer() const
+{
+  return tracer;
+}
+
+Metrics::SharedPtr Server::ServerImpl::get_metrics() const
+{
+  return metrics;
+}
+
 } // namespace free_fleet
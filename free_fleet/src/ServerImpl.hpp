@@ -18,15 +18,33 @@
 #ifndef FREE_FLEET__SRC__SERVERIMPL_HPP
 #define FREE_FLEET__SRC__SERVERIMPL_HPP
 
+#include <mutex>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+
 #include <free_fleet/messages/RobotState.hpp>
 #include <free_fleet/messages/ModeRequest.hpp>
 #include <free_fleet/messages/PathRequest.hpp>
 #include <free_fleet/messages/DestinationRequest.hpp>
 #include <free_fleet/Server.hpp>
+#include <free_fleet/Tracer.hpp>
+#include <free_fleet/Metrics.hpp>
 #include <free_fleet/ServerConfig.hpp>
 
 #include <dds/dds.h>
 
+#include "MpscQueue.hpp"
+#include "NameRegistry.hpp"
+#include "TopicMetrics.hpp"
+#include "TypedTopics.hpp"
+#include "RequestTracker.hpp"
 #include "messages/FleetMessages.h"
 #include "dds_utils/DDSPublishHandler.hpp"
 #include "dds_utils/DDSSubscribeHandler.hpp"
@@ -37,27 +55,56 @@ class Server::ServerImpl
 {
 public:
 
-  /// DDS related fields required for the server to operate
-  struct Fields
+  /// DDS related fields required for the server to operate on one domain
+  struct DomainFields
   {
-    /// DDS participant that is tied to the configured dds_domain_id
+    /// DDS participant that is tied to the domain
     dds_entity_t participant;
 
     /// DDS subscribers for new incoming robot states from clients
-    dds::DDSSubscribeHandler<FreeFleetData_RobotState, 10>::SharedPtr 
-        robot_state_sub;
+    TypedSubscriber<messages::RobotState, 10>::SharedPtr robot_state_sub;
+
+    /// DDS subscriber for the robot states of clients that compress their
+    /// paths, only set when compressed paths are configured
+    TypedSubscriber<messages::RobotState, 10>::SharedPtr
+        extended_robot_state_sub;
 
     /// DDS publisher for mode requests to be sent to clients
-    dds::DDSPublishHandler<FreeFleetData_ModeRequest>::SharedPtr
-        mode_request_pub;
+    TypedPublisher<messages::ModeRequest>::SharedPtr mode_request_pub;
 
-    /// DDS publisher for path requests to be sent to clients
-    dds::DDSPublishHandler<FreeFleetData_PathRequest>::SharedPtr
-        path_request_pub;
+    /// DDS publisher for path requests to be sent to clients, of the
+    /// extended type on its own topic when compressed paths are configured
+    TypedPublisher<messages::PathRequest>::SharedPtr path_request_pub;
 
     /// DDS publisher for destination requests to be sent to clients
-    dds::DDSPublishHandler<FreeFleetData_DestinationRequest>::SharedPtr
+    TypedPublisher<messages::DestinationRequest>::SharedPtr
         destination_request_pub;
+
+    /// DDS subscribers for compact robot states and the names they refer to,
+    /// only set when compact robot states are configured
+    dds::DDSSubscribeHandler<FreeFleetData_CompactRobotState, 10>::SharedPtr
+        compact_robot_state_sub;
+
+    dds::DDSSubscribeHandler<FreeFleetData_NameRegistryEntry, 10>::SharedPtr
+        name_registry_sub;
+
+    /// DDS publisher for PAUSE, EMERGENCY and RESUME mode requests, only set
+    /// when priority mode requests are configured
+    TypedPublisher<messages::ModeRequest>::SharedPtr
+        priority_mode_request_pub;
+
+    /// DDS publisher for path requests batched for a whole fleet, only set
+    /// when fleet path requests are configured
+    dds::DDSPublishHandler<FreeFleetData_FleetPathRequest>::SharedPtr
+        fleet_path_request_pub;
+  };
+
+  /// DDS related fields required for the server to operate
+  struct Fields
+  {
+    /// One entry per configured domain, starting with dds_domain followed by
+    /// dds_extra_domains
+    std::vector<DomainFields> domains;
   };
 
   ServerImpl(const ServerConfig& config);
@@ -68,6 +115,13 @@ public:
 
   bool read_robot_states(std::vector<messages::RobotState>& new_robot_states);
 
+  bool take_robot_states(
+      const ShardFn& get_shard, std::vector<RobotStateBatch>& batches);
+
+  void deserialize_robot_states(
+      RobotStateBatch& batch,
+      std::vector<messages::RobotState>& new_robot_states);
+
   bool send_mode_request(const messages::ModeRequest& mode_request);
 
   bool send_path_request(const messages::PathRequest& path_request);
@@ -75,10 +129,199 @@ public:
   bool send_destination_request(
       const messages::DestinationRequest& destination_request);
 
+  bool send_batch(const std::vector<messages::PathRequest>& path_requests);
+
+  std::future<bool> send_mode_request_async(
+      const messages::ModeRequest& mode_request);
+
+  void send_mode_request_async(
+      const messages::ModeRequest& mode_request, SendCallback callback);
+
+  std::future<bool> send_path_request_async(
+      const messages::PathRequest& path_request);
+
+  void send_path_request_async(
+      const messages::PathRequest& path_request, SendCallback callback);
+
+  std::future<bool> send_destination_request_async(
+      const messages::DestinationRequest& destination_request);
+
+  void send_destination_request_async(
+      const messages::DestinationRequest& destination_request,
+      SendCallback callback);
+
+  void set_delivery_callback(DeliveryCallback callback);
+
+  Tracer::SharedPtr get_tracer() const;
+
+  Metrics::SharedPtr get_metrics() const;
+
 private:
 
   Fields fields;
 
+  Tracer::SharedPtr tracer;
+
+  Metrics::SharedPtr metrics;
+
+  TopicMetrics robot_state_metrics;
+
+  TopicMetrics extended_robot_state_metrics;
+
+  TopicMetrics mode_request_metrics;
+
+  TopicMetrics path_request_metrics;
+
+  TopicMetrics destination_request_metrics;
+
+  TopicMetrics compact_robot_state_metrics;
+
+  TopicMetrics name_registry_metrics;
+
+  TopicMetrics fleet_path_request_metrics;
+
+  TopicMetrics priority_mode_request_metrics;
+
+  /// Names announced by all the clients publishing compact robot states
+  NameRegistry name_registry;
+
+  Metrics::Counter* name_collisions;
+
+  /// Index of the domain on which each robot was last seen, by robot name.
+  /// Only used with more than one domain.
+  std::mutex robot_domains_mutex;
+
+  std::unordered_map<std::string, std::size_t> robot_domains;
+
+  Metrics::Counter* unrouted_requests;
+
+  Metrics::Counter* redundant_requests;
+
+  Metrics::Counter* request_retransmissions;
+
+  Metrics::Counter* requests_delivered;
+
+  Metrics::Counter* requests_timed_out;
+
+  Metrics::Counter* requests_superseded;
+
+  Metrics::Histogram* request_delivery_time;
+
+  void update_robot_domains(
+      const std::vector<messages::RobotState>& new_robot_states,
+      std::size_t begin,
+      std::size_t domain_index);
+
+  /// Takes the samples of a robot state subscriber into the batches of their
+  /// robots, only reading their robot names.
+  bool take_robot_state_samples(
+      TypedSubscriber<messages::RobotState, 10>& subscriber,
+      TopicMetrics& topic_metrics,
+      std::size_t domain_index,
+      const ShardFn& get_shard,
+      std::vector<RobotStateBatch>& batches);
+
+  /// Finds the domain where the robot was last seen, always the only domain
+  /// when there is a single one.
+  ///
+  /// \return
+  ///   False if the robot was not seen yet.
+  bool find_robot_domain(
+      const std::string& robot_name, std::size_t& domain_index);
+
+  /// Writes a request on the domain where the robot was last seen, or on all
+  /// the domains if it was not seen yet.
+  template<typename Publisher, typename... Args>
+  bool write(
+      const std::string& robot_name,
+      std::shared_ptr<Publisher> DomainFields::* publisher,
+      const Args&... args);
+
+  /// Writes requests without tracking them, also used to send them again
+  bool write_mode_request(const messages::ModeRequest& mode_request);
+
+  bool write_path_request(const messages::PathRequest& path_request);
+
+  bool write_destination_request(
+      const messages::DestinationRequest& destination_request);
+
+  bool write_fleet_path_request(
+      const std::string& fleet_name,
+      const std::vector<const messages::PathRequest*>& entries,
+      DomainFields& domain);
+
+  /// Only set when requests are tracked until their acknowledgement
+  std::unique_ptr<RequestTracker> request_tracker;
+
+  std::mutex delivery_callback_mutex;
+
+  DeliveryCallback delivery_callback;
+
+  bool is_redundant(const std::string& robot_name, const std::string& task_id);
+
+  void track(
+      const std::string& robot_name,
+      const std::string& task_id,
+      RequestTracker::Resend resend);
+
+  /// Acknowledges requests with the new robot states, and sends again the
+  /// requests that timed out.
+  void update_request_tracker(
+      const std::vector<messages::RobotState>& new_robot_states);
+
+  void acknowledge_requests(
+      const std::vector<messages::RobotState>& new_robot_states,
+      std::size_t begin);
+
+  void resend_requests();
+
+  void report_deliveries(const std::vector<RequestTracker::Report>& reports);
+
+  /// Number of stops sent to each robot ahead of the queued requests, by
+  /// robot name. Path and destination requests queued before a stop are
+  /// dropped instead of being sent after it.
+  std::mutex stop_counts_mutex;
+
+  std::unordered_map<std::string, uint64_t> stop_counts;
+
+  Metrics::Counter* stopped_requests;
+
+  uint64_t get_stop_count(const std::string& robot_name);
+
+  /// Drops the motion requests of a robot queued so far and its tracked
+  /// request, as a stop is about to be sent ahead of them.
+  void supersede_motion_requests(const std::string& robot_name);
+
+  /// Checks if a stop was sent to the robot since its request was queued,
+  /// counting the request as dropped if so.
+  bool is_stopped_since(const std::string& robot_name, uint64_t stop_count);
+
+  /// Requests queued by the send_*_async functions, each job sends one
+  /// request and calls its callback
+  using SendJob = std::function<void()>;
+
+  MpscQueue<SendJob> send_queue;
+
+  Metrics::Gauge* queued_requests;
+
+  std::thread writer_thread;
+
+  std::atomic<bool> writer_running;
+
+  /// Set while the writer thread sleeps, so that producers only take the
+  /// writer mutex to wake it up
+  std::atomic<bool> writer_waiting;
+
+  std::mutex writer_mutex;
+
+  std::condition_variable writer_cv;
+
+  void enqueue(SendJob job);
+
+  void writer_thread_fn();
+
+  void read_name_registry(DomainFields& domain);
+
   ServerConfig server_config;
 
 };
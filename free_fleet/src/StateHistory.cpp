@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <atomic>
+#include <cstring>
+#include <algorithm>
+
+#include <free_fleet/StateHistory.hpp>
+
+namespace free_fleet {
+
+namespace {
+
+constexpr char Magic[8] = {'F', 'F', 'H', 'I', 'S', 'T', 'O', 'R'};
+
+constexpr uint32_t Version = 1;
+
+void copy_name(char* _dest, const std::string& _name)
+{
+  const std::size_t size =
+      std::min(_name.size(), StateHistory::NameSize - 1);
+  memcpy(_dest, _name.data(), size);
+  memset(_dest + size, 0, StateHistory::NameSize - size);
+}
+
+} // namespace
+
+struct StateHistory::FileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;
+  uint64_t capacity;
+
+  /// Number of records ever appended, the next record goes into the slot at
+  /// head % capacity
+  std::atomic<uint64_t> head;
+
+  char padding[32];
+};
+
+/// Every slot is guarded by its own sequence number, which is zero while the
+/// slot is being written and the absolute index of its record plus one once
+/// written, so that readers can detect records overwritten while copying.
+struct StateHistory::Slot
+{
+  std::atomic<uint64_t> sequence;
+  Record record;
+};
+
+static_assert(sizeof(StateHistory::Record) % 8 == 0,
+    "records must keep the slots aligned");
+
+StateHistory::SharedPtr StateHistory::make(
+    const std::string& _path, std::size_t _capacity)
+{
+  if (_capacity == 0)
+    return nullptr;
+
+  int fd = ::open(_path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0)
+    return nullptr;
+
+  const std::size_t mapped_size =
+      sizeof(FileHeader) + _capacity * sizeof(Slot);
+
+  // Keeps the existing history when it was created with the same layout
+  bool reuse = false;
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == 0 &&
+      static_cast<std::size_t>(file_stat.st_size) == mapped_size)
+  {
+    FileHeader existing;
+    reuse = pread(fd, &existing, sizeof(existing), 0) ==
+            static_cast<ssize_t>(sizeof(existing)) &&
+        memcmp(existing.magic, Magic, sizeof(Magic)) == 0 &&
+        existing.version == Version &&
+        existing.record_size == sizeof(Record) &&
+        existing.capacity == _capacity;
+  }
+
+  if (!reuse &&
+      (ftruncate(fd, 0) != 0 ||
+      ftruncate(fd, static_cast<off_t>(mapped_size)) != 0))
+  {
+    close(fd);
+    return nullptr;
+  }
+
+  void* mapped = mmap(
+      nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED)
+    return nullptr;
+
+  // Freshly truncated files are zero filled, hence all slots start empty
+  if (!reuse)
+  {
+    FileHeader* header = static_cast<FileHeader*>(mapped);
+    header->version = Version;
+    header->record_size = sizeof(Record);
+    header->capacity = _capacity;
+    header->head.store(0);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(header->magic, Magic, sizeof(Magic));
+  }
+
+  return SharedPtr(new StateHistory(mapped, mapped_size, true));
+}
+
+StateHistory::SharedPtr StateHistory::open(const std::string& _path)
+{
+  int fd = ::open(_path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return nullptr;
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<std::size_t>(file_stat.st_size) < sizeof(FileHeader))
+  {
+    close(fd);
+    return nullptr;
+  }
+
+  const std::size_t mapped_size =
+      static_cast<std::size_t>(file_stat.st_size);
+  void* mapped = mmap(nullptr, mapped_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED)
+    return nullptr;
+
+  const FileHeader* header = static_cast<const FileHeader*>(mapped);
+  if (memcmp(header->magic, Magic, sizeof(Magic)) != 0 ||
+      header->version != Version ||
+      header->record_size != sizeof(Record) ||
+      mapped_size != sizeof(FileHeader) + header->capacity * sizeof(Slot))
+  {
+    munmap(mapped, mapped_size);
+    return nullptr;
+  }
+
+  return SharedPtr(new StateHistory(mapped, mapped_size, false));
+}
+
+StateHistory::StateHistory(
+    void* _mapped, std::size_t _mapped_size, bool _writable) :
+  header(static_cast<FileHeader*>(_mapped)),
+  slots(reinterpret_cast<Slot*>(
+      static_cast<char*>(_mapped) + sizeof(FileHeader))),
+  mapped_size(_mapped_size),
+  writable(_writable)
+{}
+
+StateHistory::~StateHistory()
+{
+  munmap(header, mapped_size);
+}
+
+bool StateHistory::append(
+    const messages::RobotState& _state, int64_t _stamp)
+{
+  if (!writable)
+    return false;
+
+  const uint64_t index = header->head.load(std::memory_order_relaxed);
+  Slot& slot = slots[index % header->capacity];
+
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  Record& record = slot.record;
+  record.stamp = _stamp;
+  record.location_sec = _state.location.sec;
+  record.location_nanosec = _state.location.nanosec;
+  record.x = _state.location.x;
+  record.y = _state.location.y;
+  record.yaw = _state.location.yaw;
+  record.battery_percent = _state.battery_percent;
+  record.mode = _state.mode.mode;
+  record.reserved = 0;
+  copy_name(record.robot_name, _state.name);
+  copy_name(record.level_name, _state.location.level_name);
+  copy_name(record.task_id, _state.task_id);
+
+  slot.sequence.store(index + 1, std::memory_order_release);
+  header->head.store(index + 1, std::memory_order_release);
+  return true;
+}
+
+bool StateHistory::read_slot(uint64_t _index, Record& _record) const
+{
+  const Slot& slot = slots[_index % header->capacity];
+  if (slot.sequence.load(std::memory_order_acquire) != _index + 1)
+    return false;
+  memcpy(&_record, &slot.record, sizeof(Record));
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.sequence.load(std::memory_order_relaxed) == _index + 1;
+}
+
+std::size_t StateHistory::query(
+    int64_t _start,
+    int64_t _end,
+    std::vector<Record>& _records,
+    const std::string& _robot_name) const
+{
+  _records.clear();
+
+  const uint64_t head = header->head.load(std::memory_order_acquire);
+  uint64_t low = head > header->capacity ? head - header->capacity : 0;
+  uint64_t high = head;
+
+  // Binary search for the first record at or after the start, records that
+  // get overwritten during the search are older than anything still kept
+  Record record;
+  while (low < high)
+  {
+    const uint64_t mid = low + (high - low) / 2;
+    if (!read_slot(mid, record) || record.stamp < _start)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  for (uint64_t i = low; i < head; ++i)
+  {
+    if (!read_slot(i, record))
+      continue;
+    if (record.stamp > _end)
+      break;
+    if (!_robot_name.empty() &&
+        strncmp(
+            record.robot_name, _robot_name.c_str(), NameSize - 1) != 0)
+      continue;
+    _records.push_back(record);
+  }
+  return _records.size();
+}
+
+std::size_t StateHistory::size() const
+{
+  const uint64_t head = header->head.load(std::memory_order_acquire);
+  return static_cast<std::size_t>(std::min(head, header->capacity));
+}
+
+std::size_t StateHistory::capacity() const
+{
+  return static_cast<std::size_t>(header->capacity);
+}
+
+} // namespace free_fleet
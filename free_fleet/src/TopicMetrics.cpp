@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "TopicMetrics.hpp"
+
+namespace free_fleet {
+
+void TopicMetrics::observe_conversion(const Clock::time_point& _start_time)
+{
+  conversion_time->observe(
+      std::chrono::duration<double>(Clock::now() - _start_time).count());
+}
+
+TopicMetrics TopicMetrics::make_reader(
+    Metrics& _metrics, const std::string& _topic)
+{
+  const Metrics::Labels labels = {{"topic", _topic}};
+  return TopicMetrics{
+      &_metrics.counter(
+          "free_fleet_samples_taken_total",
+          "Number of samples taken from DDS.", labels),
+      &_metrics.counter(
+          "free_fleet_bytes_taken_total",
+          "Serialized size in bytes of the samples taken from DDS.", labels),
+      &_metrics.counter(
+          "free_fleet_samples_dropped_total",
+          "Number of samples lost or rejected before they could be taken.",
+          labels),
+      &_metrics.histogram(
+          "free_fleet_conversion_seconds",
+          "Time spent converting between free fleet and DDS messages.",
+          labels)};
+}
+
+TopicMetrics TopicMetrics::make_writer(
+    Metrics& _metrics, const std::string& _topic)
+{
+  const Metrics::Labels labels = {{"topic", _topic}};
+  return TopicMetrics{
+      &_metrics.counter(
+          "free_fleet_samples_written_total",
+          "Number of samples written to DDS.", labels),
+      &_metrics.counter(
+          "free_fleet_bytes_written_total",
+          "Serialized size in bytes of the samples written to DDS.", labels),
+      &_metrics.counter(
+          "free_fleet_write_failures_total",
+          "Number of samples that could not be written to DDS.", labels),
+      &_metrics.histogram(
+          "free_fleet_conversion_seconds",
+          "Time spent converting between free fleet and DDS messages.",
+          labels)};
+}
+
+} // namespace free_fleet
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET__SRC__TOPICMETRICS_HPP
+#define FREE_FLEET__SRC__TOPICMETRICS_HPP
+
+#include <chrono>
+#include <string>
+
+#include <free_fleet/Metrics.hpp>
+
+namespace free_fleet {
+
+/// Metrics of the samples going through a single DDS reader or writer,
+/// registered once so that updating them never takes a lock.
+struct TopicMetrics
+{
+  using Clock = std::chrono::steady_clock;
+
+  /// Samples taken by the reader, or written by the writer
+  Metrics::Counter* samples;
+
+  /// Serialized size of the samples taken or written
+  Metrics::Counter* bytes;
+
+  /// Samples lost or rejected by the reader, or failed writes
+  Metrics::Counter* drops;
+
+  /// Time spent converting between free fleet and DDS messages
+  Metrics::Histogram* conversion_time;
+
+  void observe_conversion(const Clock::time_point& start_time);
+
+  static TopicMetrics make_reader(Metrics& metrics, const std::string& topic);
+
+  static TopicMetrics make_writer(Metrics& metrics, const std::string& topic);
+};
+
+} // namespace free_fleet
+
+#endif // FREE_FLEET__SRC__TOPICMETRICS_HPP
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+
+#include <free_fleet/Tracer.hpp>
+
+namespace free_fleet {
+
+namespace {
+
+std::size_t to_bucket_index(int64_t _latency_microsec)
+{
+  if (_latency_microsec < 8)
+    return static_cast<std::size_t>(std::max<int64_t>(_latency_microsec, 0));
+
+  int exponent = 3;
+  while ((_latency_microsec >> (exponent + 1)) != 0)
+    ++exponent;
+  const int64_t sub_bucket = (_latency_microsec >> (exponent - 3)) & 7;
+  return 8 + static_cast<std::size_t>((exponent - 3) * 8 + sub_bucket);
+}
+
+int64_t to_bucket_upper_bound(std::size_t _index)
+{
+  if (_index < 8)
+    return static_cast<int64_t>(_index) + 1;
+
+  const std::size_t exponent = (_index - 8) / 8 + 3;
+  const int64_t sub_bucket = static_cast<int64_t>((_index - 8) % 8);
+  return (8 + sub_bucket + 1) << (exponent - 3);
+}
+
+double to_millisec(int64_t _nanosec)
+{
+  return static_cast<double>(_nanosec) / 1e6;
+}
+
+} // namespace
+
+Tracer::Histogram::Histogram() :
+  count(0),
+  sum_nanosec(0),
+  max_nanosec(0)
+{
+  buckets.fill(0);
+}
+
+void Tracer::Histogram::add(int64_t _latency_nanosec)
+{
+  // Hops converted from the clock of another machine may go back in time,
+  // by as much as the error of the clock offset estimate
+  _latency_nanosec = std::max<int64_t>(_latency_nanosec, 0);
+
+  const std::size_t index =
+      std::min(to_bucket_index(_latency_nanosec / 1000), BucketNum - 1);
+  ++buckets[index];
+  ++count;
+  sum_nanosec += _latency_nanosec;
+  max_nanosec = std::max(max_nanosec, _latency_nanosec);
+}
+
+int64_t Tracer::Histogram::quantile(double _q) const
+{
+  if (count == 0)
+    return 0;
+
+  const uint64_t rank =
+      std::max<uint64_t>(static_cast<uint64_t>(_q * count + 0.5), 1);
+  uint64_t seen = 0;
+  for (std::size_t i = 0; i < BucketNum; ++i)
+  {
+    seen += buckets[i];
+    if (seen >= rank)
+      return std::min(to_bucket_upper_bound(i) * 1000, max_nanosec);
+  }
+  return max_nanosec;
+}
+
+Tracer::SharedPtr Tracer::make()
+{
+  return SharedPtr(new Tracer());
+}
+
+int64_t Tracer::now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+Tracer::Tracer()
+{}
+
+void Tracer::start(
+    messages::Trace& _trace,
+    const std::string& _id,
+    const std::string& _stage,
+    int64_t _stamp)
+{
+  _trace.id = _id;
+  _trace.hops.clear();
+  _trace.hops.push_back(messages::TraceHop{_stage, _stamp});
+}
+
+bool Tracer::stamp(messages::Trace& _trace, const std::string& _stage)
+{
+  if (_trace.id.empty() || _trace.hops.empty())
+    return false;
+
+  const messages::TraceHop hop{_stage, now()};
+  const messages::TraceHop& first_hop = _trace.hops.front();
+  const messages::TraceHop& previous_hop = _trace.hops.back();
+  record(previous_hop.stage + " -> " + hop.stage,
+      hop.stamp - previous_hop.stamp);
+  if (_trace.hops.size() > 1)
+    record(first_hop.stage + " => " + hop.stage, hop.stamp - first_hop.stamp);
+
+  _trace.hops.push_back(hop);
+  return true;
+}
+
+bool Tracer::stamp_received(
+    messages::Trace& _trace,
+    const std::string& _stage,
+    int64_t _remote_offset_nanosec)
+{
+  if (_trace.id.empty() || _trace.hops.empty())
+    return false;
+
+  for (auto& hop : _trace.hops)
+    hop.stamp += _remote_offset_nanosec;
+  return stamp(_trace, _stage);
+}
+
+bool Tracer::stamp_received(messages::Trace& _trace, const std::string& _stage)
+{
+  if (_trace.id.empty() || _trace.hops.empty())
+    return false;
+
+  start(_trace, _trace.id, _stage);
+  return true;
+}
+
+void Tracer::record(const std::string& _name, int64_t _latency_nanosec)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  histograms[_name].add(_latency_nanosec);
+}
+
+std::vector<Tracer::StageStatistics> Tracer::get_statistics() const
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  std::vector<StageStatistics> statistics;
+  for (const auto& it : histograms)
+  {
+    const Histogram& histogram = it.second;
+    statistics.push_back(StageStatistics{
+        it.first,
+        histogram.count,
+        to_millisec(histogram.sum_nanosec) / histogram.count,
+        to_millisec(histogram.quantile(0.5)),
+        to_millisec(histogram.quantile(0.9)),
+        to_millisec(histogram.quantile(0.99)),
+        to_millisec(histogram.max_nanosec)});
+  }
+  return statistics;
+}
+
+std::string Tracer::dump() const
+{
+  const std::vector<StageStatistics> statistics = get_statistics();
+
+  std::string output;
+  char line[256];
+  snprintf(line, sizeof(line), "%-56s %8s %10s %10s %10s %10s %10s\n",
+      "stages (ms)", "count", "mean", "p50", "p90", "p99", "max");
+  output += line;
+  for (const auto& stage : statistics)
+  {
+    snprintf(line, sizeof(line),
+        "%-56s %8llu %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+        stage.name.c_str(), static_cast<unsigned long long>(stage.count),
+        stage.mean, stage.p50, stage.p90, stage.p99, stage.max);
+    output += line;
+  }
+  return output;
+}
+
+void Tracer::reset()
+{
+  std::unique_lock<std::mutex> lock(mutex);
+  histograms.clear();
+}
+
+} // namespace free_fleet
@@ -0,0 +1,376 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#ifndef FREE_FLEET__SRC__TYPEDTOPICS_HPP
+#define FREE_FLEET__SRC__TYPEDTOPICS_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include <dds/dds.h>
+
+#include "TopicMetrics.hpp"
+#include "messages/MessageTraits.hpp"
+#include "dds_utils/Qos.hpp"
+#include "dds_utils/DDSPublishHandler.hpp"
+#include "dds_utils/DDSSubscribeHandler.hpp"
+#include "dds_utils/DDSSerializedPublishHandler.hpp"
+#include "dds_utils/DDSSerializedSubscribeHandler.hpp"
+
+namespace free_fleet {
+
+/// DDS publisher of the serialized samples of a free fleet message, the
+/// message type only tags the publisher so that it cannot be mixed up with
+/// the publisher of another message.
+template<typename Message>
+class TypedPublisher : public dds::DDSSerializedPublishHandler
+{
+public:
+
+  using SharedPtr = std::shared_ptr<TypedPublisher>;
+
+  /// \param[in] _extended
+  ///   Publishes samples of the extended type of the message, see
+  ///   MessageTraits.
+  TypedPublisher(
+      const dds_entity_t& _participant,
+      const std::string& _topic_name,
+      dds::Qos _qos,
+      bool _extended) :
+    dds::DDSSerializedPublishHandler(
+        _participant, messages::MessageTraits<Message>::descriptor(_extended),
+        _topic_name, "", _qos),
+    extended(_extended)
+  {}
+
+  bool is_extended() const
+  {
+    return extended;
+  }
+
+private:
+
+  bool extended;
+};
+
+/// DDS subscriber of the serialized samples of a free fleet message, which
+/// takes at most MaxSamplesNum samples at a time.
+template<typename Message, std::size_t MaxSamplesNum = 1>
+class TypedSubscriber : public dds::DDSSerializedSubscribeHandler
+{
+public:
+
+  using SharedPtr = std::shared_ptr<TypedSubscriber>;
+
+  /// \param[in] _extended
+  ///   Subscribes to samples of the extended type of the message, see
+  ///   MessageTraits.
+  TypedSubscriber(
+      const dds_entity_t& _participant,
+      const std::string& _topic_name,
+      dds::Qos _qos,
+      bool _extended) :
+    dds::DDSSerializedSubscribeHandler(
+        _participant, messages::MessageTraits<Message>::descriptor(_extended),
+        _topic_name, false, "", _qos),
+    extended(_extended)
+  {}
+
+  bool is_extended() const
+  {
+    return extended;
+  }
+
+private:
+
+  bool extended;
+};
+
+template<typename Message>
+typename TypedPublisher<Message>::SharedPtr make_publisher(
+    const dds_entity_t& _participant,
+    const std::string& _topic_name,
+    dds::Qos _qos = dds::Qos::BestEffort,
+    bool _extended = false)
+{
+  return std::make_shared<TypedPublisher<Message>>(
+      _participant, _topic_name, _qos, _extended);
+}
+
+template<typename Message, std::size_t MaxSamplesNum = 1>
+typename TypedSubscriber<Message, MaxSamplesNum>::SharedPtr make_subscriber(
+    const dds_entity_t& _participant,
+    const std::string& _topic_name,
+    dds::Qos _qos = dds::Qos::BestEffort,
+    bool _extended = false)
+{
+  return std::make_shared<TypedSubscriber<Message, MaxSamplesNum>>(
+      _participant, _topic_name, _qos, _extended);
+}
+
+/// Makes the publisher of a message sent as samples of its generated DDS
+/// type, see MessageTraits.
+template<typename Sample>
+typename dds::DDSPublishHandler<Sample>::SharedPtr make_sample_publisher(
+    const dds_entity_t& _participant,
+    const std::string& _topic_name,
+    dds::Qos _qos = dds::Qos::BestEffort)
+{
+  return std::make_shared<dds::DDSPublishHandler<Sample>>(
+      _participant, messages::MessageTraits<Sample>::descriptor(),
+      _topic_name, _qos);
+}
+
+template<typename Sample, std::size_t MaxSamplesNum = 1>
+typename dds::DDSSubscribeHandler<Sample, MaxSamplesNum>::SharedPtr
+make_sample_subscriber(
+    const dds_entity_t& _participant,
+    const std::string& _topic_name,
+    dds::Qos _qos = dds::Qos::BestEffort)
+{
+  return std::make_shared<dds::DDSSubscribeHandler<Sample, MaxSamplesNum>>(
+      _participant, messages::MessageTraits<Sample>::descriptor(),
+      _topic_name, _qos);
+}
+
+/// Serializes a message, writes it with the write function and counts it in
+/// the topic metrics. The serialized sample is built in a buffer reused by
+/// every message of the calling thread.
+///
+/// \param[in] _extended
+///   Serializes the message as its extended type, which must match the type
+///   of the publishers it is written with.
+/// \param[in] _write
+///   Called with the serialized sample and its size, returns true if it was
+///   written, for example to route it to one of several publishers.
+/// \return
+///   True if the message was written, false otherwise.
+template<typename Message, typename WriteFn>
+bool publish(
+    const Message& _message,
+    bool _extended,
+    bool _compress,
+    TopicMetrics& _topic_metrics,
+    WriteFn&& _write)
+{
+  using Traits = messages::MessageTraits<Message>;
+  thread_local std::vector<uint8_t> data;
+
+  const auto start_time = TopicMetrics::Clock::now();
+  Traits::serialize(_message, _extended, _compress, data);
+  _topic_metrics.observe_conversion(start_time);
+  const bool sent = _write(data.data(), data.size());
+
+  if (sent)
+  {
+    // The metrics count the payload, without the encapsulation header
+    _topic_metrics.samples->increment();
+    _topic_metrics.bytes->increment(data.size() - 4);
+  }
+  else
+    _topic_metrics.drops->increment();
+  return sent;
+}
+
+/// Same as above, writing the message with a single publisher.
+template<typename Message>
+bool publish(
+    TypedPublisher<Message>& _publisher,
+    const Message& _message,
+    bool _compress,
+    TopicMetrics& _topic_metrics)
+{
+  return publish(
+      _message, _publisher.is_extended(), _compress, _topic_metrics,
+      [&_publisher](const uint8_t* _data, std::size_t _size)
+      {
+        return _publisher.write(_data, _size);
+      });
+}
+
+/// Takes the first available sample of a subscriber, deserializes it in
+/// place and counts it in the topic metrics, along with the samples the
+/// reader dropped. Malformed samples are counted as dropped and skipped.
+///
+/// \param[out] _message
+///   Deserialized message, only meaningful when true is returned.
+/// \param[out] _sample_info
+///   Sample info of the message when not null.
+/// \return
+///   True if a message was taken, false otherwise.
+template<typename Message, std::size_t MaxSamplesNum>
+bool take(
+    TypedSubscriber<Message, MaxSamplesNum>& _subscriber,
+    TopicMetrics& _topic_metrics,
+    Message& _message,
+    dds_sample_info_t* _sample_info = nullptr)
+{
+  using Traits = messages::MessageTraits<Message>;
+  thread_local std::vector<uint8_t> data;
+
+  _topic_metrics.drops->increment(_subscriber.get_dropped_samples_num());
+
+  dds_sample_info_t sample_info;
+  while (_subscriber.take(data, sample_info))
+  {
+    const auto start_time = TopicMetrics::Clock::now();
+    if (!Traits::deserialize(
+        data.data(), data.size(), _subscriber.is_extended(), _message))
+    {
+      _topic_metrics.drops->increment();
+      continue;
+    }
+    _topic_metrics.observe_conversion(start_time);
+    _topic_metrics.samples->increment();
+    _topic_metrics.bytes->increment(data.size() - 4);
+    if (_sample_info)
+      *_sample_info = sample_info;
+    return true;
+  }
+  return false;
+}
+
+/// Takes up to MaxSamplesNum samples of a subscriber, deserializes them and
+/// appends them to the messages, counting them in the topic metrics.
+///
+/// \return
+///   Number of messages appended.
+template<typename Message, std::size_t MaxSamplesNum>
+std::size_t take(
+    TypedSubscriber<Message, MaxSamplesNum>& _subscriber,
+    TopicMetrics& _topic_metrics,
+    std::vector<Message>& _messages)
+{
+  using Traits = messages::MessageTraits<Message>;
+  thread_local std::vector<uint8_t> data;
+
+  _topic_metrics.drops->increment(_subscriber.get_dropped_samples_num());
+
+  std::size_t taken_num = 0;
+  dds_sample_info_t sample_info;
+  while (taken_num < MaxSamplesNum && _subscriber.take(data, sample_info))
+  {
+    const auto start_time = TopicMetrics::Clock::now();
+    _messages.emplace_back();
+    if (!Traits::deserialize(
+        data.data(), data.size(), _subscriber.is_extended(),
+        _messages.back()))
+    {
+      _messages.pop_back();
+      _topic_metrics.drops->increment();
+      continue;
+    }
+    _topic_metrics.observe_conversion(start_time);
+    _topic_metrics.samples->increment();
+    _topic_metrics.bytes->increment(data.size() - 4);
+    ++taken_num;
+  }
+  return taken_num;
+}
+
+/// Converts a message to a sample of its generated DDS type with the given
+/// context, writes it and counts it in the topic metrics.
+///
+/// \return
+///   True if the message was written, false otherwise.
+template<typename Sample, typename Message, typename... Context>
+bool publish(
+    dds::DDSPublishHandler<Sample>& _publisher,
+    const Message& _message,
+    bool _compress,
+    TopicMetrics& _topic_metrics,
+    Context&... _context)
+{
+  using Traits = messages::MessageTraits<Sample>;
+
+  const auto start_time = TopicMetrics::Clock::now();
+  Sample sample = {};
+  Traits::convert(_message, _compress, sample, _context...);
+  _topic_metrics.observe_conversion(start_time);
+  const bool sent = _publisher.write(&sample);
+
+  if (sent)
+  {
+    _topic_metrics.samples->increment();
+    _topic_metrics.bytes->increment(Traits::get_serialized_size(sample));
+  }
+  else
+    _topic_metrics.drops->increment();
+  dds_sample_free(&sample, Traits::descriptor(), DDS_FREE_CONTENTS);
+  return sent;
+}
+
+/// Takes every available sample of a subscriber of a generated DDS type,
+/// converts them with the given context and appends the messages they carry,
+/// counting them in the topic metrics. Samples that fail to convert are
+/// counted as dropped and skipped.
+///
+/// \param[out] _sample_infos
+///   Sample info of every message appended, in the same order, when not
+///   null.
+/// \return
+///   Number of messages appended.
+template<
+  typename Sample, std::size_t MaxSamplesNum, typename Message,
+  typename... Context>
+std::size_t take(
+    dds::DDSSubscribeHandler<Sample, MaxSamplesNum>& _subscriber,
+    TopicMetrics& _topic_metrics,
+    std::vector<Message>& _messages,
+    std::vector<dds_sample_info_t>* _sample_infos,
+    Context&... _context)
+{
+  using Traits = messages::MessageTraits<Sample>;
+
+  _topic_metrics.drops->increment(_subscriber.get_dropped_samples_num());
+
+  const std::size_t begin = _messages.size();
+  std::vector<dds_sample_info_t> infos;
+  while (true)
+  {
+    const auto samples = _subscriber.read(infos);
+    if (samples.empty())
+      break;
+
+    for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+      const auto start_time = TopicMetrics::Clock::now();
+      const std::size_t message_num = _messages.size();
+      if (!Traits::convert(*samples[i], _messages, _context...))
+      {
+        _topic_metrics.drops->increment();
+        continue;
+      }
+      _topic_metrics.observe_conversion(start_time);
+      _topic_metrics.samples->increment();
+      _topic_metrics.bytes->increment(
+          Traits::get_serialized_size(*samples[i]));
+      if (_sample_infos)
+        _sample_infos->insert(
+            _sample_infos->end(), _messages.size() - message_num, infos[i]);
+    }
+  }
+  return _messages.size() - begin;
+}
+
+} // namespace free_fleet
+
+#endif // FREE_FLEET__SRC__TYPEDTOPICS_HPP
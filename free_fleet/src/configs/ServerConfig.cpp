@@ -25,12 +25,42 @@ void ServerConfig::print_config() const
 {
   printf("SERVER-CLIENT DDS CONFIGURATION\n");
   printf("  dds domain: %d\n", dds_domain);
+  printf("  dds extra domains:");
+  for (int domain : dds_extra_domains)
+    printf(" %d", domain);
+  printf("\n");
+  printf("  dds shared memory: %s\n", dds_shared_memory ? "true" : "false");
+  printf("  request ack timeout: %.2f\n", request_ack_timeout);
+  printf("  request max retransmissions: %d\n", request_max_retransmissions);
   printf("  TOPICS\n");
   printf("    robot state: %s\n", dds_robot_state_topic.c_str());
   printf("    mode request: %s\n", dds_mode_request_topic.c_str());
   printf("    path request: %s\n", dds_path_request_topic.c_str());
   printf("    destination request: %s\n", 
       dds_destination_request_topic.c_str());
+  printf("  COMPRESS PATHS: %s\n", dds_compress_paths ? "true" : "false");
+  printf("    extended robot state: %s\n",
+      dds_extended_robot_state_topic.c_str());
+  printf("    extended path request: %s\n",
+      dds_extended_path_request_topic.c_str());
+  printf("  TRACE REQUESTS: %s\n", dds_trace_requests ? "true" : "false");
+  printf("    extended mode request: %s\n",
+      dds_extended_mode_request_topic.c_str());
+  printf("    extended destination request: %s\n",
+      dds_extended_destination_request_topic.c_str());
+  printf("  COMPACT ROBOT STATE: %s\n",
+      dds_compact_robot_state ? "true" : "false");
+  printf("    compact robot state: %s\n",
+      dds_compact_robot_state_topic.c_str());
+  printf("    name registry: %s\n", dds_name_registry_topic.c_str());
+  printf("  PRIORITY MODE REQUEST: %s\n",
+      dds_priority_mode_request ? "true" : "false");
+  printf("    priority mode request: %s\n",
+      dds_priority_mode_request_topic.c_str());
+  printf("  FLEET PATH REQUEST: %s\n",
+      dds_fleet_path_request ? "true" : "false");
+  printf("    fleet path request: %s\n",
+      dds_fleet_path_request_topic.c_str());
 }
 
 } // namespace free_fleet
@@ -22,6 +22,8 @@
 
 #include <dds/dds.h>
 
+#include "Qos.hpp"
+
 namespace free_fleet {
 namespace dds {
 
@@ -46,10 +48,13 @@ private:
 
 public:
 
+  /// \param[in] _qos
+  ///   Quality of service of the topic, see Qos.
   DDSPublishHandler(
       const dds_entity_t& _participant,
       const dds_topic_descriptor_t* _topic_desc,
-      const std::string& _topic_name) :
+      const std::string& _topic_name,
+      Qos _qos = Qos::BestEffort) :
     topic_desc(_topic_desc)
   {
     ready = false;
@@ -62,8 +67,7 @@ public:
       return;
     }
 
-    dds_qos_t* qos = dds_create_qos();
-    dds_qset_reliability(qos, DDS_RELIABILITY_BEST_EFFORT, 0);
+    dds_qos_t* qos = create_qos(_qos);
     writer = dds_create_writer(_participant, topic, qos, NULL);
     if (writer < 0)
     {
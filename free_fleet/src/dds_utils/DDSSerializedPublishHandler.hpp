@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET__SRC__DDS_UTILS__DDSSERIALIZEDPUBLISHHANDLER_HPP
+#define FREE_FLEET__SRC__DDS_UTILS__DDSSERIALIZEDPUBLISHHANDLER_HPP
+
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include <dds/dds.h>
+#include <dds/ddsi/ddsi_serdata.h>
+#include <dds/ddsi/ddsi_sertype.h>
+
+#include "Qos.hpp"
+
+namespace free_fleet {
+namespace dds {
+
+/// Publishes on a topic like DDSPublishHandler, but takes samples that are
+/// already serialized, CDR encapsulation header included, and writes them
+/// without any conversion.
+class DDSSerializedPublishHandler
+{
+public:
+
+  using SharedPtr = std::shared_ptr<DDSSerializedPublishHandler>;
+
+private:
+
+  dds_return_t return_code;
+
+  dds_entity_t topic;
+
+  dds_entity_t writer;
+
+  const struct ddsi_sertype* sertype;
+
+  bool ready;
+
+public:
+
+  /// \param[in] _partition
+  ///   Partition to publish in, the default partition when empty.
+  /// \param[in] _qos
+  ///   Quality of service of the topic, see Qos.
+  DDSSerializedPublishHandler(
+      const dds_entity_t& _participant,
+      const dds_topic_descriptor_t* _topic_desc,
+      const std::string& _topic_name,
+      const std::string& _partition = "",
+      Qos _qos = Qos::BestEffort)
+  {
+    ready = false;
+
+    topic = dds_create_topic(
+        _participant, _topic_desc, _topic_name.c_str(), NULL, NULL);
+    if (topic < 0)
+    {
+      DDS_FATAL("dds_create_topic: %s\n", dds_strretcode(-topic));
+      return;
+    }
+
+    dds_entity_t publisher = _participant;
+    if (!_partition.empty())
+    {
+      dds_qos_t* publisher_qos = dds_create_qos();
+      dds_qset_partition1(publisher_qos, _partition.c_str());
+      publisher = dds_create_publisher(_participant, publisher_qos, NULL);
+      dds_delete_qos(publisher_qos);
+      if (publisher < 0)
+      {
+        DDS_FATAL("dds_create_publisher: %s\n", dds_strretcode(-publisher));
+        return;
+      }
+    }
+
+    dds_qos_t* qos = create_qos(_qos);
+    writer = dds_create_writer(publisher, topic, qos, NULL);
+    dds_delete_qos(qos);
+    if (writer < 0)
+    {
+      DDS_FATAL("dds_create_writer: %s\n", dds_strretcode(-writer));
+      return;
+    }
+
+    return_code = dds_get_entity_sertype(writer, &sertype);
+    if (return_code != DDS_RETCODE_OK)
+    {
+      DDS_FATAL("dds_get_entity_sertype: %s\n",
+          dds_strretcode(-return_code));
+      return;
+    }
+
+    ready = true;
+  }
+
+  ~DDSSerializedPublishHandler()
+  {}
+
+  bool is_ready()
+  {
+    return ready;
+  }
+
+  /// Writes a serialized sample.
+  ///
+  /// \param[in] _data
+  ///   Serialized sample, including its CDR encapsulation header.
+  /// \param[in] _size
+  ///   Size of the serialized sample in bytes.
+  /// \return
+  ///   True if the sample was written, false otherwise.
+  bool write(const uint8_t* _data, size_t _size)
+  {
+    if (!is_ready())
+      return false;
+
+    ddsrt_iovec_t iov;
+    iov.iov_base = const_cast<uint8_t*>(_data);
+    iov.iov_len = static_cast<ddsrt_iov_len_t>(_size);
+    struct ddsi_serdata* serdata =
+        ddsi_serdata_from_ser_iov(sertype, SDK_DATA, 1, &iov, _size);
+    if (!serdata)
+    {
+      DDS_FATAL("ddsi_serdata_from_ser_iov failed\n");
+      return false;
+    }
+
+    // The writer takes over the reference to the serialized data
+    return_code = dds_writecdr(writer, serdata);
+    if (return_code != DDS_RETCODE_OK)
+    {
+      DDS_FATAL("dds_writecdr failed: %s", dds_strretcode(-return_code));
+      return false;
+    }
+    return true;
+  }
+
+};
+
+} // namespace dds
+} // namespace free_fleet
+
+#endif // FREE_FLEET__SRC__DDS_UTILS__DDSSERIALIZEDPUBLISHHANDLER_HPP
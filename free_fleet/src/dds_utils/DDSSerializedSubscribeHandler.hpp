@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET__SRC__DDS_UTILS__DDSSERIALIZEDSUBSCRIBEHANDLER_HPP
+#define FREE_FLEET__SRC__DDS_UTILS__DDSSERIALIZEDSUBSCRIBEHANDLER_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include <dds/dds.h>
+#include <dds/ddsi/ddsi_serdata.h>
+
+#include "Qos.hpp"
+
+namespace free_fleet {
+namespace dds {
+
+/// Subscribes to a topic like DDSSubscribeHandler, but hands out the samples
+/// exactly as they were serialized on the wire, CDR encapsulation header
+/// included, without ever deserializing them.
+class DDSSerializedSubscribeHandler
+{
+public:
+
+  using SharedPtr = std::shared_ptr<DDSSerializedSubscribeHandler>;
+
+private:
+
+  dds_return_t return_code;
+
+  dds_entity_t topic;
+
+  dds_entity_t reader;
+
+  bool ready;
+
+public:
+
+  /// \param[in] _keep_all
+  ///   Keeps all samples until they are taken, instead of only the latest,
+  ///   so that none are missed between two takes.
+  /// \param[in] _partition
+  ///   Partition to subscribe in, the default partition when empty.
+  /// \param[in] _qos
+  ///   Quality of service of the topic, see Qos.
+  DDSSerializedSubscribeHandler(
+      const dds_entity_t& _participant,
+      const dds_topic_descriptor_t* _topic_desc,
+      const std::string& _topic_name,
+      bool _keep_all = true,
+      const std::string& _partition = "",
+      Qos _qos = Qos::BestEffort)
+  {
+    ready = false;
+
+    topic = dds_create_topic(
+        _participant, _topic_desc, _topic_name.c_str(), NULL, NULL);
+    if (topic < 0)
+    {
+      DDS_FATAL("dds_create_topic: %s\n", dds_strretcode(-topic));
+      return;
+    }
+
+    dds_entity_t subscriber = _participant;
+    if (!_partition.empty())
+    {
+      dds_qos_t* subscriber_qos = dds_create_qos();
+      dds_qset_partition1(subscriber_qos, _partition.c_str());
+      subscriber = dds_create_subscriber(_participant, subscriber_qos, NULL);
+      dds_delete_qos(subscriber_qos);
+      if (subscriber < 0)
+      {
+        DDS_FATAL("dds_create_subscriber: %s\n",
+            dds_strretcode(-subscriber));
+        return;
+      }
+    }
+
+    dds_qos_t* qos = create_qos(_qos);
+    if (_keep_all)
+      dds_qset_history(qos, DDS_HISTORY_KEEP_ALL, 0);
+    reader = dds_create_reader(subscriber, topic, qos, NULL);
+    dds_delete_qos(qos);
+    if (reader < 0)
+    {
+      DDS_FATAL("dds_create_reader: %s\n", dds_strretcode(-reader));
+      return;
+    }
+
+    ready = true;
+  }
+
+  ~DDSSerializedSubscribeHandler()
+  {}
+
+  bool is_ready()
+  {
+    return ready;
+  }
+
+  /// Gets the reader, for example to wait on it with a read condition.
+  dds_entity_t get_reader() const
+  {
+    return reader;
+  }
+
+  /// Takes the next serialized sample, if any.
+  ///
+  /// \param[out] _data
+  ///   Serialized sample, including its CDR encapsulation header.
+  /// \param[out] _source_timestamp
+  ///   Time at which the sample was written.
+  /// \return
+  ///   True if a sample was taken, false if there are none left.
+  bool take(std::vector<uint8_t>& _data, dds_time_t& _source_timestamp)
+  {
+    dds_sample_info_t info;
+    if (!take(_data, info))
+      return false;
+    _source_timestamp = info.source_timestamp;
+    return true;
+  }
+
+  /// Same as above, while also returning the whole sample info.
+  bool take(std::vector<uint8_t>& _data, dds_sample_info_t& _sample_info)
+  {
+    if (!is_ready())
+      return false;
+
+    while (true)
+    {
+      struct ddsi_serdata* serdata = nullptr;
+      dds_sample_info_t info;
+      return_code = dds_takecdr(reader, &serdata, 1, &info, DDS_ANY_STATE);
+      if (return_code < 0)
+      {
+        DDS_FATAL("dds_takecdr: %s\n", dds_strretcode(-return_code));
+        return false;
+      }
+      if (return_code == 0)
+        return false;
+
+      // Samples without data only notify of a change of the writers' state
+      const bool valid_data = info.valid_data;
+      if (valid_data)
+      {
+        _data.resize(ddsi_serdata_size(serdata));
+        ddsi_serdata_to_ser(serdata, 0, _data.size(), _data.data());
+        _sample_info = info;
+      }
+      ddsi_serdata_unref(serdata);
+      if (valid_data)
+        return true;
+    }
+  }
+
+  /// Gets the number of samples that were lost or rejected by the reader
+  /// since the last call, for example when they arrived faster than they
+  /// were taken.
+  uint32_t get_dropped_samples_num()
+  {
+    if (!is_ready())
+      return 0;
+
+    uint32_t dropped_samples_num = 0;
+    dds_sample_lost_status_t lost_status;
+    if (dds_get_sample_lost_status(reader, &lost_status) == DDS_RETCODE_OK)
+      dropped_samples_num +=
+          static_cast<uint32_t>(lost_status.total_count_change);
+    dds_sample_rejected_status_t rejected_status;
+    if (dds_get_sample_rejected_status(reader, &rejected_status) ==
+        DDS_RETCODE_OK)
+      dropped_samples_num +=
+          static_cast<uint32_t>(rejected_status.total_count_change);
+    return dropped_samples_num;
+  }
+
+};
+
+} // namespace dds
+} // namespace free_fleet
+
+#endif // FREE_FLEET__SRC__DDS_UTILS__DDSSERIALIZEDSUBSCRIBEHANDLER_HPP
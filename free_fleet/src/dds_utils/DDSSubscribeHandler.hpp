@@ -18,11 +18,15 @@
 #ifndef FREE_FLEET__SRC__DDS_UTILS__DDSSUBSCRIBEHANDLER_HPP
 #define FREE_FLEET__SRC__DDS_UTILS__DDSSUBSCRIBEHANDLER_HPP
 
+#include <array>
 #include <memory>
 #include <vector>
+#include <cstdint>
 
 #include <dds/dds.h>
 
+#include "Qos.hpp"
+
 namespace free_fleet {
 namespace dds {
 
@@ -53,10 +57,13 @@ private:
 
 public:
 
+  /// \param[in] _qos
+  ///   Quality of service of the topic, see Qos.
   DDSSubscribeHandler(
       const dds_entity_t& _participant, 
       const dds_topic_descriptor_t* _topic_desc, 
-      const std::string& _topic_name) :
+      const std::string& _topic_name,
+      Qos _qos = Qos::BestEffort) :
     topic_desc(_topic_desc)
   {
     ready = false;
@@ -70,8 +77,7 @@ public:
       return;
     }
 
-    dds_qos_t* qos = dds_create_qos();
-    dds_qset_reliability(qos, DDS_RELIABILITY_BEST_EFFORT, 0);
+    dds_qos_t* qos = create_qos(_qos);
     reader = dds_create_reader(_participant, topic, qos, NULL);
     if (reader < 0)
     {
@@ -99,8 +105,18 @@ public:
   }
 
   std::vector<std::shared_ptr<const Message>> read()
+  {
+    std::vector<dds_sample_info_t> msg_infos;
+    return read(msg_infos);
+  }
+
+  /// Same as read(), while also returning the sample info of every valid
+  /// message, in the same order as the messages.
+  std::vector<std::shared_ptr<const Message>> read(
+      std::vector<dds_sample_info_t>& _msg_infos)
   {
     std::vector<std::shared_ptr<const Message>> msgs;
+    _msg_infos.clear();
     if (!is_ready())
       return msgs;
 
@@ -117,7 +133,10 @@ public:
       for (size_t i = 0; i < MaxSamplesNum; ++i)
       {
         if (infos[i].valid_data)
+        {
           msgs.push_back(std::shared_ptr<const Message>(shared_msgs[i]));
+          _msg_infos.push_back(infos[i]);
+        }
       }
       return msgs;
     }
@@ -125,6 +144,33 @@ public:
     return msgs;
   }
 
+  /// Gets the reader, for example to wait on it with a read condition.
+  dds_entity_t get_reader() const
+  {
+    return reader;
+  }
+
+  /// Gets the number of samples that were lost or rejected by the reader
+  /// since the last call, for example when they arrived faster than they
+  /// were taken.
+  uint32_t get_dropped_samples_num()
+  {
+    if (!is_ready())
+      return 0;
+
+    uint32_t dropped_samples_num = 0;
+    dds_sample_lost_status_t lost_status;
+    if (dds_get_sample_lost_status(reader, &lost_status) == DDS_RETCODE_OK)
+      dropped_samples_num +=
+          static_cast<uint32_t>(lost_status.total_count_change);
+    dds_sample_rejected_status_t rejected_status;
+    if (dds_get_sample_rejected_status(reader, &rejected_status) ==
+        DDS_RETCODE_OK)
+      dropped_samples_num +=
+          static_cast<uint32_t>(rejected_status.total_count_change);
+    return dropped_samples_num;
+  }
+
 };
 
 } // namespace dds
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#ifndef FREE_FLEET__SRC__DDS_UTILS__QOS_HPP
+#define FREE_FLEET__SRC__DDS_UTILS__QOS_HPP
+
+#include <dds/dds.h>
+
+namespace free_fleet {
+namespace dds {
+
+/// Quality of service of the writers and readers of a topic, both sides of a
+/// topic are expected to use the same one.
+enum class Qos
+{
+  /// Lost samples are never sent again, for samples that are soon replaced
+  /// by newer ones
+  BestEffort,
+
+  /// Samples are sent again until every matched reader received them, for
+  /// small samples that must not be lost, such as stop requests. Readers
+  /// that join later do not get earlier samples.
+  Reliable,
+
+  /// Delivers every sample reliably, including to readers that join later,
+  /// for topics that are rarely written but must never be missed.
+  Durable
+};
+
+/// Creates the DDS QoS of a writer or reader, to be deleted by the caller.
+inline dds_qos_t* create_qos(Qos _qos)
+{
+  dds_qos_t* qos = dds_create_qos();
+  switch (_qos)
+  {
+    case Qos::BestEffort:
+      dds_qset_reliability(qos, DDS_RELIABILITY_BEST_EFFORT, 0);
+      break;
+    case Qos::Reliable:
+      dds_qset_reliability(qos, DDS_RELIABILITY_RELIABLE, DDS_MSECS(100));
+      dds_qset_history(qos, DDS_HISTORY_KEEP_LAST, 16);
+      break;
+    case Qos::Durable:
+      dds_qset_reliability(qos, DDS_RELIABILITY_RELIABLE, DDS_MSECS(100));
+      dds_qset_durability(qos, DDS_DURABILITY_TRANSIENT_LOCAL);
+      dds_qset_history(qos, DDS_HISTORY_KEEP_ALL, 0);
+      break;
+  }
+  return qos;
+}
+
+} // namespace dds
+} // namespace free_fleet
+
+#endif // FREE_FLEET__SRC__DDS_UTILS__QOS_HPP
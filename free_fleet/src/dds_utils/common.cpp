@@ -17,11 +17,46 @@
 
 #include "common.hpp"
 
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+
 #include <dds/dds.h>
 
 namespace free_fleet {
 namespace common {
 
+namespace {
+
+/// Domain created with a shared memory configuration, which is deleted
+/// along with its last participant
+struct ConfiguredDomain
+{
+  dds_entity_t domain;
+  std::size_t participant_num;
+};
+
+std::mutex configured_domains_mutex;
+
+std::unordered_map<dds_domainid_t, ConfiguredDomain> configured_domains;
+
+std::string get_shared_memory_config()
+{
+  const std::string config =
+      "<CycloneDDS><Domain Id=\"any\"><SharedMemory>"
+      "<Enable>true</Enable>"
+      "</SharedMemory></Domain></CycloneDDS>";
+
+  // Cyclone merges a comma separated list of configurations in order, the
+  // same way it reads CYCLONEDDS_URI
+  const char* uri = std::getenv("CYCLONEDDS_URI");
+  if (!uri || !*uri)
+    return config;
+  return std::string(uri) + "," + config;
+}
+
+} // namespace
+
 char* dds_string_alloc_and_copy(const std::string& _str)
 {
   char* ptr = dds_string_alloc(_str.length());
@@ -32,5 +67,58 @@ char* dds_string_alloc_and_copy(const std::string& _str)
   return ptr;
 }
 
+dds_entity_t create_participant(int _domain, bool _shared_memory)
+{
+  const dds_domainid_t domain_id = static_cast<dds_domainid_t>(_domain);
+  std::unique_lock<std::mutex> lock(configured_domains_mutex);
+  auto it = configured_domains.find(domain_id);
+  if (_shared_memory && it == configured_domains.end())
+  {
+    // The domain is already configured when another participant of this
+    // process created it first, such as when running several clients
+    const std::string config = get_shared_memory_config();
+    dds_entity_t domain = dds_create_domain(domain_id, config.c_str());
+    if (domain >= 0)
+      it = configured_domains.emplace(
+          domain_id, ConfiguredDomain{domain, 0}).first;
+    else if (domain != DDS_RETCODE_PRECONDITION_NOT_MET)
+    {
+      DDS_FATAL("dds_create_domain: %s\n", dds_strretcode(-domain));
+      return domain;
+    }
+  }
+
+  dds_entity_t participant = dds_create_participant(domain_id, NULL, NULL);
+  if (it == configured_domains.end())
+    return participant;
+
+  if (participant >= 0)
+    ++it->second.participant_num;
+  else if (it->second.participant_num == 0)
+  {
+    dds_delete(it->second.domain);
+    configured_domains.erase(it);
+  }
+  return participant;
+}
+
+dds_return_t delete_participant(dds_entity_t _participant)
+{
+  dds_domainid_t domain_id;
+  dds_return_t return_code = dds_get_domainid(_participant, &domain_id);
+  if (return_code != DDS_RETCODE_OK)
+    return return_code;
+
+  std::unique_lock<std::mutex> lock(configured_domains_mutex);
+  auto it = configured_domains.find(domain_id);
+  if (it == configured_domains.end() || --it->second.participant_num > 0)
+    return dds_delete(_participant);
+
+  // Deleting the domain deletes its last participant too
+  return_code = dds_delete(it->second.domain);
+  configured_domains.erase(it);
+  return return_code;
+}
+
 } // namespace common
 } // namespace free_fleet
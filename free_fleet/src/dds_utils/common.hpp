@@ -20,11 +20,26 @@
 
 #include <string>
 
+#include <dds/dds.h>
+
 namespace free_fleet {
 namespace common {
 
 char* dds_string_alloc_and_copy(const std::string& str);
 
+/// Creates a participant on a domain. With shared memory, the domain is
+/// configured to use Cyclone's iceoryx transport between processes on the
+/// same host, which needs Cyclone built with iceoryx and RouDi running. That
+/// configuration is appended to the one given by CYCLONEDDS_URI, and only
+/// applies when no participant exists on the domain in this process yet.
+///
+/// Participants created here must be deleted with delete_participant.
+dds_entity_t create_participant(int domain, bool shared_memory);
+
+/// Deletes a participant made by create_participant, along with the domain
+/// configured for shared memory once its last participant is gone.
+dds_return_t delete_participant(dds_entity_t participant);
+
 } // namespace common
 } // namespace free_fleet
 
@@ -0,0 +1,454 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#include <string>
+#include <cstring>
+#include <utility>
+
+#include "CdrCodec.hpp"
+#include "PathCodec.hpp"
+
+namespace free_fleet {
+namespace messages {
+
+namespace {
+
+/// Size of the encapsulation header that precedes every serialized sample,
+/// primitives are aligned relative to the end of it.
+const std::size_t HeaderSize = 4;
+
+bool is_host_little_endian()
+{
+  const uint16_t probe = 1;
+  uint8_t first_byte;
+  memcpy(&first_byte, &probe, 1);
+  return first_byte == 1;
+}
+
+/// Appends the CDR encoding of primitives, strings and sequences in the byte
+/// order of the host, which the encapsulation header declares.
+class CdrWriter
+{
+public:
+
+  CdrWriter(std::vector<uint8_t>& _output) :
+    output(_output)
+  {
+    output.clear();
+    output.push_back(0x00);
+    output.push_back(is_host_little_endian() ? 0x01 : 0x00);
+    output.push_back(0x00);
+    output.push_back(0x00);
+  }
+
+  template<typename Primitive>
+  void write(Primitive _value)
+  {
+    align(sizeof(Primitive));
+    const std::size_t position = output.size();
+    output.resize(position + sizeof(Primitive));
+    memcpy(output.data() + position, &_value, sizeof(Primitive));
+  }
+
+  void write(const std::string& _input)
+  {
+    write(static_cast<uint32_t>(_input.size() + 1));
+    output.insert(output.end(), _input.begin(), _input.end());
+    output.push_back(0);
+  }
+
+  void write(const uint8_t* _data, std::size_t _size)
+  {
+    write(static_cast<uint32_t>(_size));
+    output.insert(output.end(), _data, _data + _size);
+  }
+
+  void write(const Location& _input)
+  {
+    write(_input.sec);
+    write(_input.nanosec);
+    write(_input.x);
+    write(_input.y);
+    write(_input.yaw);
+    write(_input.level_name);
+  }
+
+  void write(const std::vector<Location>& _input)
+  {
+    write(static_cast<uint32_t>(_input.size()));
+    for (const auto& location : _input)
+      write(location);
+  }
+
+  void write(const Trace& _input)
+  {
+    write(_input.id);
+    write(static_cast<uint32_t>(_input.hops.size()));
+    for (const auto& hop : _input.hops)
+    {
+      write(hop.stage);
+      write(hop.stamp);
+    }
+  }
+
+  /// Writes a path either as a sequence of locations followed by an empty
+  /// compressed path, or the other way around. The compressed path comes
+  /// later in every extended message, so only the first half is written
+  /// here.
+  void write_path(const std::vector<Location>& _input, bool _compress_path)
+  {
+    if (_compress_path)
+      write(static_cast<uint32_t>(0));
+    else
+      write(_input);
+  }
+
+  void write_compressed_path(
+      const std::vector<Location>& _input, bool _compress_path)
+  {
+    if (!_compress_path || _input.empty())
+    {
+      write(static_cast<uint32_t>(0));
+      return;
+    }
+
+    thread_local std::vector<uint8_t> encoded;
+    encode_path(_input, encoded);
+    write(encoded.data(), encoded.size());
+  }
+
+private:
+
+  void align(std::size_t _alignment)
+  {
+    const std::size_t offset = output.size() - HeaderSize;
+    const std::size_t padding = (_alignment - offset % _alignment) % _alignment;
+    output.resize(output.size() + padding, 0);
+  }
+
+  std::vector<uint8_t>& output;
+
+};
+
+/// Reads the CDR encoding written by CdrWriter, or by any other CDR writer,
+/// swapping the byte order when it differs from the host's. Every read is
+/// bounds checked, once a read fails all the following ones fail as well.
+class CdrReader
+{
+public:
+
+  CdrReader(const uint8_t* _data, std::size_t _size) :
+    data(_data),
+    size(_size)
+  {
+    if (size < HeaderSize || data[0] != 0x00 || data[1] > 0x01)
+    {
+      ok = false;
+      return;
+    }
+    swap = (data[1] == 0x01) != is_host_little_endian();
+    position = HeaderSize;
+  }
+
+  bool is_ok() const
+  {
+    return ok;
+  }
+
+  template<typename Primitive>
+  bool read(Primitive& _value)
+  {
+    if (!align(sizeof(Primitive)) || !has(sizeof(Primitive)))
+      return fail();
+
+    uint8_t bytes[sizeof(Primitive)];
+    memcpy(bytes, data + position, sizeof(Primitive));
+    if (swap)
+    {
+      for (std::size_t i = 0; i < sizeof(Primitive) / 2; ++i)
+        std::swap(bytes[i], bytes[sizeof(Primitive) - 1 - i]);
+    }
+    memcpy(&_value, bytes, sizeof(Primitive));
+    position += sizeof(Primitive);
+    return true;
+  }
+
+  bool read(std::string& _output)
+  {
+    uint32_t length;
+    if (!read(length) || !has(length))
+      return fail();
+
+    // The length includes the terminating null character
+    const std::size_t string_size = length > 0 ? length - 1 : 0;
+    _output.assign(reinterpret_cast<const char*>(data + position), string_size);
+    position += length;
+    return true;
+  }
+
+  bool read(Location& _output)
+  {
+    return read(_output.sec) &&
+        read(_output.nanosec) &&
+        read(_output.x) &&
+        read(_output.y) &&
+        read(_output.yaw) &&
+        read(_output.level_name);
+  }
+
+  /// Reads the length of a sequence, checking that its elements of at least
+  /// the minimum size fit in what is left, before anything is allocated.
+  bool read_length(uint32_t& _length, std::size_t _min_element_size)
+  {
+    if (!read(_length))
+      return false;
+    if (_length > (size - position) / _min_element_size)
+      return fail();
+    return true;
+  }
+
+  bool read(std::vector<Location>& _output)
+  {
+    // Five primitives and the length of the level name
+    uint32_t length;
+    if (!read_length(length, 24))
+      return false;
+    _output.resize(length);
+    for (auto& location : _output)
+    {
+      if (!read(location))
+        return false;
+    }
+    return true;
+  }
+
+  bool read(Trace& _output)
+  {
+    uint32_t length;
+    if (!read(_output.id) || !read_length(length, 12))
+      return false;
+    _output.hops.resize(length);
+    for (auto& hop : _output.hops)
+    {
+      if (!read(hop.stage) || !read(hop.stamp))
+        return false;
+    }
+    return true;
+  }
+
+  /// Reads a compressed path, which replaces the path read before it when it
+  /// is not empty.
+  bool read_compressed_path(std::vector<Location>& _output)
+  {
+    uint32_t length;
+    if (!read_length(length, 1))
+      return false;
+    if (length == 0)
+      return true;
+    if (!decode_path(data + position, length, _output))
+      return fail();
+    position += length;
+    return true;
+  }
+
+private:
+
+  bool has(std::size_t _bytes) const
+  {
+    return ok && size - position >= _bytes;
+  }
+
+  bool align(std::size_t _alignment)
+  {
+    const std::size_t offset = position - HeaderSize;
+    const std::size_t padding = (_alignment - offset % _alignment) % _alignment;
+    if (!has(padding))
+      return false;
+    position += padding;
+    return true;
+  }
+
+  bool fail()
+  {
+    ok = false;
+    return false;
+  }
+
+  const uint8_t* data;
+
+  std::size_t size;
+
+  std::size_t position = 0;
+
+  bool swap = false;
+
+  bool ok = true;
+
+};
+
+/// Regular layouts carry no trace, which is then left empty, as the message
+/// may be reused from an earlier read.
+bool read_trace(CdrReader& _reader, bool _extended, Trace& _output)
+{
+  if (_extended)
+    return _reader.read(_output);
+  _output = Trace();
+  return true;
+}
+
+} // namespace
+
+void serialize(
+    const RobotState& _input, bool _extended, bool _compress_path,
+    std::vector<uint8_t>& _output)
+{
+  const bool compress =
+      _extended && _compress_path && is_encodable_path(_input.path);
+  CdrWriter writer(_output);
+  writer.write(_input.name);
+  writer.write(_input.model);
+  writer.write(_input.task_id);
+  writer.write(_input.mode.mode);
+  writer.write(_input.battery_percent);
+  writer.write(_input.location);
+  writer.write_path(_input.path, compress);
+  if (_extended)
+    writer.write_compressed_path(_input.path, compress);
+}
+
+bool deserialize(
+    const uint8_t* _data, std::size_t _size, bool _extended,
+    RobotState& _output)
+{
+  CdrReader reader(_data, _size);
+  return reader.read(_output.name) &&
+      reader.read(_output.model) &&
+      reader.read(_output.task_id) &&
+      reader.read(_output.mode.mode) &&
+      reader.read(_output.battery_percent) &&
+      reader.read(_output.location) &&
+      reader.read(_output.path) &&
+      (!_extended || reader.read_compressed_path(_output.path));
+}
+
+bool deserialize_robot_name(
+    const uint8_t* _data, std::size_t _size, std::string& _output)
+{
+  CdrReader reader(_data, _size);
+  return reader.read(_output);
+}
+
+void serialize(
+    const ModeRequest& _input, bool _extended, bool,
+    std::vector<uint8_t>& _output)
+{
+  CdrWriter writer(_output);
+  writer.write(_input.fleet_name);
+  writer.write(_input.robot_name);
+  writer.write(_input.mode.mode);
+  writer.write(_input.task_id);
+  writer.write(static_cast<uint32_t>(_input.parameters.size()));
+  for (const auto& parameter : _input.parameters)
+  {
+    writer.write(parameter.name);
+    writer.write(parameter.value);
+  }
+  if (_extended)
+    writer.write(_input.trace);
+}
+
+bool deserialize(
+    const uint8_t* _data, std::size_t _size, bool _extended,
+    ModeRequest& _output)
+{
+  CdrReader reader(_data, _size);
+  uint32_t parameter_num;
+  if (!reader.read(_output.fleet_name) ||
+      !reader.read(_output.robot_name) ||
+      !reader.read(_output.mode.mode) ||
+      !reader.read(_output.task_id) ||
+      !reader.read_length(parameter_num, 8))
+    return false;
+
+  _output.parameters.resize(parameter_num);
+  for (auto& parameter : _output.parameters)
+  {
+    if (!reader.read(parameter.name) || !reader.read(parameter.value))
+      return false;
+  }
+  return read_trace(reader, _extended, _output.trace);
+}
+
+void serialize(
+    const PathRequest& _input, bool _extended, bool _compress_path,
+    std::vector<uint8_t>& _output)
+{
+  const bool compress =
+      _extended && _compress_path && is_encodable_path(_input.path);
+  CdrWriter writer(_output);
+  writer.write(_input.fleet_name);
+  writer.write(_input.robot_name);
+  writer.write_path(_input.path, compress);
+  writer.write(_input.task_id);
+  if (_extended)
+  {
+    writer.write(_input.trace);
+    writer.write_compressed_path(_input.path, compress);
+  }
+}
+
+bool deserialize(
+    const uint8_t* _data, std::size_t _size, bool _extended,
+    PathRequest& _output)
+{
+  CdrReader reader(_data, _size);
+  return reader.read(_output.fleet_name) &&
+      reader.read(_output.robot_name) &&
+      reader.read(_output.path) &&
+      reader.read(_output.task_id) &&
+      read_trace(reader, _extended, _output.trace) &&
+      (!_extended || reader.read_compressed_path(_output.path));
+}
+
+void serialize(
+    const DestinationRequest& _input, bool _extended, bool,
+    std::vector<uint8_t>& _output)
+{
+  CdrWriter writer(_output);
+  writer.write(_input.fleet_name);
+  writer.write(_input.robot_name);
+  writer.write(_input.destination);
+  writer.write(_input.task_id);
+  if (_extended)
+    writer.write(_input.trace);
+}
+
+bool deserialize(
+    const uint8_t* _data, std::size_t _size, bool _extended,
+    DestinationRequest& _output)
+{
+  CdrReader reader(_data, _size);
+  return reader.read(_output.fleet_name) &&
+      reader.read(_output.robot_name) &&
+      reader.read(_output.destination) &&
+      reader.read(_output.task_id) &&
+      read_trace(reader, _extended, _output.trace);
+}
+
+} // namespace messages
+} // namespace free_fleet
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#ifndef FREE_FLEET__SRC__MESSAGES__CDRCODEC_HPP
+#define FREE_FLEET__SRC__MESSAGES__CDRCODEC_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include <free_fleet/messages/RobotState.hpp>
+#include <free_fleet/messages/ModeRequest.hpp>
+#include <free_fleet/messages/PathRequest.hpp>
+#include <free_fleet/messages/DestinationRequest.hpp>
+
+namespace free_fleet {
+namespace messages {
+
+/// Serializes free fleet messages straight to and from the CDR encoding of
+/// their FreeFleetData types, encapsulation header included, so that they
+/// can be written and taken as serialized samples without ever building the
+/// DDS types. The encoding is the same as the one of the generated types,
+/// so either side of a topic may use either.
+///
+/// Messages are encoded with the layout of their regular type, or of their
+/// extended type when extended is true, which adds the trace of requests and
+/// the compressed form of paths. Paths are only compressed with the extended
+/// layout, and the layout of a sample is known from its topic, not from the
+/// sample itself.
+///
+/// Serializing replaces the content of the output, which is best reused
+/// between messages so that it only allocates while it grows. Deserializing
+/// assigns every field of the output, reusing its strings and vectors.
+/// Deserializing returns false if the data is truncated or malformed, the
+/// output is then left in an unspecified but valid state.
+
+void serialize(
+    const RobotState& _input, bool _extended, bool _compress_path,
+    std::vector<uint8_t>& _output);
+
+bool deserialize(
+    const uint8_t* _data, std::size_t _size, bool _extended,
+    RobotState& _output);
+
+/// Reads only the name of a serialized robot state, which comes first in
+/// either layout, so that samples can be routed before they are
+/// deserialized.
+bool deserialize_robot_name(
+    const uint8_t* _data, std::size_t _size, std::string& _output);
+
+void serialize(
+    const ModeRequest& _input, bool _extended, bool _compress_path,
+    std::vector<uint8_t>& _output);
+
+bool deserialize(
+    const uint8_t* _data, std::size_t _size, bool _extended,
+    ModeRequest& _output);
+
+void serialize(
+    const PathRequest& _input, bool _extended, bool _compress_path,
+    std::vector<uint8_t>& _output);
+
+bool deserialize(
+    const uint8_t* _data, std::size_t _size, bool _extended,
+    PathRequest& _output);
+
+void serialize(
+    const DestinationRequest& _input, bool _extended, bool _compress_path,
+    std::vector<uint8_t>& _output);
+
+bool deserialize(
+    const uint8_t* _data, std::size_t _size, bool _extended,
+    DestinationRequest& _output);
+
+} // namespace messages
+} // namespace free_fleet
+
+#endif // FREE_FLEET__SRC__MESSAGES__CDRCODEC_HPP
@@ -114,6 +114,52 @@ const dds_topic_descriptor_t FreeFleetData_ModeParameter_desc =
 };
 
 
+static const uint32_t FreeFleetData_TraceHop_ops [] =
+{
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_TraceHop, stage),
+  DDS_OP_ADR | DDS_OP_TYPE_8BY, offsetof (FreeFleetData_TraceHop, stamp),
+  DDS_OP_RTS
+};
+
+const dds_topic_descriptor_t FreeFleetData_TraceHop_desc =
+{
+  sizeof (FreeFleetData_TraceHop),
+  8u,
+  DDS_TOPIC_NO_OPTIMIZE,
+  0u,
+  "FreeFleetData::TraceHop",
+  NULL,
+  3,
+  FreeFleetData_TraceHop_ops,
+  "<MetaData version=\"1.0.0\"><Module name=\"FreeFleetData\"><Struct name=\"TraceHop\"><Member name=\"stage\"><String/></Member><Member name=\"stamp\"><LongLong/></Member></Struct></Module></MetaData>"
+};
+
+
+static const uint32_t FreeFleetData_Trace_ops [] =
+{
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_Trace, id),
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_STU, offsetof (FreeFleetData_Trace, hops),
+  sizeof (FreeFleetData_TraceHop), (9u << 16u) + 4u,
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_TraceHop, stage),
+  DDS_OP_ADR | DDS_OP_TYPE_8BY, offsetof (FreeFleetData_TraceHop, stamp),
+  DDS_OP_RTS,
+  DDS_OP_RTS
+};
+
+const dds_topic_descriptor_t FreeFleetData_Trace_desc =
+{
+  sizeof (FreeFleetData_Trace),
+  8u,
+  DDS_TOPIC_NO_OPTIMIZE,
+  0u,
+  "FreeFleetData::Trace",
+  NULL,
+  7,
+  FreeFleetData_Trace_ops,
+  "<MetaData version=\"1.0.0\"><Module name=\"FreeFleetData\"><Struct name=\"TraceHop\"><Member name=\"stage\"><String/></Member><Member name=\"stamp\"><LongLong/></Member></Struct><Struct name=\"Trace\"><Member name=\"id\"><String/></Member><Member name=\"hops\"><Sequence><Type name=\"TraceHop\"/></Sequence></Member></Struct></Module></MetaData>"
+};
+
+
 static const uint32_t FreeFleetData_ModeRequest_ops [] =
 {
   DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ModeRequest, fleet_name),
@@ -199,3 +245,314 @@ const dds_topic_descriptor_t FreeFleetData_DestinationRequest_desc =
   FreeFleetData_DestinationRequest_ops,
   "<MetaData version=\"1.0.0\"><Module name=\"FreeFleetData\"><Struct name=\"Location\"><Member name=\"sec\"><Long/></Member><Member name=\"nanosec\"><ULong/></Member><Member name=\"x\"><Float/></Member><Member name=\"y\"><Float/></Member><Member name=\"yaw\"><Float/></Member><Member name=\"level_name\"><String/></Member></Struct><Struct name=\"DestinationRequest\"><Member name=\"fleet_name\"><String/></Member><Member name=\"robot_name\"><String/></Member><Member name=\"destination\"><Type name=\"Location\"/></Member><Member name=\"task_id\"><String/></Member></Struct></Module></MetaData>"
 };
+
+
+static const uint32_t FreeFleetData_NameRegistryEntry_ops [] =
+{
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_NameRegistryEntry, kind),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_NameRegistryEntry, id),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_NameRegistryEntry, name),
+  DDS_OP_RTS
+};
+
+const dds_topic_descriptor_t FreeFleetData_NameRegistryEntry_desc =
+{
+  sizeof (FreeFleetData_NameRegistryEntry),
+  sizeof (char *),
+  DDS_TOPIC_NO_OPTIMIZE,
+  0u,
+  "FreeFleetData::NameRegistryEntry",
+  NULL,
+  4,
+  FreeFleetData_NameRegistryEntry_ops,
+  "<MetaData version=\"1.0.0\"><Module name=\"FreeFleetData\"><Struct name=\"NameRegistryEntry\"><Member name=\"kind\"><ULong/></Member><Member name=\"id\"><ULong/></Member><Member name=\"name\"><String/></Member></Struct></Module></MetaData>"
+};
+
+
+static const uint32_t FreeFleetData_CompactLocation_ops [] =
+{
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactLocation, sec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactLocation, nanosec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactLocation, x),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactLocation, y),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactLocation, yaw),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactLocation, level_id),
+  DDS_OP_RTS
+};
+
+const dds_topic_descriptor_t FreeFleetData_CompactLocation_desc =
+{
+  sizeof (FreeFleetData_CompactLocation),
+  4u,
+  0u,
+  0u,
+  "FreeFleetData::CompactLocation",
+  NULL,
+  7,
+  FreeFleetData_CompactLocation_ops,
+  "<MetaData version=\"1.0.0\"><Module name=\"FreeFleetData\"><Struct name=\"CompactLocation\"><Member name=\"sec\"><Long/></Member><Member name=\"nanosec\"><ULong/></Member><Member name=\"x\"><Float/></Member><Member name=\"y\"><Float/></Member><Member name=\"yaw\"><Float/></Member><Member name=\"level_id\"><ULong/></Member></Struct></Module></MetaData>"
+};
+
+
+static const uint32_t FreeFleetData_CompactRobotState_ops [] =
+{
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactRobotState, robot_id),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactRobotState, model_id),
+  DDS_OP_ADR | DDS_OP_TYPE_BST, offsetof (FreeFleetData_CompactRobotState, task_id), 65,
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactRobotState, mode.mode),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactRobotState, battery_percent),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactRobotState, location.sec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactRobotState, location.nanosec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactRobotState, location.x),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactRobotState, location.y),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactRobotState, location.yaw),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactRobotState, location.level_id),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactRobotState, path_length),
+  DDS_OP_ADR | DDS_OP_TYPE_ARR | DDS_OP_SUBTYPE_STU, offsetof (FreeFleetData_CompactRobotState, path),
+  8, (18u << 16u) + 5u, sizeof (FreeFleetData_CompactLocation),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactLocation, sec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactLocation, nanosec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactLocation, x),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactLocation, y),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactLocation, yaw),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_CompactLocation, level_id),
+  DDS_OP_RTS,
+  DDS_OP_RTS
+};
+
+const dds_topic_descriptor_t FreeFleetData_CompactRobotState_desc =
+{
+  sizeof (FreeFleetData_CompactRobotState),
+  4u,
+  DDS_TOPIC_NO_OPTIMIZE | DDS_TOPIC_FIXED_SIZE,
+  0u,
+  "FreeFleetData::CompactRobotState",
+  NULL,
+  22,
+  FreeFleetData_CompactRobotState_ops,
+  "<MetaData version=\"1.0.0\"><Module name=\"FreeFleetData\"><Struct name=\"RobotMode\"><Member name=\"mode\"><ULong/></Member></Struct><Struct name=\"CompactLocation\"><Member name=\"sec\"><Long/></Member><Member name=\"nanosec\"><ULong/></Member><Member name=\"x\"><Float/></Member><Member name=\"y\"><Float/></Member><Member name=\"yaw\"><Float/></Member><Member name=\"level_id\"><ULong/></Member></Struct><Struct name=\"CompactRobotState\"><Member name=\"robot_id\"><ULong/></Member><Member name=\"model_id\"><ULong/></Member><Member name=\"task_id\"><String length=\"64\"/></Member><Member name=\"mode\"><Type name=\"RobotMode\"/></Member><Member name=\"battery_percent\"><Float/></Member><Member name=\"location\"><Type name=\"CompactLocation\"/></Member><Member name=\"path_length\"><ULong/></Member><Member name=\"path\"><Array size=\"8\"><Type name=\"CompactLocation\"/></Array></Member></Struct></Module></MetaData>"
+};
+
+
+static const uint32_t FreeFleetData_FleetPathRequestEntry_ops [] =
+{
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_FleetPathRequestEntry, robot_name),
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_STU, offsetof (FreeFleetData_FleetPathRequestEntry, path),
+  sizeof (FreeFleetData_Location), (17u << 16u) + 4u,
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, sec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, nanosec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, x),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, y),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, yaw),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_Location, level_name),
+  DDS_OP_RTS,
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_FleetPathRequestEntry, task_id),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_FleetPathRequestEntry, trace.id),
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_STU, offsetof (FreeFleetData_FleetPathRequestEntry, trace.hops),
+  sizeof (FreeFleetData_TraceHop), (9u << 16u) + 4u,
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_TraceHop, stage),
+  DDS_OP_ADR | DDS_OP_TYPE_8BY, offsetof (FreeFleetData_TraceHop, stamp),
+  DDS_OP_RTS,
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_1BY, offsetof (FreeFleetData_FleetPathRequestEntry, compressed_path),
+  DDS_OP_RTS
+};
+
+const dds_topic_descriptor_t FreeFleetData_FleetPathRequestEntry_desc =
+{
+  sizeof (FreeFleetData_FleetPathRequestEntry),
+  sizeof (char *),
+  DDS_TOPIC_NO_OPTIMIZE,
+  0u,
+  "FreeFleetData::FleetPathRequestEntry",
+  NULL,
+  19,
+  FreeFleetData_FleetPathRequestEntry_ops,
+  "<MetaData version=\"1.0.0\"><Module name=\"FreeFleetData\"><Struct name=\"Location\"><Member name=\"sec\"><Long/></Member><Member name=\"nanosec\"><ULong/></Member><Member name=\"x\"><Float/></Member><Member name=\"y\"><Float/></Member><Member name=\"yaw\"><Float/></Member><Member name=\"level_name\"><String/></Member></Struct><Struct name=\"TraceHop\"><Member name=\"stage\"><String/></Member><Member name=\"stamp\"><LongLong/></Member></Struct><Struct name=\"Trace\"><Member name=\"id\"><String/></Member><Member name=\"hops\"><Sequence><Type name=\"TraceHop\"/></Sequence></Member></Struct><Struct name=\"FleetPathRequestEntry\"><Member name=\"robot_name\"><String/></Member><Member name=\"path\"><Sequence><Type name=\"Location\"/></Sequence></Member><Member name=\"task_id\"><String/></Member><Member name=\"trace\"><Type name=\"Trace\"/></Member><Member name=\"compressed_path\"><Sequence><Octet/></Sequence></Member></Struct></Module></MetaData>"
+};
+
+
+static const uint32_t FreeFleetData_FleetPathRequest_ops [] =
+{
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_FleetPathRequest, fleet_name),
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_STU, offsetof (FreeFleetData_FleetPathRequest, requests),
+  sizeof (FreeFleetData_FleetPathRequestEntry), (39u << 16u) + 4u,
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_FleetPathRequestEntry, robot_name),
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_STU, offsetof (FreeFleetData_FleetPathRequestEntry, path),
+  sizeof (FreeFleetData_Location), (17u << 16u) + 4u,
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, sec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, nanosec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, x),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, y),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, yaw),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_Location, level_name),
+  DDS_OP_RTS,
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_FleetPathRequestEntry, task_id),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_FleetPathRequestEntry, trace.id),
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_STU, offsetof (FreeFleetData_FleetPathRequestEntry, trace.hops),
+  sizeof (FreeFleetData_TraceHop), (9u << 16u) + 4u,
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_TraceHop, stage),
+  DDS_OP_ADR | DDS_OP_TYPE_8BY, offsetof (FreeFleetData_TraceHop, stamp),
+  DDS_OP_RTS,
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_1BY, offsetof (FreeFleetData_FleetPathRequestEntry, compressed_path),
+  DDS_OP_RTS,
+  DDS_OP_RTS
+};
+
+const dds_topic_descriptor_t FreeFleetData_FleetPathRequest_desc =
+{
+  sizeof (FreeFleetData_FleetPathRequest),
+  sizeof (char *),
+  DDS_TOPIC_NO_OPTIMIZE,
+  0u,
+  "FreeFleetData::FleetPathRequest",
+  NULL,
+  23,
+  FreeFleetData_FleetPathRequest_ops,
+  "<MetaData version=\"1.0.0\"><Module name=\"FreeFleetData\"><Struct name=\"Location\"><Member name=\"sec\"><Long/></Member><Member name=\"nanosec\"><ULong/></Member><Member name=\"x\"><Float/></Member><Member name=\"y\"><Float/></Member><Member name=\"yaw\"><Float/></Member><Member name=\"level_name\"><String/></Member></Struct><Struct name=\"TraceHop\"><Member name=\"stage\"><String/></Member><Member name=\"stamp\"><LongLong/></Member></Struct><Struct name=\"Trace\"><Member name=\"id\"><String/></Member><Member name=\"hops\"><Sequence><Type name=\"TraceHop\"/></Sequence></Member></Struct><Struct name=\"FleetPathRequestEntry\"><Member name=\"robot_name\"><String/></Member><Member name=\"path\"><Sequence><Type name=\"Location\"/></Sequence></Member><Member name=\"task_id\"><String/></Member><Member name=\"trace\"><Type name=\"Trace\"/></Member><Member name=\"compressed_path\"><Sequence><Octet/></Sequence></Member></Struct><Struct name=\"FleetPathRequest\"><Member name=\"fleet_name\"><String/></Member><Member name=\"requests\"><Sequence><Type name=\"FleetPathRequestEntry\"/></Sequence></Member></Struct></Module></MetaData>"
+};
+
+
+static const uint32_t FreeFleetData_ExtendedRobotState_ops [] =
+{
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedRobotState, name),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedRobotState, model),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedRobotState, task_id),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_ExtendedRobotState, mode.mode),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_ExtendedRobotState, battery_percent),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_ExtendedRobotState, location.sec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_ExtendedRobotState, location.nanosec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_ExtendedRobotState, location.x),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_ExtendedRobotState, location.y),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_ExtendedRobotState, location.yaw),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedRobotState, location.level_name),
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_STU, offsetof (FreeFleetData_ExtendedRobotState, path),
+  sizeof (FreeFleetData_Location), (17u << 16u) + 4u,
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, sec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, nanosec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, x),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, y),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, yaw),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_Location, level_name),
+  DDS_OP_RTS,
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_1BY, offsetof (FreeFleetData_ExtendedRobotState, compressed_path),
+  DDS_OP_RTS
+};
+
+const dds_topic_descriptor_t FreeFleetData_ExtendedRobotState_desc =
+{
+  sizeof (FreeFleetData_ExtendedRobotState),
+  sizeof (char *),
+  DDS_TOPIC_NO_OPTIMIZE,
+  0u,
+  "FreeFleetData::ExtendedRobotState",
+  NULL,
+  22,
+  FreeFleetData_ExtendedRobotState_ops,
+  "<MetaData version=\"1.0.0\"><Module name=\"FreeFleetData\"><Struct name=\"RobotMode\"><Member name=\"mode\"><ULong/></Member></Struct><Struct name=\"Location\"><Member name=\"sec\"><Long/></Member><Member name=\"nanosec\"><ULong/></Member><Member name=\"x\"><Float/></Member><Member name=\"y\"><Float/></Member><Member name=\"yaw\"><Float/></Member><Member name=\"level_name\"><String/></Member></Struct><Struct name=\"ExtendedRobotState\"><Member name=\"name\"><String/></Member><Member name=\"model\"><String/></Member><Member name=\"task_id\"><String/></Member><Member name=\"mode\"><Type name=\"RobotMode\"/></Member><Member name=\"battery_percent\"><Float/></Member><Member name=\"location\"><Type name=\"Location\"/></Member><Member name=\"path\"><Sequence><Type name=\"Location\"/></Sequence></Member><Member name=\"compressed_path\"><Sequence><Octet/></Sequence></Member></Struct></Module></MetaData>"
+};
+
+
+static const uint32_t FreeFleetData_ExtendedPathRequest_ops [] =
+{
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedPathRequest, fleet_name),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedPathRequest, robot_name),
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_STU, offsetof (FreeFleetData_ExtendedPathRequest, path),
+  sizeof (FreeFleetData_Location), (17u << 16u) + 4u,
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, sec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, nanosec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, x),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, y),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_Location, yaw),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_Location, level_name),
+  DDS_OP_RTS,
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedPathRequest, task_id),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedPathRequest, trace.id),
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_STU, offsetof (FreeFleetData_ExtendedPathRequest, trace.hops),
+  sizeof (FreeFleetData_TraceHop), (9u << 16u) + 4u,
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_TraceHop, stage),
+  DDS_OP_ADR | DDS_OP_TYPE_8BY, offsetof (FreeFleetData_TraceHop, stamp),
+  DDS_OP_RTS,
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_1BY, offsetof (FreeFleetData_ExtendedPathRequest, compressed_path),
+  DDS_OP_RTS
+};
+
+const dds_topic_descriptor_t FreeFleetData_ExtendedPathRequest_desc =
+{
+  sizeof (FreeFleetData_ExtendedPathRequest),
+  sizeof (char *),
+  DDS_TOPIC_NO_OPTIMIZE,
+  0u,
+  "FreeFleetData::ExtendedPathRequest",
+  NULL,
+  20,
+  FreeFleetData_ExtendedPathRequest_ops,
+  "<MetaData version=\"1.0.0\"><Module name=\"FreeFleetData\"><Struct name=\"Location\"><Member name=\"sec\"><Long/></Member><Member name=\"nanosec\"><ULong/></Member><Member name=\"x\"><Float/></Member><Member name=\"y\"><Float/></Member><Member name=\"yaw\"><Float/></Member><Member name=\"level_name\"><String/></Member></Struct><Struct name=\"TraceHop\"><Member name=\"stage\"><String/></Member><Member name=\"stamp\"><LongLong/></Member></Struct><Struct name=\"Trace\"><Member name=\"id\"><String/></Member><Member name=\"hops\"><Sequence><Type name=\"TraceHop\"/></Sequence></Member></Struct><Struct name=\"ExtendedPathRequest\"><Member name=\"fleet_name\"><String/></Member><Member name=\"robot_name\"><String/></Member><Member name=\"path\"><Sequence><Type name=\"Location\"/></Sequence></Member><Member name=\"task_id\"><String/></Member><Member name=\"trace\"><Type name=\"Trace\"/></Member><Member name=\"compressed_path\"><Sequence><Octet/></Sequence></Member></Struct></Module></MetaData>"
+};
+
+
+static const uint32_t FreeFleetData_ExtendedModeRequest_ops [] =
+{
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedModeRequest, fleet_name),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedModeRequest, robot_name),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_ExtendedModeRequest, mode.mode),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedModeRequest, task_id),
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_STU, offsetof (FreeFleetData_ExtendedModeRequest, parameters),
+  sizeof (FreeFleetData_ModeParameter), (9u << 16u) + 4u,
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ModeParameter, name),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ModeParameter, value),
+  DDS_OP_RTS,
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedModeRequest, trace.id),
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_STU, offsetof (FreeFleetData_ExtendedModeRequest, trace.hops),
+  sizeof (FreeFleetData_TraceHop), (9u << 16u) + 4u,
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_TraceHop, stage),
+  DDS_OP_ADR | DDS_OP_TYPE_8BY, offsetof (FreeFleetData_TraceHop, stamp),
+  DDS_OP_RTS,
+  DDS_OP_RTS
+};
+
+const dds_topic_descriptor_t FreeFleetData_ExtendedModeRequest_desc =
+{
+  sizeof (FreeFleetData_ExtendedModeRequest),
+  sizeof (char *),
+  DDS_TOPIC_NO_OPTIMIZE,
+  0u,
+  "FreeFleetData::ExtendedModeRequest",
+  NULL,
+  16,
+  FreeFleetData_ExtendedModeRequest_ops,
+  "<MetaData version=\"1.0.0\"><Module name=\"FreeFleetData\"><Struct name=\"RobotMode\"><Member name=\"mode\"><ULong/></Member></Struct><Struct name=\"ModeParameter\"><Member name=\"name\"><String/></Member><Member name=\"value\"><String/></Member></Struct><Struct name=\"TraceHop\"><Member name=\"stage\"><String/></Member><Member name=\"stamp\"><LongLong/></Member></Struct><Struct name=\"Trace\"><Member name=\"id\"><String/></Member><Member name=\"hops\"><Sequence><Type name=\"TraceHop\"/></Sequence></Member></Struct><Struct name=\"ExtendedModeRequest\"><Member name=\"fleet_name\"><String/></Member><Member name=\"robot_name\"><String/></Member><Member name=\"mode\"><Type name=\"RobotMode\"/></Member><Member name=\"task_id\"><String/></Member><Member name=\"parameters\"><Sequence><Type name=\"ModeParameter\"/></Sequence></Member><Member name=\"trace\"><Type name=\"Trace\"/></Member></Struct></Module></MetaData>"
+};
+
+
+static const uint32_t FreeFleetData_ExtendedDestinationRequest_ops [] =
+{
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedDestinationRequest, fleet_name),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedDestinationRequest, robot_name),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_ExtendedDestinationRequest, destination.sec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_ExtendedDestinationRequest, destination.nanosec),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_ExtendedDestinationRequest, destination.x),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_ExtendedDestinationRequest, destination.y),
+  DDS_OP_ADR | DDS_OP_TYPE_4BY, offsetof (FreeFleetData_ExtendedDestinationRequest, destination.yaw),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedDestinationRequest, destination.level_name),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedDestinationRequest, task_id),
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_ExtendedDestinationRequest, trace.id),
+  DDS_OP_ADR | DDS_OP_TYPE_SEQ | DDS_OP_SUBTYPE_STU, offsetof (FreeFleetData_ExtendedDestinationRequest, trace.hops),
+  sizeof (FreeFleetData_TraceHop), (9u << 16u) + 4u,
+  DDS_OP_ADR | DDS_OP_TYPE_STR, offsetof (FreeFleetData_TraceHop, stage),
+  DDS_OP_ADR | DDS_OP_TYPE_8BY, offsetof (FreeFleetData_TraceHop, stamp),
+  DDS_OP_RTS,
+  DDS_OP_RTS
+};
+
+const dds_topic_descriptor_t FreeFleetData_ExtendedDestinationRequest_desc =
+{
+  sizeof (FreeFleetData_ExtendedDestinationRequest),
+  sizeof (char *),
+  DDS_TOPIC_NO_OPTIMIZE,
+  0u,
+  "FreeFleetData::ExtendedDestinationRequest",
+  NULL,
+  16,
+  FreeFleetData_ExtendedDestinationRequest_ops,
+  "<MetaData version=\"1.0.0\"><Module name=\"FreeFleetData\"><Struct name=\"Location\"><Member name=\"sec\"><Long/></Member><Member name=\"nanosec\"><ULong/></Member><Member name=\"x\"><Float/></Member><Member name=\"y\"><Float/></Member><Member name=\"yaw\"><Float/></Member><Member name=\"level_name\"><String/></Member></Struct><Struct name=\"TraceHop\"><Member name=\"stage\"><String/></Member><Member name=\"stamp\"><LongLong/></Member></Struct><Struct name=\"Trace\"><Member name=\"id\"><String/></Member><Member name=\"hops\"><Sequence><Type name=\"TraceHop\"/></Sequence></Member></Struct><Struct name=\"ExtendedDestinationRequest\"><Member name=\"fleet_name\"><String/></Member><Member name=\"robot_name\"><String/></Member><Member name=\"destination\"><Type name=\"Location\"/></Member><Member name=\"task_id\"><String/></Member><Member name=\"trace\"><Type name=\"Trace\"/></Member></Struct></Module></MetaData>"
+};
@@ -109,6 +109,49 @@ extern const dds_topic_descriptor_t FreeFleetData_ModeParameter_desc;
 #define FreeFleetData_ModeParameter_free(d,o) \
 dds_sample_free ((d), &FreeFleetData_ModeParameter_desc, (o))
 
+typedef struct FreeFleetData_TraceHop
+{
+  char * stage;
+  int64_t stamp;
+} FreeFleetData_TraceHop;
+
+extern const dds_topic_descriptor_t FreeFleetData_TraceHop_desc;
+
+#define FreeFleetData_TraceHop__alloc() \
+((FreeFleetData_TraceHop*) dds_alloc (sizeof (FreeFleetData_TraceHop)));
+
+#define FreeFleetData_TraceHop_free(d,o) \
+dds_sample_free ((d), &FreeFleetData_TraceHop_desc, (o))
+
+typedef struct FreeFleetData_Trace_hops_seq
+{
+  uint32_t _maximum;
+  uint32_t _length;
+  FreeFleetData_TraceHop *_buffer;
+  bool _release;
+} FreeFleetData_Trace_hops_seq;
+
+#define FreeFleetData_Trace_hops_seq__alloc() \
+((FreeFleetData_Trace_hops_seq*) dds_alloc (sizeof (FreeFleetData_Trace_hops_seq)));
+
+#define FreeFleetData_Trace_hops_seq_allocbuf(l) \
+((FreeFleetData_TraceHop *) dds_alloc ((l) * sizeof (FreeFleetData_TraceHop)))
+
+
+typedef struct FreeFleetData_Trace
+{
+  char * id;
+  FreeFleetData_Trace_hops_seq hops;
+} FreeFleetData_Trace;
+
+extern const dds_topic_descriptor_t FreeFleetData_Trace_desc;
+
+#define FreeFleetData_Trace__alloc() \
+((FreeFleetData_Trace*) dds_alloc (sizeof (FreeFleetData_Trace)));
+
+#define FreeFleetData_Trace_free(d,o) \
+dds_sample_free ((d), &FreeFleetData_Trace_desc, (o))
+
 typedef struct FreeFleetData_ModeRequest_parameters_seq
 {
   uint32_t _maximum;
@@ -189,6 +232,294 @@ extern const dds_topic_descriptor_t FreeFleetData_DestinationRequest_desc;
 #define FreeFleetData_DestinationRequest_free(d,o) \
 dds_sample_free ((d), &FreeFleetData_DestinationRequest_desc, (o))
 
+#define FreeFleetData_NameKind_Constants_ROBOT 0
+#define FreeFleetData_NameKind_Constants_MODEL 1
+#define FreeFleetData_NameKind_Constants_LEVEL 2
+
+
+typedef struct FreeFleetData_NameRegistryEntry
+{
+  uint32_t kind;
+  uint32_t id;
+  char * name;
+} FreeFleetData_NameRegistryEntry;
+
+extern const dds_topic_descriptor_t FreeFleetData_NameRegistryEntry_desc;
+
+#define FreeFleetData_NameRegistryEntry__alloc() \
+((FreeFleetData_NameRegistryEntry*) dds_alloc (sizeof (FreeFleetData_NameRegistryEntry)));
+
+#define FreeFleetData_NameRegistryEntry_free(d,o) \
+dds_sample_free ((d), &FreeFleetData_NameRegistryEntry_desc, (o))
+
+#define FreeFleetData_COMPACT_PATH_MAX_LENGTH 8
+
+
+typedef struct FreeFleetData_CompactLocation
+{
+  int32_t sec;
+  uint32_t nanosec;
+  float x;
+  float y;
+  float yaw;
+  uint32_t level_id;
+} FreeFleetData_CompactLocation;
+
+extern const dds_topic_descriptor_t FreeFleetData_CompactLocation_desc;
+
+#define FreeFleetData_CompactLocation__alloc() \
+((FreeFleetData_CompactLocation*) dds_alloc (sizeof (FreeFleetData_CompactLocation)));
+
+#define FreeFleetData_CompactLocation_free(d,o) \
+dds_sample_free ((d), &FreeFleetData_CompactLocation_desc, (o))
+
+
+typedef struct FreeFleetData_CompactRobotState
+{
+  uint32_t robot_id;
+  uint32_t model_id;
+  char task_id[65];
+  FreeFleetData_RobotMode mode;
+  float battery_percent;
+  FreeFleetData_CompactLocation location;
+  uint32_t path_length;
+  FreeFleetData_CompactLocation path[8];
+} FreeFleetData_CompactRobotState;
+
+extern const dds_topic_descriptor_t FreeFleetData_CompactRobotState_desc;
+
+#define FreeFleetData_CompactRobotState__alloc() \
+((FreeFleetData_CompactRobotState*) dds_alloc (sizeof (FreeFleetData_CompactRobotState)));
+
+#define FreeFleetData_CompactRobotState_free(d,o) \
+dds_sample_free ((d), &FreeFleetData_CompactRobotState_desc, (o))
+
+
+typedef struct FreeFleetData_FleetPathRequestEntry_path_seq
+{
+  uint32_t _maximum;
+  uint32_t _length;
+  FreeFleetData_Location *_buffer;
+  bool _release;
+} FreeFleetData_FleetPathRequestEntry_path_seq;
+
+#define FreeFleetData_FleetPathRequestEntry_path_seq__alloc() \
+((FreeFleetData_FleetPathRequestEntry_path_seq*) dds_alloc (sizeof (FreeFleetData_FleetPathRequestEntry_path_seq)));
+
+#define FreeFleetData_FleetPathRequestEntry_path_seq_allocbuf(l) \
+((FreeFleetData_Location *) dds_alloc ((l) * sizeof (FreeFleetData_Location)))
+
+
+typedef struct FreeFleetData_FleetPathRequestEntry_compressed_path_seq
+{
+  uint32_t _maximum;
+  uint32_t _length;
+  uint8_t *_buffer;
+  bool _release;
+} FreeFleetData_FleetPathRequestEntry_compressed_path_seq;
+
+#define FreeFleetData_FleetPathRequestEntry_compressed_path_seq__alloc() \
+((FreeFleetData_FleetPathRequestEntry_compressed_path_seq*) dds_alloc (sizeof (FreeFleetData_FleetPathRequestEntry_compressed_path_seq)));
+
+#define FreeFleetData_FleetPathRequestEntry_compressed_path_seq_allocbuf(l) \
+((uint8_t *) dds_alloc ((l) * sizeof (uint8_t)))
+
+
+typedef struct FreeFleetData_FleetPathRequestEntry
+{
+  char * robot_name;
+  FreeFleetData_FleetPathRequestEntry_path_seq path;
+  char * task_id;
+  FreeFleetData_Trace trace;
+  FreeFleetData_FleetPathRequestEntry_compressed_path_seq compressed_path;
+} FreeFleetData_FleetPathRequestEntry;
+
+extern const dds_topic_descriptor_t FreeFleetData_FleetPathRequestEntry_desc;
+
+#define FreeFleetData_FleetPathRequestEntry__alloc() \
+((FreeFleetData_FleetPathRequestEntry*) dds_alloc (sizeof (FreeFleetData_FleetPathRequestEntry)));
+
+#define FreeFleetData_FleetPathRequestEntry_free(d,o) \
+dds_sample_free ((d), &FreeFleetData_FleetPathRequestEntry_desc, (o))
+
+
+typedef struct FreeFleetData_FleetPathRequest_requests_seq
+{
+  uint32_t _maximum;
+  uint32_t _length;
+  FreeFleetData_FleetPathRequestEntry *_buffer;
+  bool _release;
+} FreeFleetData_FleetPathRequest_requests_seq;
+
+#define FreeFleetData_FleetPathRequest_requests_seq__alloc() \
+((FreeFleetData_FleetPathRequest_requests_seq*) dds_alloc (sizeof (FreeFleetData_FleetPathRequest_requests_seq)));
+
+#define FreeFleetData_FleetPathRequest_requests_seq_allocbuf(l) \
+((FreeFleetData_FleetPathRequestEntry *) dds_alloc ((l) * sizeof (FreeFleetData_FleetPathRequestEntry)))
+
+
+typedef struct FreeFleetData_FleetPathRequest
+{
+  char * fleet_name;
+  FreeFleetData_FleetPathRequest_requests_seq requests;
+} FreeFleetData_FleetPathRequest;
+
+extern const dds_topic_descriptor_t FreeFleetData_FleetPathRequest_desc;
+
+#define FreeFleetData_FleetPathRequest__alloc() \
+((FreeFleetData_FleetPathRequest*) dds_alloc (sizeof (FreeFleetData_FleetPathRequest)));
+
+#define FreeFleetData_FleetPathRequest_free(d,o) \
+dds_sample_free ((d), &FreeFleetData_FleetPathRequest_desc, (o))
+
+
+typedef struct FreeFleetData_ExtendedRobotState_path_seq
+{
+  uint32_t _maximum;
+  uint32_t _length;
+  FreeFleetData_Location *_buffer;
+  bool _release;
+} FreeFleetData_ExtendedRobotState_path_seq;
+
+#define FreeFleetData_ExtendedRobotState_path_seq__alloc() \
+((FreeFleetData_ExtendedRobotState_path_seq*) dds_alloc (sizeof (FreeFleetData_ExtendedRobotState_path_seq)));
+
+#define FreeFleetData_ExtendedRobotState_path_seq_allocbuf(l) \
+((FreeFleetData_Location *) dds_alloc ((l) * sizeof (FreeFleetData_Location)))
+
+typedef struct FreeFleetData_ExtendedRobotState_compressed_path_seq
+{
+  uint32_t _maximum;
+  uint32_t _length;
+  uint8_t *_buffer;
+  bool _release;
+} FreeFleetData_ExtendedRobotState_compressed_path_seq;
+
+#define FreeFleetData_ExtendedRobotState_compressed_path_seq__alloc() \
+((FreeFleetData_ExtendedRobotState_compressed_path_seq*) dds_alloc (sizeof (FreeFleetData_ExtendedRobotState_compressed_path_seq)));
+
+#define FreeFleetData_ExtendedRobotState_compressed_path_seq_allocbuf(l) \
+((uint8_t *) dds_alloc ((l) * sizeof (uint8_t)))
+
+
+typedef struct FreeFleetData_ExtendedRobotState
+{
+  char * name;
+  char * model;
+  char * task_id;
+  FreeFleetData_RobotMode mode;
+  float battery_percent;
+  FreeFleetData_Location location;
+  FreeFleetData_ExtendedRobotState_path_seq path;
+  FreeFleetData_ExtendedRobotState_compressed_path_seq compressed_path;
+} FreeFleetData_ExtendedRobotState;
+
+extern const dds_topic_descriptor_t FreeFleetData_ExtendedRobotState_desc;
+
+#define FreeFleetData_ExtendedRobotState__alloc() \
+((FreeFleetData_ExtendedRobotState*) dds_alloc (sizeof (FreeFleetData_ExtendedRobotState)));
+
+#define FreeFleetData_ExtendedRobotState_free(d,o) \
+dds_sample_free ((d), &FreeFleetData_ExtendedRobotState_desc, (o))
+
+typedef struct FreeFleetData_ExtendedPathRequest_path_seq
+{
+  uint32_t _maximum;
+  uint32_t _length;
+  FreeFleetData_Location *_buffer;
+  bool _release;
+} FreeFleetData_ExtendedPathRequest_path_seq;
+
+#define FreeFleetData_ExtendedPathRequest_path_seq__alloc() \
+((FreeFleetData_ExtendedPathRequest_path_seq*) dds_alloc (sizeof (FreeFleetData_ExtendedPathRequest_path_seq)));
+
+#define FreeFleetData_ExtendedPathRequest_path_seq_allocbuf(l) \
+((FreeFleetData_Location *) dds_alloc ((l) * sizeof (FreeFleetData_Location)))
+
+
+typedef struct FreeFleetData_ExtendedPathRequest_compressed_path_seq
+{
+  uint32_t _maximum;
+  uint32_t _length;
+  uint8_t *_buffer;
+  bool _release;
+} FreeFleetData_ExtendedPathRequest_compressed_path_seq;
+
+#define FreeFleetData_ExtendedPathRequest_compressed_path_seq__alloc() \
+((FreeFleetData_ExtendedPathRequest_compressed_path_seq*) dds_alloc (sizeof (FreeFleetData_ExtendedPathRequest_compressed_path_seq)));
+
+#define FreeFleetData_ExtendedPathRequest_compressed_path_seq_allocbuf(l) \
+((uint8_t *) dds_alloc ((l) * sizeof (uint8_t)))
+
+typedef struct FreeFleetData_ExtendedPathRequest
+{
+  char * fleet_name;
+  char * robot_name;
+  FreeFleetData_ExtendedPathRequest_path_seq path;
+  char * task_id;
+  FreeFleetData_Trace trace;
+  FreeFleetData_ExtendedPathRequest_compressed_path_seq compressed_path;
+} FreeFleetData_ExtendedPathRequest;
+
+extern const dds_topic_descriptor_t FreeFleetData_ExtendedPathRequest_desc;
+
+#define FreeFleetData_ExtendedPathRequest__alloc() \
+((FreeFleetData_ExtendedPathRequest*) dds_alloc (sizeof (FreeFleetData_ExtendedPathRequest)));
+
+#define FreeFleetData_ExtendedPathRequest_free(d,o) \
+dds_sample_free ((d), &FreeFleetData_ExtendedPathRequest_desc, (o))
+
+
+typedef struct FreeFleetData_ExtendedModeRequest_parameters_seq
+{
+  uint32_t _maximum;
+  uint32_t _length;
+  FreeFleetData_ModeParameter *_buffer;
+  bool _release;
+} FreeFleetData_ExtendedModeRequest_parameters_seq;
+
+#define FreeFleetData_ExtendedModeRequest_parameters_seq__alloc() \
+((FreeFleetData_ExtendedModeRequest_parameters_seq*) dds_alloc (sizeof (FreeFleetData_ExtendedModeRequest_parameters_seq)));
+
+#define FreeFleetData_ExtendedModeRequest_parameters_seq_allocbuf(l) \
+((FreeFleetData_ModeParameter *) dds_alloc ((l) * sizeof (FreeFleetData_ModeParameter)))
+
+
+typedef struct FreeFleetData_ExtendedModeRequest
+{
+  char * fleet_name;
+  char * robot_name;
+  FreeFleetData_RobotMode mode;
+  char * task_id;
+  FreeFleetData_ExtendedModeRequest_parameters_seq parameters;
+  FreeFleetData_Trace trace;
+} FreeFleetData_ExtendedModeRequest;
+
+extern const dds_topic_descriptor_t FreeFleetData_ExtendedModeRequest_desc;
+
+#define FreeFleetData_ExtendedModeRequest__alloc() \
+((FreeFleetData_ExtendedModeRequest*) dds_alloc (sizeof (FreeFleetData_ExtendedModeRequest)));
+
+#define FreeFleetData_ExtendedModeRequest_free(d,o) \
+dds_sample_free ((d), &FreeFleetData_ExtendedModeRequest_desc, (o))
+
+typedef struct FreeFleetData_ExtendedDestinationRequest
+{
+  char * fleet_name;
+  char * robot_name;
+  FreeFleetData_Location destination;
+  char * task_id;
+  FreeFleetData_Trace trace;
+} FreeFleetData_ExtendedDestinationRequest;
+
+extern const dds_topic_descriptor_t FreeFleetData_ExtendedDestinationRequest_desc;
+
+#define FreeFleetData_ExtendedDestinationRequest__alloc() \
+((FreeFleetData_ExtendedDestinationRequest*) dds_alloc (sizeof (FreeFleetData_ExtendedDestinationRequest)));
+
+#define FreeFleetData_ExtendedDestinationRequest_free(d,o) \
+dds_sample_free ((d), &FreeFleetData_ExtendedDestinationRequest_desc, (o))
+
 #ifdef __cplusplus
 }
 #endif
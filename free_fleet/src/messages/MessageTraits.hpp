@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#ifndef FREE_FLEET__SRC__MESSAGES__MESSAGETRAITS_HPP
+#define FREE_FLEET__SRC__MESSAGES__MESSAGETRAITS_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include <dds/dds.h>
+
+#include <free_fleet/ClientConfig.hpp>
+#include <free_fleet/ServerConfig.hpp>
+#include <free_fleet/messages/RobotState.hpp>
+#include <free_fleet/messages/ModeRequest.hpp>
+#include <free_fleet/messages/PathRequest.hpp>
+#include <free_fleet/messages/DestinationRequest.hpp>
+
+#include "FleetMessages.h"
+#include "CdrCodec.hpp"
+#include "message_utils.hpp"
+#include "../NameRegistry.hpp"
+
+namespace free_fleet {
+namespace messages {
+
+/// Maps a free fleet message to the topic descriptor of its DDS type, its
+/// CDR serialization functions, and to its topic in the server and client
+/// configurations. Every message sent over DDS specializes it, so that
+/// generic code such as publish() and take() is dispatched at compile time,
+/// and using a message that does not fails to compile.
+///
+/// Messages with an extended DDS type, which adds the trace of requests and
+/// the compressed form of paths, are sent on a separate topic when extended
+/// is true, so that peers that only know the regular type keep reading the
+/// regular topic. Messages that can compress their paths only do so with the
+/// extended type, the others ignore the compress argument.
+///
+/// Messages sent as samples of their generated DDS type instead specialize
+/// it by that type, with conversions that take whatever context they need,
+/// such as the name registry of compact robot states. Reading converts a
+/// sample into zero or more messages appended to the output, since a sample
+/// may not carry any message for the reader.
+template<typename Message>
+struct MessageTraits;
+
+template<>
+struct MessageTraits<RobotState>
+{
+  static const dds_topic_descriptor_t* descriptor(bool _extended = false)
+  {
+    return _extended ?
+        &FreeFleetData_ExtendedRobotState_desc : &FreeFleetData_RobotState_desc;
+  }
+
+  static void serialize(
+      const RobotState& _input, bool _extended, bool _compress,
+      std::vector<uint8_t>& _output)
+  {
+    messages::serialize(_input, _extended, _compress, _output);
+  }
+
+  static bool deserialize(
+      const uint8_t* _data, std::size_t _size, bool _extended,
+      RobotState& _output)
+  {
+    return messages::deserialize(_data, _size, _extended, _output);
+  }
+
+  static const std::string& topic(const ServerConfig& _config)
+  {
+    return _config.dds_robot_state_topic;
+  }
+
+  static const std::string& topic(const ClientConfig& _config)
+  {
+    return _config.dds_state_topic;
+  }
+
+  static const std::string& extended_topic(const ServerConfig& _config)
+  {
+    return _config.dds_extended_robot_state_topic;
+  }
+
+  static const std::string& extended_topic(const ClientConfig& _config)
+  {
+    return _config.dds_extended_state_topic;
+  }
+};
+
+template<>
+struct MessageTraits<ModeRequest>
+{
+  static const dds_topic_descriptor_t* descriptor(bool _extended = false)
+  {
+    return _extended ?
+        &FreeFleetData_ExtendedModeRequest_desc :
+        &FreeFleetData_ModeRequest_desc;
+  }
+
+  static void serialize(
+      const ModeRequest& _input, bool _extended, bool _compress,
+      std::vector<uint8_t>& _output)
+  {
+    messages::serialize(_input, _extended, _compress, _output);
+  }
+
+  static bool deserialize(
+      const uint8_t* _data, std::size_t _size, bool _extended,
+      ModeRequest& _output)
+  {
+    return messages::deserialize(_data, _size, _extended, _output);
+  }
+
+  static const std::string& topic(const ServerConfig& _config)
+  {
+    return _config.dds_mode_request_topic;
+  }
+
+  static const std::string& topic(const ClientConfig& _config)
+  {
+    return _config.dds_mode_request_topic;
+  }
+
+  static const std::string& extended_topic(const ServerConfig& _config)
+  {
+    return _config.dds_extended_mode_request_topic;
+  }
+
+  static const std::string& extended_topic(const ClientConfig& _config)
+  {
+    return _config.dds_extended_mode_request_topic;
+  }
+};
+
+template<>
+struct MessageTraits<PathRequest>
+{
+  static const dds_topic_descriptor_t* descriptor(bool _extended = false)
+  {
+    return _extended ?
+        &FreeFleetData_ExtendedPathRequest_desc : &FreeFleetData_PathRequest_desc;
+  }
+
+  static void serialize(
+      const PathRequest& _input, bool _extended, bool _compress,
+      std::vector<uint8_t>& _output)
+  {
+    messages::serialize(_input, _extended, _compress, _output);
+  }
+
+  static bool deserialize(
+      const uint8_t* _data, std::size_t _size, bool _extended,
+      PathRequest& _output)
+  {
+    return messages::deserialize(_data, _size, _extended, _output);
+  }
+
+  static const std::string& topic(const ServerConfig& _config)
+  {
+    return _config.dds_path_request_topic;
+  }
+
+  static const std::string& topic(const ClientConfig& _config)
+  {
+    return _config.dds_path_request_topic;
+  }
+
+  static const std::string& extended_topic(const ServerConfig& _config)
+  {
+    return _config.dds_extended_path_request_topic;
+  }
+
+  static const std::string& extended_topic(const ClientConfig& _config)
+  {
+    return _config.dds_extended_path_request_topic;
+  }
+};
+
+template<>
+struct MessageTraits<DestinationRequest>
+{
+  static const dds_topic_descriptor_t* descriptor(bool _extended = false)
+  {
+    return _extended ?
+        &FreeFleetData_ExtendedDestinationRequest_desc :
+        &FreeFleetData_DestinationRequest_desc;
+  }
+
+  static void serialize(
+      const DestinationRequest& _input, bool _extended, bool _compress,
+      std::vector<uint8_t>& _output)
+  {
+    messages::serialize(_input, _extended, _compress, _output);
+  }
+
+  static bool deserialize(
+      const uint8_t* _data, std::size_t _size, bool _extended,
+      DestinationRequest& _output)
+  {
+    return messages::deserialize(_data, _size, _extended, _output);
+  }
+
+  static const std::string& topic(const ServerConfig& _config)
+  {
+    return _config.dds_destination_request_topic;
+  }
+
+  static const std::string& topic(const ClientConfig& _config)
+  {
+    return _config.dds_destination_request_topic;
+  }
+
+  static const std::string& extended_topic(const ServerConfig& _config)
+  {
+    return _config.dds_extended_destination_request_topic;
+  }
+
+  static const std::string& extended_topic(const ClientConfig& _config)
+  {
+    return _config.dds_extended_destination_request_topic;
+  }
+};
+
+template<>
+struct MessageTraits<FreeFleetData_CompactRobotState>
+{
+  static const dds_topic_descriptor_t* descriptor()
+  {
+    return &FreeFleetData_CompactRobotState_desc;
+  }
+
+  static void convert(
+      const RobotState& _input, bool,
+      FreeFleetData_CompactRobotState& _output,
+      NameRegistry& _registry)
+  {
+    messages::convert(_input, _output, _registry);
+  }
+
+  /// \return
+  ///   False if the state refers to names that were not announced yet.
+  static bool convert(
+      const FreeFleetData_CompactRobotState& _input,
+      std::vector<RobotState>& _output,
+      const NameRegistry& _registry)
+  {
+    _output.emplace_back();
+    if (messages::convert(_input, _output.back(), _registry))
+      return true;
+    _output.pop_back();
+    return false;
+  }
+
+  static std::size_t get_serialized_size(
+      const FreeFleetData_CompactRobotState& _input)
+  {
+    return messages::get_serialized_size(_input);
+  }
+
+  static const std::string& topic(const ServerConfig& _config)
+  {
+    return _config.dds_compact_robot_state_topic;
+  }
+
+  static const std::string& topic(const ClientConfig& _config)
+  {
+    return _config.dds_compact_state_topic;
+  }
+};
+
+template<>
+struct MessageTraits<FreeFleetData_NameRegistryEntry>
+{
+  static const dds_topic_descriptor_t* descriptor()
+  {
+    return &FreeFleetData_NameRegistryEntry_desc;
+  }
+
+  static void convert(
+      const NameRegistry::Entry& _input, bool,
+      FreeFleetData_NameRegistryEntry& _output)
+  {
+    messages::convert(_input, _output);
+  }
+
+  static bool convert(
+      const FreeFleetData_NameRegistryEntry& _input,
+      std::vector<NameRegistry::Entry>& _output)
+  {
+    _output.emplace_back();
+    messages::convert(_input, _output.back());
+    return true;
+  }
+
+  static std::size_t get_serialized_size(
+      const FreeFleetData_NameRegistryEntry& _input)
+  {
+    return messages::get_serialized_size(_input);
+  }
+
+  static const std::string& topic(const ServerConfig& _config)
+  {
+    return _config.dds_name_registry_topic;
+  }
+
+  static const std::string& topic(const ClientConfig& _config)
+  {
+    return _config.dds_name_registry_topic;
+  }
+};
+
+/// Fleet path requests are written from a batch of path requests of the
+/// fleet, and read as the path request of the reader's robot.
+template<>
+struct MessageTraits<FreeFleetData_FleetPathRequest>
+{
+  static const dds_topic_descriptor_t* descriptor()
+  {
+    return &FreeFleetData_FleetPathRequest_desc;
+  }
+
+  static void convert(
+      const std::vector<const PathRequest*>& _input, bool _compress,
+      FreeFleetData_FleetPathRequest& _output,
+      const std::string& _fleet_name)
+  {
+    messages::convert(_fleet_name, _input, _output, _compress);
+  }
+
+  /// Appends nothing when the batch has no entry for the robot.
+  static bool convert(
+      const FreeFleetData_FleetPathRequest& _input,
+      std::vector<PathRequest>& _output,
+      const std::string& _robot_name)
+  {
+    _output.emplace_back();
+    if (!messages::convert(_input, _robot_name, _output.back()))
+      _output.pop_back();
+    return true;
+  }
+
+  static std::size_t get_serialized_size(
+      const FreeFleetData_FleetPathRequest& _input)
+  {
+    return messages::get_serialized_size(_input);
+  }
+
+  static const std::string& topic(const ServerConfig& _config)
+  {
+    return _config.dds_fleet_path_request_topic;
+  }
+
+  static const std::string& topic(const ClientConfig& _config)
+  {
+    return _config.dds_fleet_path_request_topic;
+  }
+};
+
+} // namespace messages
+} // namespace free_fleet
+
+#endif // FREE_FLEET__SRC__MESSAGES__MESSAGETRAITS_HPP
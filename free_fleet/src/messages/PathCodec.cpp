@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "PathCodec.hpp"
+
+namespace free_fleet {
+namespace messages {
+
+namespace {
+
+constexpr uint64_t Version = 1;
+
+constexpr double PositionResolution = 1e-3;
+
+constexpr double YawResolution = 1e-3;
+
+constexpr int64_t NanosecPerMicrosec = 1000;
+
+constexpr int64_t MicrosecPerSec = 1000000;
+
+/// Bound on quantized positions and yaws, exactly representable as doubles,
+/// which keeps every delta between two of them within an int64_t
+constexpr int64_t MaxQuantized = int64_t(1) << 52;
+
+/// Bounds on times in microseconds, those of a Location
+constexpr int64_t MinTime =
+    std::numeric_limits<int32_t>::min() * MicrosecPerSec;
+
+constexpr int64_t MaxTime =
+    (std::numeric_limits<int32_t>::max() + int64_t(1)) * MicrosecPerSec - 1;
+
+/// Appends encoded bytes to a vector
+class VectorSink
+{
+public:
+
+  VectorSink(std::vector<uint8_t>& _output) :
+    output(_output)
+  {}
+
+  void put(uint8_t _byte)
+  {
+    output.push_back(_byte);
+  }
+
+  void put(const char* _data, std::size_t _size)
+  {
+    output.insert(output.end(), _data, _data + _size);
+  }
+
+private:
+
+  std::vector<uint8_t>& output;
+
+};
+
+/// Only counts encoded bytes
+class SizeSink
+{
+public:
+
+  void put(uint8_t)
+  {
+    ++size;
+  }
+
+  void put(const char*, std::size_t _size)
+  {
+    size += _size;
+  }
+
+  std::size_t size = 0;
+
+};
+
+template<typename Sink>
+void put_varint(Sink& _sink, uint64_t _value)
+{
+  while (_value >= 0x80)
+  {
+    _sink.put(static_cast<uint8_t>(_value | 0x80));
+    _value >>= 7;
+  }
+  _sink.put(static_cast<uint8_t>(_value));
+}
+
+template<typename Sink>
+void put_signed_varint(Sink& _sink, int64_t _value)
+{
+  put_varint(_sink, (static_cast<uint64_t>(_value) << 1) ^
+      static_cast<uint64_t>(_value >> 63));
+}
+
+bool is_quantizable(float _value, double _resolution)
+{
+  return std::isfinite(_value) &&
+      std::fabs(_value / _resolution) <= static_cast<double>(MaxQuantized);
+}
+
+int64_t quantize(float _value, double _resolution)
+{
+  return static_cast<int64_t>(std::llround(_value / _resolution));
+}
+
+int64_t to_microsec(const Location& _location)
+{
+  return static_cast<int64_t>(_location.sec) * MicrosecPerSec +
+      (static_cast<int64_t>(_location.nanosec) + NanosecPerMicrosec / 2) /
+          NanosecPerMicrosec;
+}
+
+template<typename Sink>
+void encode(const std::vector<Location>& _input, Sink& _sink)
+{
+  put_varint(_sink, Version);
+  put_varint(_sink, _input.size());
+
+  int64_t time = 0;
+  int64_t x = 0;
+  int64_t y = 0;
+  int64_t yaw = 0;
+  uint64_t run_num = 0;
+  for (std::size_t i = 0; i < _input.size(); ++i)
+  {
+    const Location& location = _input[i];
+    const int64_t new_time = to_microsec(location);
+    const int64_t new_x = quantize(location.x, PositionResolution);
+    const int64_t new_y = quantize(location.y, PositionResolution);
+    const int64_t new_yaw = quantize(location.yaw, YawResolution);
+    put_signed_varint(_sink, new_time - time);
+    put_signed_varint(_sink, new_x - x);
+    put_signed_varint(_sink, new_y - y);
+    put_signed_varint(_sink, new_yaw - yaw);
+    time = new_time;
+    x = new_x;
+    y = new_y;
+    yaw = new_yaw;
+
+    if (i == 0 || location.level_name != _input[i - 1].level_name)
+      ++run_num;
+  }
+
+  put_varint(_sink, run_num);
+  std::size_t run_start = 0;
+  for (std::size_t i = 1; i <= _input.size(); ++i)
+  {
+    if (i < _input.size() &&
+        _input[i].level_name == _input[run_start].level_name)
+      continue;
+
+    const std::string& level_name = _input[run_start].level_name;
+    put_varint(_sink, i - run_start);
+    put_varint(_sink, level_name.size());
+    _sink.put(level_name.data(), level_name.size());
+    run_start = i;
+  }
+}
+
+/// Adds a decoded delta to a value, failing if either leaves the bounds
+bool accumulate(int64_t _delta, int64_t _min, int64_t _max, int64_t& _value)
+{
+  if (_delta < _min - _max || _delta > _max - _min)
+    return false;
+  _value += _delta;
+  return _value >= _min && _value <= _max;
+}
+
+/// Reads varints from a buffer, failing once on any overrun
+class Source
+{
+public:
+
+  Source(const uint8_t* _data, std::size_t _size) :
+    data(_data),
+    end(_data + _size)
+  {}
+
+  bool get_varint(uint64_t& _value)
+  {
+    _value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7)
+    {
+      if (data == end)
+        return false;
+      const uint8_t byte = *data++;
+      _value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+  }
+
+  bool get_signed_varint(int64_t& _value)
+  {
+    uint64_t value;
+    if (!get_varint(value))
+      return false;
+    _value = static_cast<int64_t>(value >> 1) ^
+        -static_cast<int64_t>(value & 1);
+    return true;
+  }
+
+  bool get_string(std::size_t _size, std::string& _value)
+  {
+    if (static_cast<std::size_t>(end - data) < _size)
+      return false;
+    _value.assign(reinterpret_cast<const char*>(data), _size);
+    data += _size;
+    return true;
+  }
+
+  std::size_t get_remaining() const
+  {
+    return static_cast<std::size_t>(end - data);
+  }
+
+private:
+
+  const uint8_t* data;
+
+  const uint8_t* end;
+
+};
+
+bool decode(
+    const uint8_t* _data, std::size_t _size, std::vector<Location>& _output)
+{
+  Source source(_data, _size);
+  uint64_t version;
+  uint64_t location_num;
+  if (!source.get_varint(version) || version != Version ||
+      !source.get_varint(location_num) ||
+      location_num > source.get_remaining())
+    return false;
+
+  _output.resize(location_num);
+  int64_t time = 0;
+  int64_t x = 0;
+  int64_t y = 0;
+  int64_t yaw = 0;
+  for (auto& location : _output)
+  {
+    int64_t time_delta, x_delta, y_delta, yaw_delta;
+    if (!source.get_signed_varint(time_delta) ||
+        !source.get_signed_varint(x_delta) ||
+        !source.get_signed_varint(y_delta) ||
+        !source.get_signed_varint(yaw_delta) ||
+        !accumulate(time_delta, MinTime, MaxTime, time) ||
+        !accumulate(x_delta, -MaxQuantized, MaxQuantized, x) ||
+        !accumulate(y_delta, -MaxQuantized, MaxQuantized, y) ||
+        !accumulate(yaw_delta, -MaxQuantized, MaxQuantized, yaw))
+      return false;
+
+    // Floor division, so that times before epoch keep a positive nanosec
+    int64_t sec = time / MicrosecPerSec;
+    if (time % MicrosecPerSec < 0)
+      --sec;
+    location.sec = static_cast<int32_t>(sec);
+    location.nanosec = static_cast<uint32_t>(
+        (time - sec * MicrosecPerSec) * NanosecPerMicrosec);
+    location.x = static_cast<float>(x * PositionResolution);
+    location.y = static_cast<float>(y * PositionResolution);
+    location.yaw = static_cast<float>(yaw * YawResolution);
+  }
+
+  uint64_t run_num;
+  if (!source.get_varint(run_num))
+    return false;
+  std::size_t index = 0;
+  std::string level_name;
+  for (uint64_t i = 0; i < run_num; ++i)
+  {
+    uint64_t run_length;
+    uint64_t name_size;
+    if (!source.get_varint(run_length) ||
+        run_length > location_num - index ||
+        !source.get_varint(name_size) ||
+        !source.get_string(name_size, level_name))
+      return false;
+    for (uint64_t j = 0; j < run_length; ++j)
+      _output[index++].level_name = level_name;
+  }
+  return index == location_num;
+}
+
+} // namespace
+
+bool is_encodable_path(const std::vector<Location>& _input)
+{
+  for (const auto& location : _input)
+  {
+    const int64_t time = to_microsec(location);
+    if (time < MinTime || time > MaxTime ||
+        !is_quantizable(location.x, PositionResolution) ||
+        !is_quantizable(location.y, PositionResolution) ||
+        !is_quantizable(location.yaw, YawResolution))
+      return false;
+  }
+  return true;
+}
+
+void encode_path(
+    const std::vector<Location>& _input, std::vector<uint8_t>& _output)
+{
+  _output.clear();
+  _output.reserve(get_encoded_path_size(_input));
+  VectorSink sink(_output);
+  encode(_input, sink);
+}
+
+std::size_t get_encoded_path_size(const std::vector<Location>& _input)
+{
+  SizeSink sink;
+  encode(_input, sink);
+  return sink.size;
+}
+
+bool decode_path(
+    const uint8_t* _data, std::size_t _size, std::vector<Location>& _output)
+{
+  if (decode(_data, _size, _output))
+    return true;
+  _output.clear();
+  return false;
+}
+
+} // namespace messages
+} // namespace free_fleet
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET__SRC__MESSAGES__PATHCODEC_HPP
+#define FREE_FLEET__SRC__MESSAGES__PATHCODEC_HPP
+
+#include <vector>
+#include <cstdint>
+
+#include <free_fleet/messages/Location.hpp>
+
+namespace free_fleet {
+namespace messages {
+
+/// Compact encoding of paths, for the compressed_path fields of extended
+/// robot states and path requests, and of fleet path requests. Positions are
+/// quantized to 1 mm, yaws to 1 mrad and times to 1 us, then delta coded
+/// between waypoints as zigzag varints, while level names are run length
+/// encoded.
+///
+/// Layout, where every integer is a varint:
+///   version, waypoint count,
+///   per waypoint: time delta, x delta, y delta, yaw delta,
+///   level run count,
+///   per level run: waypoint count, name size, name bytes.
+
+/// Checks that every waypoint of a path can be quantized, which excludes
+/// non finite values and coordinates too large for their resolution. Paths
+/// that cannot be encoded are sent uncompressed instead.
+bool is_encodable_path(const std::vector<Location>& _input);
+
+/// Encodes a path, replacing the content of the output. The path must be
+/// encodable.
+void encode_path(
+    const std::vector<Location>& _input, std::vector<uint8_t>& _output);
+
+/// Gets the size of a path once encoded, without encoding it.
+std::size_t get_encoded_path_size(const std::vector<Location>& _input);
+
+/// Decodes a path.
+///
+/// \return
+///   False if the data is truncated, not a valid encoding or decodes to
+///   values out of range, in which case the output is cleared.
+bool decode_path(
+    const uint8_t* _data, std::size_t _size, std::vector<Location>& _output);
+
+} // namespace messages
+} // namespace free_fleet
+
+#endif // FREE_FLEET__SRC__MESSAGES__PATHCODEC_HPP
@@ -15,15 +15,97 @@
  *
  */
 
+#include <cstring>
+#include <algorithm>
+
 #include <dds/dds.h>
 
 #include "../dds_utils/common.hpp"
 
+#include "PathCodec.hpp"
 #include "message_utils.hpp"
 
 namespace free_fleet {
 namespace messages {
 
+namespace {
+
+/// Accumulates the size of a CDR stream, where primitives are aligned to
+/// their own size relative to the start of the stream.
+class CdrSize
+{
+public:
+
+  std::size_t get() const
+  {
+    return size;
+  }
+
+  void add_primitive(std::size_t _primitive_size)
+  {
+    size = (size + _primitive_size - 1) / _primitive_size * _primitive_size;
+    size += _primitive_size;
+  }
+
+  void add_string(const std::string& _input)
+  {
+    add_primitive(4);
+    size += _input.size() + 1;
+  }
+
+  void add_string(const char* _input)
+  {
+    add_primitive(4);
+    size += (_input ? strlen(_input) : 0) + 1;
+  }
+
+  void add_octets(std::size_t _length)
+  {
+    add_primitive(4);
+    size += _length;
+  }
+
+private:
+
+  std::size_t size = 0;
+
+};
+
+template<typename Sequence>
+void clear_compressed_path(Sequence& _output)
+{
+  _output._maximum = 0;
+  _output._length = 0;
+  _output._buffer = nullptr;
+  _output._release = false;
+}
+
+/// Fills the octet sequence of a compressed path, left empty for empty paths
+template<typename Sequence>
+void compress_path(const std::vector<Location>& _input, Sequence& _output)
+{
+  clear_compressed_path(_output);
+  if (_input.empty())
+    return;
+
+  std::vector<uint8_t> encoded;
+  encode_path(_input, encoded);
+  _output._buffer = static_cast<uint8_t*>(dds_alloc(encoded.size()));
+  memcpy(_output._buffer, encoded.data(), encoded.size());
+  _output._maximum = static_cast<uint32_t>(encoded.size());
+  _output._length = static_cast<uint32_t>(encoded.size());
+  _output._release = true;
+}
+
+template<typename Sequence>
+void decompress_path(const Sequence& _input, std::vector<Location>& _output)
+{
+  if (_input._length > 0 && _input._buffer)
+    decode_path(_input._buffer, _input._length, _output);
+}
+
+} // namespace
+
 void convert(const RobotMode& _input, FreeFleetData_RobotMode& _output)
 {
   // Consequently, free fleet robot modes need to be ordered similarly as 
@@ -95,6 +177,170 @@ void convert(const FreeFleetData_RobotState& _input, RobotState& _output)
   }
 }
 
+void convert(
+    const RobotState& _input,
+    FreeFleetData_ExtendedRobotState& _output,
+    bool _compress_path)
+{
+  _output.name = common::dds_string_alloc_and_copy(_input.name);
+  _output.model = common::dds_string_alloc_and_copy(_input.model);
+  _output.task_id = common::dds_string_alloc_and_copy(_input.task_id);
+  convert(_input.mode, _output.mode);
+  _output.battery_percent = _input.battery_percent;
+  convert(_input.location, _output.location);
+
+  const bool compress =
+      _compress_path && is_encodable_path(_input.path);
+  size_t path_length = compress ? 0 : _input.path.size();
+  _output.path._maximum = static_cast<uint32_t>(path_length);
+  _output.path._length = static_cast<uint32_t>(path_length);
+  _output.path._buffer =
+      FreeFleetData_ExtendedRobotState_path_seq_allocbuf(path_length);
+  _output.path._release = false;
+  for (size_t i = 0; i < path_length; ++i)
+    convert(_input.path[i], _output.path._buffer[i]);
+
+  if (compress)
+    compress_path(_input.path, _output.compressed_path);
+  else
+    clear_compressed_path(_output.compressed_path);
+}
+
+void convert(
+    const FreeFleetData_ExtendedRobotState& _input, RobotState& _output)
+{
+  _output.name = std::string(_input.name);
+  _output.model = std::string(_input.model);
+  _output.task_id = std::string(_input.task_id);
+  convert(_input.mode, _output.mode);
+  _output.battery_percent = _input.battery_percent;
+  convert(_input.location, _output.location);
+
+  _output.path.clear();
+  for (uint32_t i = 0; i < _input.path._length; ++i)
+  {
+    Location tmp;
+    convert(_input.path._buffer[i], tmp);
+    _output.path.push_back(tmp);
+  }
+  decompress_path(_input.compressed_path, _output.path);
+}
+
+void convert(
+    const Location& _input,
+    FreeFleetData_CompactLocation& _output,
+    NameRegistry& _registry)
+{
+  _output.sec = _input.sec;
+  _output.nanosec = _input.nanosec;
+  _output.x = _input.x;
+  _output.y = _input.y;
+  _output.yaw = _input.yaw;
+  _output.level_id =
+      _registry.register_name(NameRegistry::Kind::Level, _input.level_name);
+}
+
+bool convert(
+    const FreeFleetData_CompactLocation& _input,
+    Location& _output,
+    const NameRegistry& _registry)
+{
+  _output.sec = _input.sec;
+  _output.nanosec = _input.nanosec;
+  _output.x = _input.x;
+  _output.y = _input.y;
+  _output.yaw = _input.yaw;
+  return _registry.get_name(
+      NameRegistry::Kind::Level, _input.level_id, _output.level_name);
+}
+
+void convert(
+    const RobotState& _input,
+    FreeFleetData_CompactRobotState& _output,
+    NameRegistry& _registry)
+{
+  _output.robot_id =
+      _registry.register_name(NameRegistry::Kind::Robot, _input.name);
+  _output.model_id =
+      _registry.register_name(NameRegistry::Kind::Model, _input.model);
+
+  const std::size_t task_id_length =
+      std::min(_input.task_id.size(), sizeof(_output.task_id) - 1);
+  memcpy(_output.task_id, _input.task_id.data(), task_id_length);
+  _output.task_id[task_id_length] = '\0';
+
+  convert(_input.mode, _output.mode);
+  _output.battery_percent = _input.battery_percent;
+  convert(_input.location, _output.location, _registry);
+
+  _output.path_length = static_cast<uint32_t>(std::min<std::size_t>(
+      _input.path.size(), FreeFleetData_COMPACT_PATH_MAX_LENGTH));
+  for (uint32_t i = 0; i < _output.path_length; ++i)
+    convert(_input.path[i], _output.path[i], _registry);
+  for (uint32_t i = _output.path_length;
+      i < FreeFleetData_COMPACT_PATH_MAX_LENGTH; ++i)
+    memset(&_output.path[i], 0, sizeof(_output.path[i]));
+}
+
+bool convert(
+    const FreeFleetData_CompactRobotState& _input,
+    RobotState& _output,
+    const NameRegistry& _registry)
+{
+  if (!_registry.get_name(
+          NameRegistry::Kind::Robot, _input.robot_id, _output.name) ||
+      !_registry.get_name(
+          NameRegistry::Kind::Model, _input.model_id, _output.model))
+    return false;
+
+  _output.task_id = std::string(
+      _input.task_id, strnlen(_input.task_id, sizeof(_input.task_id)));
+  convert(_input.mode, _output.mode);
+  _output.battery_percent = _input.battery_percent;
+  if (!convert(_input.location, _output.location, _registry))
+    return false;
+
+  const uint32_t path_length = std::min<uint32_t>(
+      _input.path_length, FreeFleetData_COMPACT_PATH_MAX_LENGTH);
+  _output.path.resize(path_length);
+  for (uint32_t i = 0; i < path_length; ++i)
+  {
+    if (!convert(_input.path[i], _output.path[i], _registry))
+      return false;
+  }
+  return true;
+}
+
+void register_names(const RobotState& _input, NameRegistry& _registry)
+{
+  _registry.register_name(NameRegistry::Kind::Robot, _input.name);
+  _registry.register_name(NameRegistry::Kind::Model, _input.model);
+  _registry.register_name(
+      NameRegistry::Kind::Level, _input.location.level_name);
+  const std::size_t path_length = std::min<std::size_t>(
+      _input.path.size(), FreeFleetData_COMPACT_PATH_MAX_LENGTH);
+  for (std::size_t i = 0; i < path_length; ++i)
+    _registry.register_name(
+        NameRegistry::Kind::Level, _input.path[i].level_name);
+}
+
+void convert(
+    const NameRegistry::Entry& _input,
+    FreeFleetData_NameRegistryEntry& _output)
+{
+  _output.kind = static_cast<uint32_t>(_input.kind);
+  _output.id = _input.id;
+  _output.name = common::dds_string_alloc_and_copy(_input.name);
+}
+
+void convert(
+    const FreeFleetData_NameRegistryEntry& _input,
+    NameRegistry::Entry& _output)
+{
+  _output.kind = static_cast<NameRegistry::Kind>(_input.kind);
+  _output.id = _input.id;
+  _output.name = std::string(_input.name);
+}
 
 void convert(const ModeParameter& _input, FreeFleetData_ModeParameter& _output)
 {
@@ -108,6 +354,43 @@ void convert(const FreeFleetData_ModeParameter& _input, ModeParameter& _output)
   _output.value = std::string(_input.value);
 }
 
+void convert(const TraceHop& _input, FreeFleetData_TraceHop& _output)
+{
+  _output.stage = common::dds_string_alloc_and_copy(_input.stage);
+  _output.stamp = _input.stamp;
+}
+
+void convert(const FreeFleetData_TraceHop& _input, TraceHop& _output)
+{
+  _output.stage = std::string(_input.stage);
+  _output.stamp = _input.stamp;
+}
+
+void convert(const Trace& _input, FreeFleetData_Trace& _output)
+{
+  _output.id = common::dds_string_alloc_and_copy(_input.id);
+
+  size_t hop_num = _input.hops.size();
+  _output.hops._maximum = static_cast<uint32_t>(hop_num);
+  _output.hops._length = static_cast<uint32_t>(hop_num);
+  _output.hops._buffer = FreeFleetData_Trace_hops_seq_allocbuf(hop_num);
+  for (size_t i = 0; i < hop_num; ++i)
+    convert(_input.hops[i], _output.hops._buffer[i]);
+}
+
+void convert(const FreeFleetData_Trace& _input, Trace& _output)
+{
+  _output.id = std::string(_input.id);
+
+  _output.hops.clear();
+  for (uint32_t i = 0; i < _input.hops._length; ++i)
+  {
+    TraceHop tmp;
+    convert(_input.hops._buffer[i], tmp);
+    _output.hops.push_back(tmp);
+  }
+}
+
 void convert(const ModeRequest& _input, FreeFleetData_ModeRequest& _output)
 {
   _output.fleet_name = common::dds_string_alloc_and_copy(_input.fleet_name);
@@ -140,6 +423,45 @@ void convert(const FreeFleetData_ModeRequest& _input, ModeRequest& _output)
   }
 }
 
+void convert(
+    const ModeRequest& _input, FreeFleetData_ExtendedModeRequest& _output)
+{
+  _output.fleet_name = common::dds_string_alloc_and_copy(_input.fleet_name);
+  _output.robot_name = common::dds_string_alloc_and_copy(_input.robot_name);
+  convert(_input.mode, _output.mode);
+  _output.task_id = common::dds_string_alloc_and_copy(_input.task_id);
+
+  size_t mode_parameter_num = _input.parameters.size();
+  _output.parameters._maximum = static_cast<uint32_t>(mode_parameter_num);
+  _output.parameters._length = static_cast<uint32_t>(mode_parameter_num);
+  _output.parameters._buffer =
+      FreeFleetData_ExtendedModeRequest_parameters_seq_allocbuf(
+          mode_parameter_num);
+  for (size_t i = 0; i < mode_parameter_num; ++i)
+    convert(_input.parameters[i], _output.parameters._buffer[i]);
+
+  convert(_input.trace, _output.trace);
+}
+
+void convert(
+    const FreeFleetData_ExtendedModeRequest& _input, ModeRequest& _output)
+{
+  _output.fleet_name = std::string(_input.fleet_name);
+  _output.robot_name = std::string(_input.robot_name);
+  convert(_input.mode, _output.mode);
+  _output.task_id = std::string(_input.task_id);
+
+  _output.parameters.clear();
+  for (uint32_t i = 0; i < _input.parameters._length; ++i)
+  {
+    ModeParameter tmp;
+    convert(_input.parameters._buffer[i], tmp);
+    _output.parameters.push_back(tmp);
+  }
+
+  convert(_input.trace, _output.trace);
+}
+
 void convert(const PathRequest& _input, FreeFleetData_PathRequest& _output)
 {
   _output.fleet_name = common::dds_string_alloc_and_copy(_input.fleet_name);
@@ -172,6 +494,123 @@ void convert(const FreeFleetData_PathRequest& _input, PathRequest& _output)
   _output.task_id = std::string(_input.task_id);
 }
 
+void convert(
+    const PathRequest& _input,
+    FreeFleetData_ExtendedPathRequest& _output,
+    bool _compress_path)
+{
+  _output.fleet_name = common::dds_string_alloc_and_copy(_input.fleet_name);
+  _output.robot_name = common::dds_string_alloc_and_copy(_input.robot_name);
+
+  const bool compress =
+      _compress_path && is_encodable_path(_input.path);
+  size_t path_length = compress ? 0 : _input.path.size();
+  _output.path._maximum = static_cast<uint32_t>(path_length);
+  _output.path._length = static_cast<uint32_t>(path_length);
+  _output.path._buffer =
+      FreeFleetData_ExtendedPathRequest_path_seq_allocbuf(path_length);
+  for (size_t i = 0; i < path_length; ++i)
+    convert(_input.path[i], _output.path._buffer[i]);
+
+  _output.task_id = common::dds_string_alloc_and_copy(_input.task_id);
+  convert(_input.trace, _output.trace);
+
+  if (compress)
+    compress_path(_input.path, _output.compressed_path);
+  else
+    clear_compressed_path(_output.compressed_path);
+}
+
+void convert(
+    const FreeFleetData_ExtendedPathRequest& _input, PathRequest& _output)
+{
+  _output.fleet_name = std::string(_input.fleet_name);
+  _output.robot_name = std::string(_input.robot_name);
+
+  _output.path.clear();
+  for (uint32_t i = 0; i < _input.path._length; ++i)
+  {
+    Location tmp;
+    convert(_input.path._buffer[i], tmp);
+    _output.path.push_back(tmp);
+  }
+  decompress_path(_input.compressed_path, _output.path);
+
+  _output.task_id = std::string(_input.task_id);
+  convert(_input.trace, _output.trace);
+}
+
+void convert(
+    const std::string& _fleet_name,
+    const std::vector<const PathRequest*>& _input,
+    FreeFleetData_FleetPathRequest& _output,
+    bool _compress_path)
+{
+  _output.fleet_name = common::dds_string_alloc_and_copy(_fleet_name);
+
+  _output.requests._maximum = static_cast<uint32_t>(_input.size());
+  _output.requests._length = static_cast<uint32_t>(_input.size());
+  _output.requests._buffer =
+      FreeFleetData_FleetPathRequest_requests_seq_allocbuf(_input.size());
+  _output.requests._release = true;
+  for (size_t i = 0; i < _input.size(); ++i)
+  {
+    const PathRequest& request = *_input[i];
+    FreeFleetData_FleetPathRequestEntry& entry = _output.requests._buffer[i];
+    entry.robot_name = common::dds_string_alloc_and_copy(request.robot_name);
+
+    const bool compress =
+        _compress_path && is_encodable_path(request.path);
+    size_t path_length = compress ? 0 : request.path.size();
+    entry.path._maximum = static_cast<uint32_t>(path_length);
+    entry.path._length = static_cast<uint32_t>(path_length);
+    entry.path._buffer =
+        FreeFleetData_FleetPathRequestEntry_path_seq_allocbuf(path_length);
+    entry.path._release = true;
+    for (size_t j = 0; j < path_length; ++j)
+      convert(request.path[j], entry.path._buffer[j]);
+
+    entry.task_id = common::dds_string_alloc_and_copy(request.task_id);
+    convert(request.trace, entry.trace);
+
+    if (compress)
+      compress_path(request.path, entry.compressed_path);
+    else
+      clear_compressed_path(entry.compressed_path);
+  }
+}
+
+bool convert(
+    const FreeFleetData_FleetPathRequest& _input,
+    const std::string& _robot_name,
+    PathRequest& _output)
+{
+  for (uint32_t i = 0; i < _input.requests._length; ++i)
+  {
+    const FreeFleetData_FleetPathRequestEntry& entry =
+        _input.requests._buffer[i];
+    if (_robot_name != entry.robot_name)
+      continue;
+
+    _output.fleet_name = std::string(_input.fleet_name);
+    _output.robot_name = std::string(entry.robot_name);
+
+    _output.path.clear();
+    for (uint32_t j = 0; j < entry.path._length; ++j)
+    {
+      Location tmp;
+      convert(entry.path._buffer[j], tmp);
+      _output.path.push_back(tmp);
+    }
+    decompress_path(entry.compressed_path, _output.path);
+
+    _output.task_id = std::string(entry.task_id);
+    convert(entry.trace, _output.trace);
+    return true;
+  }
+  return false;
+}
+
 void convert(
     const DestinationRequest& _input, 
     FreeFleetData_DestinationRequest& _output)
@@ -192,5 +631,83 @@ void convert(
   _output.task_id = std::string(_input.task_id);
 }
 
+void convert(
+    const DestinationRequest& _input,
+    FreeFleetData_ExtendedDestinationRequest& _output)
+{
+  _output.fleet_name = common::dds_string_alloc_and_copy(_input.fleet_name);
+  _output.robot_name = common::dds_string_alloc_and_copy(_input.robot_name);
+  convert(_input.destination, _output.destination);
+  _output.task_id = common::dds_string_alloc_and_copy(_input.task_id);
+  convert(_input.trace, _output.trace);
+}
+
+void convert(
+    const FreeFleetData_ExtendedDestinationRequest& _input,
+    DestinationRequest& _output)
+{
+  _output.fleet_name = std::string(_input.fleet_name);
+  _output.robot_name = std::string(_input.robot_name);
+  convert(_input.destination, _output.destination);
+  _output.task_id = std::string(_input.task_id);
+  convert(_input.trace, _output.trace);
+}
+
+std::size_t get_serialized_size(const FreeFleetData_CompactRobotState& _input)
+{
+  CdrSize size;
+  size.add_primitive(4);
+  size.add_primitive(4);
+  size.add_string(std::string(
+      _input.task_id, strnlen(_input.task_id, sizeof(_input.task_id))));
+  size.add_primitive(4);
+  size.add_primitive(4);
+  for (int i = 0; i < 6; ++i)
+    size.add_primitive(4);
+  size.add_primitive(4);
+  for (int i = 0; i < 6 * FreeFleetData_COMPACT_PATH_MAX_LENGTH; ++i)
+    size.add_primitive(4);
+  return size.get();
+}
+
+std::size_t get_serialized_size(const FreeFleetData_NameRegistryEntry& _input)
+{
+  CdrSize size;
+  size.add_primitive(4);
+  size.add_primitive(4);
+  size.add_string(_input.name);
+  return size.get();
+}
+
+std::size_t get_serialized_size(const FreeFleetData_FleetPathRequest& _input)
+{
+  CdrSize size;
+  size.add_string(_input.fleet_name);
+  size.add_primitive(4);
+  for (uint32_t i = 0; i < _input.requests._length; ++i)
+  {
+    const FreeFleetData_FleetPathRequestEntry& entry =
+        _input.requests._buffer[i];
+    size.add_string(entry.robot_name);
+    size.add_primitive(4);
+    for (uint32_t j = 0; j < entry.path._length; ++j)
+    {
+      for (int k = 0; k < 5; ++k)
+        size.add_primitive(4);
+      size.add_string(entry.path._buffer[j].level_name);
+    }
+    size.add_string(entry.task_id);
+    size.add_string(entry.trace.id);
+    size.add_primitive(4);
+    for (uint32_t j = 0; j < entry.trace.hops._length; ++j)
+    {
+      size.add_string(entry.trace.hops._buffer[j].stage);
+      size.add_primitive(8);
+    }
+    size.add_octets(entry.compressed_path._length);
+  }
+  return size.get();
+}
+
 } // namespace messages
 } // namespace free_fleet
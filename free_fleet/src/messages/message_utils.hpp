@@ -18,15 +18,21 @@
 #ifndef FREE_FLEET__SRC__MESSAGES__MESSAGE_UTILS_HPP
 #define FREE_FLEET__SRC__MESSAGES__MESSAGE_UTILS_HPP
 
+#include <string>
+#include <vector>
+
 #include <free_fleet/messages/Location.hpp>
 #include <free_fleet/messages/RobotMode.hpp>
 #include <free_fleet/messages/RobotState.hpp>
 #include <free_fleet/messages/ModeParameter.hpp>
+#include <free_fleet/messages/TraceHop.hpp>
+#include <free_fleet/messages/Trace.hpp>
 #include <free_fleet/messages/ModeRequest.hpp>
 #include <free_fleet/messages/PathRequest.hpp>
 #include <free_fleet/messages/DestinationRequest.hpp>
 
 #include "FleetMessages.h"
+#include "../NameRegistry.hpp"
 
 namespace free_fleet {
 namespace messages {
@@ -43,18 +49,67 @@ void convert(const RobotState& _input, FreeFleetData_RobotState& _output);
 
 void convert(const FreeFleetData_RobotState& _input, RobotState& _output);
 
+/// Paths are written to compressed_path instead of path when compressing,
+/// see PathCodec.hpp. Either form is read back transparently.
+void convert(
+    const RobotState& _input,
+    FreeFleetData_ExtendedRobotState& _output,
+    bool _compress_path = false);
+
+void convert(
+    const FreeFleetData_ExtendedRobotState& _input, RobotState& _output);
+
 void convert(const ModeParameter& _input, FreeFleetData_ModeParameter& _output);
 
 void convert(const FreeFleetData_ModeParameter& _input, ModeParameter& _output);
 
+void convert(const TraceHop& _input, FreeFleetData_TraceHop& _output);
+
+void convert(const FreeFleetData_TraceHop& _input, TraceHop& _output);
+
+void convert(const Trace& _input, FreeFleetData_Trace& _output);
+
+void convert(const FreeFleetData_Trace& _input, Trace& _output);
+
 void convert(const ModeRequest& _input, FreeFleetData_ModeRequest& _output);
 
 void convert(const FreeFleetData_ModeRequest& _input, ModeRequest& _output);
 
+void convert(
+    const ModeRequest& _input, FreeFleetData_ExtendedModeRequest& _output);
+
+void convert(
+    const FreeFleetData_ExtendedModeRequest& _input, ModeRequest& _output);
+
 void convert(const PathRequest& _input, FreeFleetData_PathRequest& _output);
 
 void convert(const FreeFleetData_PathRequest& _input, PathRequest& _output);
 
+void convert(
+    const PathRequest& _input,
+    FreeFleetData_ExtendedPathRequest& _output,
+    bool _compress_path = false);
+
+void convert(
+    const FreeFleetData_ExtendedPathRequest& _input, PathRequest& _output);
+
+/// Batches path requests of the same fleet into a single fleet path request,
+/// the fleet names of the requests themselves are not used.
+void convert(
+    const std::string& _fleet_name,
+    const std::vector<const PathRequest*>& _input,
+    FreeFleetData_FleetPathRequest& _output,
+    bool _compress_path = false);
+
+/// Picks the entry of a single robot out of a fleet path request.
+///
+/// \return
+///   False if the fleet path request has no entry for the robot.
+bool convert(
+    const FreeFleetData_FleetPathRequest& _input,
+    const std::string& _robot_name,
+    PathRequest& _output);
+
 void convert(
     const DestinationRequest& _input, 
     FreeFleetData_DestinationRequest& _output);
@@ -63,6 +118,60 @@ void convert(
     const FreeFleetData_DestinationRequest& _input,
     DestinationRequest& _output);
 
+void convert(
+    const DestinationRequest& _input,
+    FreeFleetData_ExtendedDestinationRequest& _output);
+
+void convert(
+    const FreeFleetData_ExtendedDestinationRequest& _input,
+    DestinationRequest& _output);
+
+/// Conversions to and from the compact robot state, which refers to robots,
+/// models and levels by their IDs in a name registry. Task IDs longer than
+/// 64 characters, and paths longer than COMPACT_PATH_MAX_LENGTH waypoints
+/// are truncated.
+void convert(
+    const Location& _input,
+    FreeFleetData_CompactLocation& _output,
+    NameRegistry& _registry);
+
+bool convert(
+    const FreeFleetData_CompactLocation& _input,
+    Location& _output,
+    const NameRegistry& _registry);
+
+void convert(
+    const RobotState& _input,
+    FreeFleetData_CompactRobotState& _output,
+    NameRegistry& _registry);
+
+/// \return
+///   False if any of the IDs is not known to the registry yet.
+bool convert(
+    const FreeFleetData_CompactRobotState& _input,
+    RobotState& _output,
+    const NameRegistry& _registry);
+
+/// Registers the names a robot state refers to once converted to a compact
+/// robot state, so that they can be announced before the state itself.
+void register_names(const RobotState& _input, NameRegistry& _registry);
+
+void convert(
+    const NameRegistry::Entry& _input,
+    FreeFleetData_NameRegistryEntry& _output);
+
+void convert(
+    const FreeFleetData_NameRegistryEntry& _input,
+    NameRegistry::Entry& _output);
+
+/// Sizes in bytes of the samples once serialized as CDR by DDS, excluding
+/// the encapsulation header.
+std::size_t get_serialized_size(const FreeFleetData_CompactRobotState& _input);
+
+std::size_t get_serialized_size(const FreeFleetData_NameRegistryEntry& _input);
+
+std::size_t get_serialized_size(const FreeFleetData_FleetPathRequest& _input);
+
 } // namespace 
 } // namespace free_fleet
 
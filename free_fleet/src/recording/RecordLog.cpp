@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cstring>
+#include <algorithm>
+
+#include "RecordLog.hpp"
+
+namespace free_fleet {
+namespace recording {
+
+namespace {
+
+constexpr char Magic[8] = {'F', 'F', 'R', 'E', 'C', 'L', 'O', 'G'};
+
+constexpr uint32_t Version = 1;
+
+constexpr uint32_t ByteOrder = 0x01020304;
+
+constexpr std::size_t Alignment = 8;
+
+std::size_t get_padded_size(std::size_t _size)
+{
+  return (_size + Alignment - 1) / Alignment * Alignment;
+}
+
+bool is_compatible(const FileHeader& _header)
+{
+  return memcmp(_header.magic, Magic, sizeof(Magic)) == 0 &&
+      _header.version == Version &&
+      _header.byte_order == ByteOrder;
+}
+
+/// Returns the offset right after the last complete and padded record of the
+/// log, skipping over the data of every record.
+long find_complete_end(FILE* _file, long _file_size)
+{
+  long end = static_cast<long>(sizeof(FileHeader));
+  RecordHeader header;
+  while (_file_size - end >= static_cast<long>(sizeof(RecordHeader)) &&
+      fseek(_file, end, SEEK_SET) == 0 &&
+      fread(&header, sizeof(header), 1, _file) == 1)
+  {
+    const long record_size = static_cast<long>(
+        sizeof(RecordHeader) + get_padded_size(header.size));
+    if (_file_size - end < record_size || header.topic >= RecordTopicNum)
+      break;
+    end += record_size;
+  }
+  return end;
+}
+
+} // namespace
+
+RecordLogWriter::SharedPtr RecordLogWriter::make(const std::string& _path)
+{
+  FILE* file = fopen(_path.c_str(), "ab+");
+  if (!file)
+    return nullptr;
+
+  FileHeader header;
+  if (fseek(file, 0, SEEK_END) != 0)
+  {
+    fclose(file);
+    return nullptr;
+  }
+  const long file_size = ftell(file);
+  if (file_size < 0)
+  {
+    fclose(file);
+    return nullptr;
+  }
+  if (file_size == 0)
+  {
+    memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.byte_order = ByteOrder;
+    if (fwrite(&header, sizeof(header), 1, file) != 1 || fflush(file) != 0)
+    {
+      fclose(file);
+      return nullptr;
+    }
+  }
+  else
+  {
+    rewind(file);
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        !is_compatible(header))
+    {
+      fclose(file);
+      return nullptr;
+    }
+
+    // A record torn by a crash is cut off, the next ones are appended in
+    // its place
+    const long end = find_complete_end(file, file_size);
+    if (end < file_size &&
+        (fflush(file) != 0 || ftruncate(fileno(file), end) != 0 ||
+        fseek(file, 0, SEEK_END) != 0))
+    {
+      fclose(file);
+      return nullptr;
+    }
+  }
+  return SharedPtr(new RecordLogWriter(file));
+}
+
+RecordLogWriter::RecordLogWriter(FILE* _file) :
+  file(_file)
+{}
+
+RecordLogWriter::~RecordLogWriter()
+{
+  fclose(file);
+}
+
+bool RecordLogWriter::append(
+    RecordTopic _topic, int64_t _stamp, const uint8_t* _data, uint32_t _size)
+{
+  static const uint8_t padding[Alignment] = {0};
+
+  RecordHeader header;
+  header.stamp = _stamp;
+  header.size = _size;
+  header.topic = static_cast<uint16_t>(_topic);
+  header.reserved = 0;
+
+  // Files opened for appending always write at the end, regardless of reads
+  const std::size_t padding_size = get_padded_size(_size) - _size;
+  return fwrite(&header, sizeof(header), 1, file) == 1 &&
+      fwrite(_data, 1, _size, file) == _size &&
+      fwrite(padding, 1, padding_size, file) == padding_size;
+}
+
+bool RecordLogWriter::flush()
+{
+  return fflush(file) == 0;
+}
+
+RecordLogReader::SharedPtr RecordLogReader::make(const std::string& _path)
+{
+  int fd = open(_path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return nullptr;
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<std::size_t>(file_stat.st_size) < sizeof(FileHeader))
+  {
+    close(fd);
+    return nullptr;
+  }
+
+  const std::size_t size = static_cast<std::size_t>(file_stat.st_size);
+  void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED)
+    return nullptr;
+
+  const uint8_t* begin = static_cast<const uint8_t*>(mapped);
+  if (!is_compatible(*reinterpret_cast<const FileHeader*>(begin)))
+  {
+    munmap(mapped, size);
+    return nullptr;
+  }
+
+  madvise(mapped, size, MADV_SEQUENTIAL);
+  return SharedPtr(new RecordLogReader(begin, size));
+}
+
+RecordLogReader::RecordLogReader(const uint8_t* _begin, std::size_t _size) :
+  begin(_begin),
+  size(_size),
+  offset(sizeof(FileHeader))
+{}
+
+RecordLogReader::~RecordLogReader()
+{
+  munmap(const_cast<uint8_t*>(begin), size);
+}
+
+bool RecordLogReader::next(Record& _record)
+{
+  if (size - offset < sizeof(RecordHeader))
+    return false;
+
+  const RecordHeader* header =
+      reinterpret_cast<const RecordHeader*>(begin + offset);
+  const std::size_t record_size =
+      sizeof(RecordHeader) + get_padded_size(header->size);
+  if (size - offset < sizeof(RecordHeader) + header->size ||
+      header->topic >= RecordTopicNum)
+    return false;
+
+  _record.topic = static_cast<RecordTopic>(header->topic);
+  _record.stamp = header->stamp;
+  _record.data = begin + offset + sizeof(RecordHeader);
+  _record.size = header->size;
+  offset = std::min(offset + record_size, size);
+  return true;
+}
+
+void RecordLogReader::rewind()
+{
+  offset = sizeof(FileHeader);
+}
+
+} // namespace recording
+} // namespace free_fleet
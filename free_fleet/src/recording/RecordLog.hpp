@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET__SRC__RECORDING__RECORDLOG_HPP
+#define FREE_FLEET__SRC__RECORDING__RECORDLOG_HPP
+
+#include <memory>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+
+namespace free_fleet {
+namespace recording {
+
+/// Topics that can be recorded, stored as a number in every record.
+enum class RecordTopic : uint16_t
+{
+  RobotState = 0,
+  ModeRequest = 1,
+  PathRequest = 2,
+  DestinationRequest = 3,
+  CompactRobotState = 4,
+  NameRegistryEntry = 5,
+  PriorityModeRequest = 6,
+  FleetPathRequest = 7,
+  ExtendedRobotState = 8,
+  ExtendedPathRequest = 9,
+  ExtendedModeRequest = 10,
+  ExtendedDestinationRequest = 11
+};
+
+constexpr std::size_t RecordTopicNum = 12;
+
+/// A record log starts with a FileHeader, followed by records which are each
+/// a RecordHeader and the serialized sample, padded to a multiple of 8 bytes
+/// so that every header stays aligned when the log is memory mapped. Records
+/// are only ever appended, a log cut short by a crash is still readable up
+/// to its last complete record, and reopening it for appending cuts off the
+/// torn record first. Everything is in the byte order of the
+/// machine that recorded it, which is checked when reading.
+struct FileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+};
+
+struct RecordHeader
+{
+  /// Time at which the sample was received, in nanoseconds since epoch
+  int64_t stamp;
+
+  /// Size of the serialized sample, excluding padding
+  uint32_t size;
+
+  uint16_t topic;
+
+  uint16_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 16, "unexpected file header padding");
+static_assert(sizeof(RecordHeader) == 16, "unexpected record header padding");
+
+class RecordLogWriter
+{
+public:
+
+  using SharedPtr = std::shared_ptr<RecordLogWriter>;
+
+  /// Opens a log for appending, creating it if it does not exist yet.
+  ///
+  /// \param[in] path
+  ///   Path of the log.
+  /// \return
+  ///   Shared pointer to the writer, nullptr if the file could not be opened
+  ///   or is not a compatible record log.
+  static SharedPtr make(const std::string& path);
+
+  /// Appends a serialized sample.
+  bool append(
+      RecordTopic topic, int64_t stamp, const uint8_t* data, uint32_t size);
+
+  /// Flushes the appended records to the file.
+  bool flush();
+
+  ~RecordLogWriter();
+
+private:
+
+  FILE* file;
+
+  RecordLogWriter(FILE* file);
+
+};
+
+class RecordLogReader
+{
+public:
+
+  using SharedPtr = std::shared_ptr<RecordLogReader>;
+
+  struct Record
+  {
+    RecordTopic topic;
+    int64_t stamp;
+
+    /// Points into the memory mapped log, valid as long as the reader is
+    const uint8_t* data;
+
+    uint32_t size;
+  };
+
+  /// Memory maps a log for reading.
+  ///
+  /// \param[in] path
+  ///   Path of the log.
+  /// \return
+  ///   Shared pointer to the reader, nullptr if the file could not be mapped
+  ///   or is not a compatible record log.
+  static SharedPtr make(const std::string& path);
+
+  /// Reads the next record.
+  ///
+  /// \param[out] record
+  ///   Next record of the log.
+  /// \return
+  ///   True if a record was read, false at the end of the log.
+  bool next(Record& record);
+
+  /// Goes back to the first record of the log.
+  void rewind();
+
+  ~RecordLogReader();
+
+private:
+
+  const uint8_t* begin;
+
+  std::size_t size;
+
+  std::size_t offset;
+
+  RecordLogReader(const uint8_t* begin, std::size_t size);
+
+};
+
+} // namespace recording
+} // namespace free_fleet
+
+#endif // FREE_FLEET__SRC__RECORDING__RECORDLOG_HPP
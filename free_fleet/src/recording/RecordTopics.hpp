@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#ifndef FREE_FLEET__SRC__RECORDING__RECORDTOPICS_HPP
+#define FREE_FLEET__SRC__RECORDING__RECORDTOPICS_HPP
+
+#include <array>
+#include <string>
+
+#include <dds/dds.h>
+
+#include <free_fleet/ServerConfig.hpp>
+
+#include "RecordLog.hpp"
+#include "../messages/FleetMessages.h"
+#include "../dds_utils/Qos.hpp"
+
+namespace free_fleet {
+namespace recording {
+
+/// DDS topic of a RecordTopic, recorded and replayed with the quality of
+/// service its writers use, so that reliable and durable topics are matched
+/// and keep their guarantees.
+struct RecordTopicInfo
+{
+  const dds_topic_descriptor_t* desc;
+  std::string topic_name;
+  dds::Qos qos;
+
+  /// Plural name of the samples, for reports
+  const char* label;
+};
+
+/// Gets the DDS topics of every RecordTopic, indexed by RecordTopic.
+inline std::array<RecordTopicInfo, RecordTopicNum> get_record_topics(
+    const ServerConfig& _topics)
+{
+  return {{
+    {&FreeFleetData_RobotState_desc, _topics.dds_robot_state_topic,
+        dds::Qos::BestEffort, "robot states"},
+    {&FreeFleetData_ModeRequest_desc, _topics.dds_mode_request_topic,
+        dds::Qos::BestEffort, "mode requests"},
+    {&FreeFleetData_PathRequest_desc, _topics.dds_path_request_topic,
+        dds::Qos::BestEffort, "path requests"},
+    {&FreeFleetData_DestinationRequest_desc,
+        _topics.dds_destination_request_topic, dds::Qos::BestEffort,
+        "destination requests"},
+    {&FreeFleetData_CompactRobotState_desc,
+        _topics.dds_compact_robot_state_topic, dds::Qos::BestEffort,
+        "compact robot states"},
+    {&FreeFleetData_NameRegistryEntry_desc, _topics.dds_name_registry_topic,
+        dds::Qos::Durable, "name registry entries"},
+    {&FreeFleetData_ExtendedModeRequest_desc,
+        _topics.dds_priority_mode_request_topic, dds::Qos::Reliable,
+        "priority mode requests"},
+    {&FreeFleetData_FleetPathRequest_desc,
+        _topics.dds_fleet_path_request_topic, dds::Qos::Reliable,
+        "fleet path requests"},
+    {&FreeFleetData_ExtendedRobotState_desc,
+        _topics.dds_extended_robot_state_topic, dds::Qos::BestEffort,
+        "extended robot states"},
+    {&FreeFleetData_ExtendedPathRequest_desc,
+        _topics.dds_extended_path_request_topic, dds::Qos::BestEffort,
+        "extended path requests"},
+    {&FreeFleetData_ExtendedModeRequest_desc,
+        _topics.dds_extended_mode_request_topic, dds::Qos::BestEffort,
+        "extended mode requests"},
+    {&FreeFleetData_ExtendedDestinationRequest_desc,
+        _topics.dds_extended_destination_request_topic, dds::Qos::BestEffort,
+        "extended destination requests"}
+  }};
+}
+
+} // namespace recording
+} // namespace free_fleet
+
+#endif // FREE_FLEET__SRC__RECORDING__RECORDTOPICS_HPP
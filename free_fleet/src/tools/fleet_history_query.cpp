@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <chrono>
+#include <limits>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+#include <free_fleet/StateHistory.hpp>
+
+using namespace free_fleet;
+
+namespace {
+
+struct Options
+{
+  std::string input_path;
+  std::string robot_name;
+  int64_t start = std::numeric_limits<int64_t>::min();
+  int64_t end = std::numeric_limits<int64_t>::max();
+};
+
+void print_usage()
+{
+  printf("Usage: fleet_history_query -i <file> [options]\n");
+  printf("  -i <file>      state history ring file of a server\n");
+  printf("  -r <name>      only prints the states of this robot\n");
+  printf("  -s <sec>       start of the time range, in seconds since epoch\n");
+  printf("  -e <sec>       end of the time range, in seconds since epoch\n");
+  printf("  -l <sec>       only prints the last <sec> seconds of history\n");
+}
+
+int64_t to_nanosec(double _sec)
+{
+  return static_cast<int64_t>(_sec * 1e9);
+}
+
+bool parse_options(int argc, char** argv, Options& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg(argv[i]);
+    if (arg == "-h" || arg == "--help" || i + 1 >= argc)
+      return false;
+
+    const char* value = argv[++i];
+    if (arg == "-i")
+      options.input_path = value;
+    else if (arg == "-r")
+      options.robot_name = value;
+    else if (arg == "-s")
+      options.start = to_nanosec(std::atof(value));
+    else if (arg == "-e")
+      options.end = to_nanosec(std::atof(value));
+    else if (arg == "-l")
+    {
+      options.start = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count() -
+          to_nanosec(std::atof(value));
+    }
+    else
+      return false;
+  }
+  return !options.input_path.empty() && options.start <= options.end;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  Options options;
+  if (!parse_options(argc, argv, options))
+  {
+    print_usage();
+    return 1;
+  }
+
+  StateHistory::SharedPtr history = StateHistory::open(options.input_path);
+  if (!history)
+  {
+    fprintf(stderr, "failed to open %s as a state history\n",
+        options.input_path.c_str());
+    return 1;
+  }
+
+  std::vector<StateHistory::Record> records;
+  history->query(options.start, options.end, records, options.robot_name);
+
+  printf("stamp,robot_name,mode,battery_percent,task_id,level_name,x,y,yaw,"
+      "location_sec,location_nanosec\n");
+  for (const auto& record : records)
+  {
+    printf("%.9f,%s,%u,%.3f,%s,%s,%.3f,%.3f,%.3f,%d,%u\n",
+        static_cast<double>(record.stamp) / 1e9,
+        record.robot_name,
+        record.mode,
+        record.battery_percent,
+        record.task_id,
+        record.level_name,
+        record.x,
+        record.y,
+        record.yaw,
+        record.location_sec,
+        record.location_nanosec);
+  }
+  return 0;
+}
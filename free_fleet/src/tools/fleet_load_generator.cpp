@@ -0,0 +1,550 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <deque>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <limits>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#include <free_fleet/Client.hpp>
+#include <free_fleet/ClientConfig.hpp>
+#include <free_fleet/Server.hpp>
+#include <free_fleet/ServerConfig.hpp>
+#include <free_fleet/Metrics.hpp>
+
+using namespace free_fleet;
+
+namespace {
+
+struct Options
+{
+  int robot_num = 10;
+  double publish_frequency = 1.0;
+  double duration = 60.0;
+  int thread_num = 1;
+  int path_length = 10;
+  double speed = 0.5;
+  double area_size = 50.0;
+  std::string fleet_name = "load_fleet";
+  std::string level_name = "L1";
+  int dds_domain = 42;
+  bool dds_shared_memory = false;
+  bool probe = false;
+  double probe_request_period = 1.0;
+  double report_period = 10.0;
+  std::string metrics_file;
+};
+
+void print_usage()
+{
+  printf("Usage: fleet_load_generator [options]\n");
+  printf("  -n <num>       number of simulated robots (default 10)\n");
+  printf("  -r <hz>        robot state publish frequency (default 1.0)\n");
+  printf("  -d <sec>       duration of the run (default 60.0)\n");
+  printf("  -t <num>       number of threads driving the robots (default 1)\n");
+  printf("  -l <num>       waypoints per synthetic path (default 10)\n");
+  printf("  -s <m/s>       speed of the robots (default 0.5)\n");
+  printf("  -f <name>      fleet name (default load_fleet)\n");
+  printf("  -D <domain>    DDS domain (default 42)\n");
+  printf("  -m <0|1>       use the shared memory transport (default 0)\n");
+  printf("  -p <sec>       run an in-process probe server, which sends a path\n");
+  printf("                 request to a random robot every <sec> seconds\n");
+  printf("  -R <sec>       latency report period (default 10.0)\n");
+  printf("  -o <file>      also write the metrics to <file> on every report\n");
+  printf("\n");
+  printf("Server to client latency is measured from the server_send hop of\n");
+  printf("traced requests, the server under test needs to trace requests.\n");
+  printf("Client to server latency is only measured by the probe server.\n");
+}
+
+bool parse_options(int argc, char** argv, Options& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg(argv[i]);
+    if (arg == "-h" || arg == "--help" || i + 1 >= argc)
+      return false;
+
+    const char* value = argv[++i];
+    if (arg == "-n")
+      options.robot_num = std::atoi(value);
+    else if (arg == "-r")
+      options.publish_frequency = std::atof(value);
+    else if (arg == "-d")
+      options.duration = std::atof(value);
+    else if (arg == "-t")
+      options.thread_num = std::atoi(value);
+    else if (arg == "-l")
+      options.path_length = std::atoi(value);
+    else if (arg == "-s")
+      options.speed = std::atof(value);
+    else if (arg == "-f")
+      options.fleet_name = value;
+    else if (arg == "-D")
+      options.dds_domain = std::atoi(value);
+    else if (arg == "-m")
+      options.dds_shared_memory = std::atoi(value) != 0;
+    else if (arg == "-p")
+    {
+      options.probe = true;
+      options.probe_request_period = std::atof(value);
+    }
+    else if (arg == "-R")
+      options.report_period = std::atof(value);
+    else if (arg == "-o")
+      options.metrics_file = value;
+    else
+      return false;
+  }
+  return options.robot_num > 0 && options.publish_frequency > 0.0 &&
+      options.thread_num > 0 && options.path_length > 0;
+}
+
+int64_t now_nanosec()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void stamp(messages::Location& _location, int64_t _nanosec)
+{
+  _location.sec = static_cast<int32_t>(_nanosec / 1000000000);
+  _location.nanosec = static_cast<uint32_t>(_nanosec % 1000000000);
+}
+
+int64_t to_nanosec(const messages::Location& _location)
+{
+  return static_cast<int64_t>(_location.sec) * 1000000000 +
+      _location.nanosec;
+}
+
+/// Buckets of 1, 2 and 5 times every power of ten from 10us to 10s, finer
+/// than the default latency buckets so that percentiles are meaningful
+std::vector<double> make_latency_buckets()
+{
+  std::vector<double> upper_bounds;
+  for (double scale = 1e-5; scale < 10.0; scale *= 10.0)
+  {
+    for (double factor : {1.0, 2.0, 5.0})
+      upper_bounds.push_back(scale * factor);
+  }
+  upper_bounds.push_back(10.0);
+  return upper_bounds;
+}
+
+/// Prints the mean and percentiles of a latency histogram in milliseconds,
+/// percentiles being the upper bounds of the buckets holding them
+void report(const char* _name, const Metrics::Histogram& _histogram)
+{
+  const Metrics::Histogram::Snapshot snapshot = _histogram.get_snapshot();
+  const uint64_t count = snapshot.cumulative_counts.back();
+  if (count == 0)
+  {
+    printf("  %-16s no samples\n", _name);
+    return;
+  }
+  auto percentile = [&](double _p)
+  {
+    const uint64_t rank = std::max<uint64_t>(
+        static_cast<uint64_t>(std::ceil(_p * static_cast<double>(count))), 1);
+    for (size_t i = 0; i < snapshot.upper_bounds.size(); ++i)
+    {
+      if (snapshot.cumulative_counts[i] >= rank)
+        return snapshot.upper_bounds[i] * 1e3;
+    }
+    return std::numeric_limits<double>::infinity();
+  };
+  printf("  %-16s n %8lu  mean %8.3f  p50 <%8.3f  p90 <%8.3f  p99 <%8.3f ms\n",
+      _name, count, snapshot.sum / static_cast<double>(count) * 1e3,
+      percentile(0.5), percentile(0.9), percentile(0.99));
+}
+
+/// Registered in main before any thread starts
+Metrics::Histogram* server_to_client = nullptr;
+
+Metrics::Histogram* client_to_server = nullptr;
+
+std::atomic<uint64_t> states_sent(0);
+
+std::atomic<uint64_t> requests_received(0);
+
+/// A robot that follows synthetic paths, and the paths and modes requested
+/// by the server
+class SimRobot
+{
+public:
+
+  SimRobot(
+      const Options& _options, const std::string& _name,
+      Client::SharedPtr _client, unsigned int _seed) :
+    options(_options),
+    name(_name),
+    client(std::move(_client)),
+    rng(_seed)
+  {
+    std::uniform_real_distribution<double> coordinate(0.0, options.area_size);
+    x = coordinate(rng);
+    y = coordinate(rng);
+  }
+
+  void step(double _dt)
+  {
+    read_requests();
+
+    if (path.empty() && task_id.empty())
+      generate_path();
+
+    if (!paused && !path.empty())
+    {
+      const double dx = path.front().x - x;
+      const double dy = path.front().y - y;
+      const double distance = std::hypot(dx, dy);
+      const double step_distance = options.speed * _dt;
+      yaw = std::atan2(dy, dx);
+      if (distance <= step_distance)
+      {
+        x = path.front().x;
+        y = path.front().y;
+        path.pop_front();
+        if (path.empty())
+          task_id.clear();
+      }
+      else
+      {
+        x += dx / distance * step_distance;
+        y += dy / distance * step_distance;
+      }
+    }
+  }
+
+  void publish_state()
+  {
+    messages::RobotState state;
+    state.name = name;
+    state.model = "load_model";
+    state.task_id = task_id;
+    state.mode.mode = paused ? messages::RobotMode::MODE_PAUSED :
+        (path.empty() ? messages::RobotMode::MODE_IDLE :
+            messages::RobotMode::MODE_MOVING);
+    state.battery_percent = 100.0;
+    state.location.x = static_cast<float>(x);
+    state.location.y = static_cast<float>(y);
+    state.location.yaw = static_cast<float>(yaw);
+    state.location.level_name = options.level_name;
+    state.path.assign(path.begin(), path.end());
+
+    // Stamped last, so the serialization of the path counts towards latency
+    stamp(state.location, now_nanosec());
+    if (client->send_robot_state(state))
+      ++states_sent;
+  }
+
+private:
+
+  const Options& options;
+
+  std::string name;
+
+  Client::SharedPtr client;
+
+  std::mt19937 rng;
+
+  double x = 0.0;
+  double y = 0.0;
+  double yaw = 0.0;
+
+  bool paused = false;
+
+  std::string task_id;
+
+  std::deque<messages::Location> path;
+
+  bool is_for_me(
+      const std::string& _fleet_name,
+      const std::string& _robot_name,
+      const std::string& _task_id) const
+  {
+    return _fleet_name == options.fleet_name && _robot_name == name &&
+        _task_id != task_id;
+  }
+
+  /// Records the time from the server sending a traced request until the
+  /// client received it. The client converts the hops of the server to its
+  /// own clock once it has estimated the offset, and drops them until then.
+  void record_latency(const messages::Trace& _trace)
+  {
+    if (_trace.hops.empty() || _trace.hops.back().stage != "client_receive")
+      return;
+
+    auto sent = std::find_if(_trace.hops.begin(), _trace.hops.end(),
+        [](const messages::TraceHop& _hop)
+        {
+          return _hop.stage == "server_send";
+        });
+    if (sent == _trace.hops.end())
+      return;
+
+    server_to_client->observe(
+        static_cast<double>(
+            std::max<int64_t>(_trace.hops.back().stamp - sent->stamp, 0)) /
+        1e9);
+  }
+
+  void read_requests()
+  {
+    messages::ModeRequest mode_request;
+    if (client->read_mode_request(mode_request) &&
+        is_for_me(
+            mode_request.fleet_name, mode_request.robot_name,
+            mode_request.task_id))
+    {
+      ++requests_received;
+      record_latency(mode_request.trace);
+      task_id = mode_request.task_id;
+      if (mode_request.mode.mode == messages::RobotMode::MODE_PAUSED ||
+          mode_request.mode.mode == messages::RobotMode::MODE_EMERGENCY)
+        paused = true;
+      else if (mode_request.mode.mode == messages::RobotMode::MODE_MOVING)
+        paused = false;
+    }
+
+    messages::PathRequest path_request;
+    if (client->read_path_request(path_request) &&
+        is_for_me(
+            path_request.fleet_name, path_request.robot_name,
+            path_request.task_id) &&
+        !path_request.path.empty())
+    {
+      ++requests_received;
+      record_latency(path_request.trace);
+      task_id = path_request.task_id;
+      path.assign(path_request.path.begin(), path_request.path.end());
+      paused = false;
+    }
+
+    messages::DestinationRequest destination_request;
+    if (client->read_destination_request(destination_request) &&
+        is_for_me(
+            destination_request.fleet_name, destination_request.robot_name,
+            destination_request.task_id))
+    {
+      ++requests_received;
+      record_latency(destination_request.trace);
+      task_id = destination_request.task_id;
+      path.assign({destination_request.destination});
+      paused = false;
+    }
+  }
+
+  void generate_path()
+  {
+    std::uniform_real_distribution<double> offset(-5.0, 5.0);
+    double wp_x = x;
+    double wp_y = y;
+    for (int i = 0; i < options.path_length; ++i)
+    {
+      wp_x = std::min(std::max(wp_x + offset(rng), 0.0), options.area_size);
+      wp_y = std::min(std::max(wp_y + offset(rng), 0.0), options.area_size);
+      path.push_back(
+          messages::Location{0, 0, static_cast<float>(wp_x),
+              static_cast<float>(wp_y), 0.0f, options.level_name});
+    }
+  }
+
+};
+
+void drive_robots(
+    const Options& _options, std::vector<SimRobot*> _robots,
+    const std::atomic<bool>& _running)
+{
+  const auto period = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>(1.0 / _options.publish_frequency));
+  auto next_time = std::chrono::steady_clock::now();
+  while (_running)
+  {
+    for (SimRobot* robot : _robots)
+    {
+      robot->step(1.0 / _options.publish_frequency);
+      robot->publish_state();
+    }
+
+    next_time += period;
+    std::this_thread::sleep_until(next_time);
+  }
+}
+
+void run_probe(
+    const Options& _options, Server::SharedPtr _server,
+    const std::atomic<bool>& _running)
+{
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int> robot_index(0, _options.robot_num - 1);
+  uint64_t task_count = 0;
+  auto next_request_time = std::chrono::steady_clock::now();
+  while (_running)
+  {
+    std::vector<messages::RobotState> robot_states;
+    while (_server->read_robot_states(robot_states))
+    {
+      const int64_t now = now_nanosec();
+      for (const auto& robot_state : robot_states)
+      {
+        client_to_server->observe(
+            static_cast<double>(
+                std::max<int64_t>(now - to_nanosec(robot_state.location), 0)) /
+            1e9);
+      }
+    }
+
+    if (_options.probe_request_period > 0.0 &&
+        std::chrono::steady_clock::now() >= next_request_time)
+    {
+      messages::PathRequest path_request;
+      path_request.fleet_name = _options.fleet_name;
+      path_request.robot_name = "robot_" + std::to_string(robot_index(rng));
+      path_request.task_id = "probe_" + std::to_string(task_count++);
+      for (int i = 0; i < _options.path_length; ++i)
+      {
+        path_request.path.push_back(
+            messages::Location{0, 0, static_cast<float>(i), 0.0f, 0.0f,
+                _options.level_name});
+      }
+      _server->get_tracer()->start(
+          path_request.trace, path_request.task_id, "probe_send");
+      _server->send_path_request(path_request);
+
+      next_request_time +=
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              std::chrono::duration<double>(_options.probe_request_period));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  Options options;
+  if (!parse_options(argc, argv, options))
+  {
+    print_usage();
+    return 1;
+  }
+
+  Metrics::SharedPtr metrics = Metrics::make();
+  const std::vector<double> latency_buckets = make_latency_buckets();
+  server_to_client = &metrics->histogram(
+      "free_fleet_load_server_to_client_seconds",
+      "Time from the server sending a traced request until a simulated robot "
+      "received it.", {}, latency_buckets);
+  client_to_server = &metrics->histogram(
+      "free_fleet_load_client_to_server_seconds",
+      "Time from a simulated robot sending its state until the probe server "
+      "received it.", {}, latency_buckets);
+
+  ClientConfig client_config;
+  client_config.dds_domain = options.dds_domain;
+  client_config.dds_shared_memory = options.dds_shared_memory;
+  client_config.dds_trace_requests = true;
+
+  std::vector<std::unique_ptr<SimRobot>> robots;
+  for (int i = 0; i < options.robot_num; ++i)
+  {
+    Client::SharedPtr client = Client::make(client_config);
+    if (!client)
+    {
+      printf("failed to create client %d\n", i);
+      return 1;
+    }
+    robots.emplace_back(new SimRobot(
+        options, "robot_" + std::to_string(i), std::move(client),
+        static_cast<unsigned int>(i)));
+  }
+  printf("created %d simulated robots.\n", options.robot_num);
+
+  Server::SharedPtr probe_server;
+  if (options.probe)
+  {
+    ServerConfig server_config;
+    server_config.dds_domain = options.dds_domain;
+    server_config.dds_shared_memory = options.dds_shared_memory;
+    server_config.dds_trace_requests = true;
+    probe_server = Server::make(server_config);
+    if (!probe_server)
+    {
+      printf("failed to create probe server\n");
+      return 1;
+    }
+  }
+
+  std::atomic<bool> running(true);
+  std::vector<std::thread> threads;
+  const int thread_num = std::min(options.thread_num, options.robot_num);
+  for (int t = 0; t < thread_num; ++t)
+  {
+    std::vector<SimRobot*> thread_robots;
+    for (size_t i = t; i < robots.size(); i += thread_num)
+      thread_robots.push_back(robots[i].get());
+    threads.emplace_back(
+        drive_robots, std::cref(options), thread_robots, std::cref(running));
+  }
+  if (probe_server)
+    threads.emplace_back(
+        run_probe, std::cref(options), probe_server, std::cref(running));
+
+  const auto start_time = std::chrono::steady_clock::now();
+  const auto end_time = start_time +
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(options.duration));
+  auto next_report_time = start_time;
+  while (std::chrono::steady_clock::now() < end_time)
+  {
+    next_report_time +=
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(options.report_period));
+    std::this_thread::sleep_until(std::min(next_report_time, end_time));
+
+    const double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start_time).count();
+    printf("[%.1fs] states sent %lu (%.1f/s), requests received %lu\n",
+        elapsed, states_sent.load(), states_sent.load() / elapsed,
+        requests_received.load());
+    report("server->client", *server_to_client);
+    report("client->server", *client_to_server);
+    fflush(stdout);
+
+    if (!options.metrics_file.empty() &&
+        !metrics->write_to_file(options.metrics_file))
+      printf("failed to write metrics to %s\n", options.metrics_file.c_str());
+  }
+
+  running = false;
+  for (auto& thread : threads)
+    thread.join();
+  return 0;
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <csignal>
+#include <cstdlib>
+
+#include <dds/dds.h>
+
+#include <free_fleet/ServerConfig.hpp>
+
+#include "dds_utils/DDSSerializedSubscribeHandler.hpp"
+#include "recording/RecordLog.hpp"
+#include "recording/RecordTopics.hpp"
+
+using namespace free_fleet;
+using recording::RecordTopic;
+
+namespace {
+
+struct Options
+{
+  std::string output_path;
+  double duration = 0.0;
+  double flush_period = 1.0;
+  ServerConfig topics;
+};
+
+void print_usage()
+{
+  printf("Usage: fleet_recorder -o <file> [options]\n");
+  printf("  -o <file>      record log to append to\n");
+  printf("  -d <sec>       duration of the recording, until interrupted\n");
+  printf("                 when not positive (default 0.0)\n");
+  printf("  -F <sec>       period at which the log is flushed (default 1.0)\n");
+  printf("  -D <domain>    DDS domain (default 42)\n");
+  printf("  -S <topic>     robot state topic (default robot_state)\n");
+  printf("  -M <topic>     mode request topic (default mode_request)\n");
+  printf("  -P <topic>     path request topic (default path_request)\n");
+  printf("  -G <topic>     destination request topic\n");
+  printf("                 (default destination_request)\n");
+  printf("  -C <topic>     compact robot state topic\n");
+  printf("                 (default compact_robot_state)\n");
+  printf("  -N <topic>     name registry topic (default name_registry)\n");
+  printf("  -E <topic>     priority mode request topic\n");
+  printf("                 (default priority_mode_request)\n");
+  printf("  -B <topic>     fleet path request topic\n");
+  printf("                 (default fleet_path_request)\n");
+  printf("  -X <topic>     extended robot state topic\n");
+  printf("                 (default extended_robot_state)\n");
+  printf("  -Y <topic>     extended path request topic\n");
+  printf("                 (default extended_path_request)\n");
+  printf("  -W <topic>     extended mode request topic\n");
+  printf("                 (default extended_mode_request)\n");
+  printf("  -Z <topic>     extended destination request topic\n");
+  printf("                 (default extended_destination_request)\n");
+}
+
+bool parse_options(int argc, char** argv, Options& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg(argv[i]);
+    if (arg == "-h" || arg == "--help" || i + 1 >= argc)
+      return false;
+
+    const char* value = argv[++i];
+    if (arg == "-o")
+      options.output_path = value;
+    else if (arg == "-d")
+      options.duration = std::atof(value);
+    else if (arg == "-F")
+      options.flush_period = std::atof(value);
+    else if (arg == "-D")
+      options.topics.dds_domain = std::atoi(value);
+    else if (arg == "-S")
+      options.topics.dds_robot_state_topic = value;
+    else if (arg == "-M")
+      options.topics.dds_mode_request_topic = value;
+    else if (arg == "-P")
+      options.topics.dds_path_request_topic = value;
+    else if (arg == "-G")
+      options.topics.dds_destination_request_topic = value;
+    else if (arg == "-C")
+      options.topics.dds_compact_robot_state_topic = value;
+    else if (arg == "-N")
+      options.topics.dds_name_registry_topic = value;
+    else if (arg == "-E")
+      options.topics.dds_priority_mode_request_topic = value;
+    else if (arg == "-B")
+      options.topics.dds_fleet_path_request_topic = value;
+    else if (arg == "-X")
+      options.topics.dds_extended_robot_state_topic = value;
+    else if (arg == "-Y")
+      options.topics.dds_extended_path_request_topic = value;
+    else if (arg == "-W")
+      options.topics.dds_extended_mode_request_topic = value;
+    else if (arg == "-Z")
+      options.topics.dds_extended_destination_request_topic = value;
+    else
+      return false;
+  }
+  return !options.output_path.empty() && options.flush_period > 0.0;
+}
+
+std::atomic<bool> running(true);
+
+void signal_handler(int)
+{
+  running = false;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  Options options;
+  if (!parse_options(argc, argv, options))
+  {
+    print_usage();
+    return 1;
+  }
+
+  recording::RecordLogWriter::SharedPtr log =
+      recording::RecordLogWriter::make(options.output_path);
+  if (!log)
+  {
+    printf("failed to open %s as a record log\n", options.output_path.c_str());
+    return 1;
+  }
+
+  dds_entity_t participant = dds_create_participant(
+      static_cast<dds_domainid_t>(options.topics.dds_domain), NULL, NULL);
+  if (participant < 0)
+  {
+    DDS_FATAL("dds_create_participant: %s\n", dds_strretcode(-participant));
+    return 1;
+  }
+
+  // Indexed by RecordTopic, topics without writers cost nothing to record
+  const auto topics = recording::get_record_topics(options.topics);
+  std::array<dds::DDSSerializedSubscribeHandler::SharedPtr,
+      recording::RecordTopicNum> subs;
+  for (std::size_t i = 0; i < topics.size(); ++i)
+  {
+    subs[i] = std::make_shared<dds::DDSSerializedSubscribeHandler>(
+        participant, topics[i].desc, topics[i].topic_name, true, "",
+        topics[i].qos);
+  }
+
+  dds_entity_t waitset = dds_create_waitset(participant);
+  for (const auto& sub : subs)
+  {
+    if (!sub->is_ready())
+    {
+      dds_delete(participant);
+      return 1;
+    }
+    dds_entity_t read_condition =
+        dds_create_readcondition(sub->get_reader(), DDS_ANY_STATE);
+    dds_waitset_attach(waitset, read_condition, read_condition);
+  }
+
+  signal(SIGINT, signal_handler);
+  signal(SIGTERM, signal_handler);
+
+  const dds_time_t start_time = dds_time();
+  const dds_time_t end_time = options.duration > 0.0 ?
+      start_time + static_cast<dds_duration_t>(options.duration * 1e9) :
+      DDS_NEVER;
+  const dds_duration_t flush_period =
+      static_cast<dds_duration_t>(options.flush_period * 1e9);
+  dds_time_t next_flush_time = start_time + flush_period;
+
+  std::array<uint64_t, recording::RecordTopicNum> sample_nums = {{0}};
+  uint64_t byte_num = 0;
+  std::vector<uint8_t> data;
+  dds_time_t source_timestamp;
+  bool ok = true;
+
+  printf("recording to %s, interrupt to stop.\n", options.output_path.c_str());
+  while (running && ok && dds_time() < end_time)
+  {
+    dds_waitset_wait(waitset, NULL, 0, DDS_MSECS(100));
+
+    for (std::size_t i = 0; i < subs.size() && ok; ++i)
+    {
+      while (subs[i]->take(data, source_timestamp))
+      {
+        // Samples are stamped on arrival, so that a replay reproduces the
+        // traffic as this recorder saw it, regardless of the writers' clocks
+        if (!log->append(static_cast<RecordTopic>(i), dds_time(),
+            data.data(), static_cast<uint32_t>(data.size())))
+        {
+          printf("failed to append to %s\n", options.output_path.c_str());
+          ok = false;
+          break;
+        }
+        ++sample_nums[i];
+        byte_num += data.size();
+      }
+    }
+
+    if (dds_time() >= next_flush_time)
+    {
+      log->flush();
+      next_flush_time += flush_period;
+    }
+  }
+  log->flush();
+
+  const double elapsed = static_cast<double>(dds_time() - start_time) / 1e9;
+  printf("recorded %lu bytes in %.1fs:\n", byte_num, elapsed);
+  for (std::size_t i = 0; i < topics.size(); ++i)
+    printf("  %lu %s\n", sample_nums[i], topics[i].label);
+
+  dds_delete(participant);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,367 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <csignal>
+#include <cstdlib>
+#include <algorithm>
+
+#include <dds/dds.h>
+
+#include <free_fleet/ServerConfig.hpp>
+
+#include "messages/FleetMessages.h"
+#include "dds_utils/Qos.hpp"
+#include "dds_utils/DDSSerializedPublishHandler.hpp"
+#include "dds_utils/DDSSerializedSubscribeHandler.hpp"
+
+using namespace free_fleet;
+
+namespace {
+
+struct Options
+{
+  int site_domain = 42;
+  int upstream_domain = 42;
+  std::string site_partition;
+  std::string upstream_partition;
+  double duration = 0.0;
+  double report_period = 10.0;
+  ServerConfig topics;
+};
+
+void print_usage()
+{
+  printf("Usage: fleet_relay [options]\n");
+  printf("Relays robot states from the site to upstream, and requests from\n");
+  printf("upstream to the site, as serialized samples. The optional compact\n");
+  printf("state, priority mode request and fleet path request topics are\n");
+  printf("always relayed, with the same quality of service as the server\n");
+  printf("and clients use.\n");
+  printf("  -a <domain>    DDS domain of the site (default 42)\n");
+  printf("  -b <domain>    DDS domain upstream (default 42)\n");
+  printf("  -p <name>      partition of the site (default partition)\n");
+  printf("  -q <name>      partition upstream (default partition)\n");
+  printf("  -d <sec>       duration of the relay, until interrupted when\n");
+  printf("                 not positive (default 0.0)\n");
+  printf("  -R <sec>       throughput report period (default 10.0)\n");
+  printf("  -S <topic>     robot state topic (default robot_state)\n");
+  printf("  -M <topic>     mode request topic (default mode_request)\n");
+  printf("  -P <topic>     path request topic (default path_request)\n");
+  printf("  -G <topic>     destination request topic\n");
+  printf("                 (default destination_request)\n");
+  printf("  -C <topic>     compact robot state topic\n");
+  printf("                 (default compact_robot_state)\n");
+  printf("  -N <topic>     name registry topic (default name_registry)\n");
+  printf("  -E <topic>     priority mode request topic\n");
+  printf("                 (default priority_mode_request)\n");
+  printf("  -F <topic>     fleet path request topic\n");
+  printf("                 (default fleet_path_request)\n");
+  printf("  -X <topic>     extended robot state topic\n");
+  printf("                 (default extended_robot_state)\n");
+  printf("  -Y <topic>     extended path request topic\n");
+  printf("                 (default extended_path_request)\n");
+  printf("  -W <topic>     extended mode request topic\n");
+  printf("                 (default extended_mode_request)\n");
+  printf("  -Z <topic>     extended destination request topic\n");
+  printf("                 (default extended_destination_request)\n");
+}
+
+bool parse_options(int argc, char** argv, Options& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg(argv[i]);
+    if (arg == "-h" || arg == "--help" || i + 1 >= argc)
+      return false;
+
+    const char* value = argv[++i];
+    if (arg == "-a")
+      options.site_domain = std::atoi(value);
+    else if (arg == "-b")
+      options.upstream_domain = std::atoi(value);
+    else if (arg == "-p")
+      options.site_partition = value;
+    else if (arg == "-q")
+      options.upstream_partition = value;
+    else if (arg == "-d")
+      options.duration = std::atof(value);
+    else if (arg == "-R")
+      options.report_period = std::atof(value);
+    else if (arg == "-S")
+      options.topics.dds_robot_state_topic = value;
+    else if (arg == "-M")
+      options.topics.dds_mode_request_topic = value;
+    else if (arg == "-P")
+      options.topics.dds_path_request_topic = value;
+    else if (arg == "-G")
+      options.topics.dds_destination_request_topic = value;
+    else if (arg == "-C")
+      options.topics.dds_compact_robot_state_topic = value;
+    else if (arg == "-N")
+      options.topics.dds_name_registry_topic = value;
+    else if (arg == "-E")
+      options.topics.dds_priority_mode_request_topic = value;
+    else if (arg == "-F")
+      options.topics.dds_fleet_path_request_topic = value;
+    else if (arg == "-X")
+      options.topics.dds_extended_robot_state_topic = value;
+    else if (arg == "-Y")
+      options.topics.dds_extended_path_request_topic = value;
+    else if (arg == "-W")
+      options.topics.dds_extended_mode_request_topic = value;
+    else if (arg == "-Z")
+      options.topics.dds_extended_destination_request_topic = value;
+    else
+      return false;
+  }
+
+  // Relaying within the same domain and partition would feed on itself
+  if (options.site_domain == options.upstream_domain &&
+      options.site_partition == options.upstream_partition)
+  {
+    printf("the site and upstream must differ in domain or partition\n");
+    return false;
+  }
+  return options.report_period > 0.0;
+}
+
+/// Forwards the samples of a single topic in a single direction
+struct Channel
+{
+  std::string name;
+  dds::DDSSerializedSubscribeHandler::SharedPtr sub;
+  dds::DDSSerializedPublishHandler::SharedPtr pub;
+  std::atomic<uint64_t> sample_num{0};
+  std::atomic<uint64_t> byte_num{0};
+  std::atomic<uint64_t> failure_num{0};
+};
+
+std::atomic<bool> running(true);
+
+void signal_handler(int)
+{
+  running = false;
+}
+
+/// Waits on the readers of all the channels reading from the same
+/// participant, and forwards their samples as soon as they arrive
+void relay(dds_entity_t _participant, const std::vector<Channel*>& _channels)
+{
+  dds_entity_t waitset = dds_create_waitset(_participant);
+  for (Channel* channel : _channels)
+  {
+    dds_entity_t read_condition =
+        dds_create_readcondition(channel->sub->get_reader(), DDS_ANY_STATE);
+    dds_waitset_attach(waitset, read_condition, read_condition);
+  }
+
+  // Reused across samples, so that relaying never allocates once warmed up
+  std::vector<uint8_t> data;
+  dds_time_t source_timestamp;
+  while (running)
+  {
+    dds_waitset_wait(waitset, NULL, 0, DDS_MSECS(100));
+
+    for (Channel* channel : _channels)
+    {
+      while (channel->sub->take(data, source_timestamp))
+      {
+        if (channel->pub->write(data.data(), data.size()))
+        {
+          channel->sample_num.fetch_add(1, std::memory_order_relaxed);
+          channel->byte_num.fetch_add(
+              data.size(), std::memory_order_relaxed);
+        }
+        else
+          channel->failure_num.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }
+  dds_delete(waitset);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  Options options;
+  if (!parse_options(argc, argv, options))
+  {
+    print_usage();
+    return 1;
+  }
+
+  dds_entity_t site_participant = dds_create_participant(
+      static_cast<dds_domainid_t>(options.site_domain), NULL, NULL);
+  if (site_participant < 0)
+  {
+    DDS_FATAL("dds_create_participant: %s\n",
+        dds_strretcode(-site_participant));
+    return 1;
+  }
+
+  dds_entity_t upstream_participant = site_participant;
+  if (options.upstream_domain != options.site_domain)
+  {
+    upstream_participant = dds_create_participant(
+        static_cast<dds_domainid_t>(options.upstream_domain), NULL, NULL);
+    if (upstream_participant < 0)
+    {
+      DDS_FATAL("dds_create_participant: %s\n",
+          dds_strretcode(-upstream_participant));
+      dds_delete(site_participant);
+      return 1;
+    }
+  }
+
+  // Topics that the server or clients do not use have no writers, and cost
+  // nothing to relay. Stop and resume requests must keep their reliable
+  // lane, and the name registry its durability, so that robots that join
+  // later are still resolved upstream.
+  struct Route
+  {
+    const dds_topic_descriptor_t* desc;
+    std::string topic_name;
+    bool upstream;
+    dds::Qos qos;
+  };
+  const std::vector<Route> routes = {
+    {&FreeFleetData_RobotState_desc,
+        options.topics.dds_robot_state_topic, true, dds::Qos::BestEffort},
+    {&FreeFleetData_ExtendedRobotState_desc,
+        options.topics.dds_extended_robot_state_topic, true,
+        dds::Qos::BestEffort},
+    {&FreeFleetData_CompactRobotState_desc,
+        options.topics.dds_compact_robot_state_topic, true,
+        dds::Qos::BestEffort},
+    {&FreeFleetData_NameRegistryEntry_desc,
+        options.topics.dds_name_registry_topic, true, dds::Qos::Durable},
+    {&FreeFleetData_ModeRequest_desc,
+        options.topics.dds_mode_request_topic, false, dds::Qos::BestEffort},
+    {&FreeFleetData_ExtendedModeRequest_desc,
+        options.topics.dds_extended_mode_request_topic, false,
+        dds::Qos::BestEffort},
+    {&FreeFleetData_ExtendedModeRequest_desc,
+        options.topics.dds_priority_mode_request_topic, false,
+        dds::Qos::Reliable},
+    {&FreeFleetData_PathRequest_desc,
+        options.topics.dds_path_request_topic, false, dds::Qos::BestEffort},
+    {&FreeFleetData_ExtendedPathRequest_desc,
+        options.topics.dds_extended_path_request_topic, false,
+        dds::Qos::BestEffort},
+    {&FreeFleetData_FleetPathRequest_desc,
+        options.topics.dds_fleet_path_request_topic, false,
+        dds::Qos::Reliable},
+    {&FreeFleetData_DestinationRequest_desc,
+        options.topics.dds_destination_request_topic, false,
+        dds::Qos::BestEffort},
+    {&FreeFleetData_ExtendedDestinationRequest_desc,
+        options.topics.dds_extended_destination_request_topic, false,
+        dds::Qos::BestEffort}
+  };
+
+  std::vector<std::unique_ptr<Channel>> channels;
+  std::vector<Channel*> site_channels;
+  std::vector<Channel*> upstream_channels;
+  bool ready = true;
+  for (const auto& route : routes)
+  {
+    const dds_entity_t source =
+        route.upstream ? site_participant : upstream_participant;
+    const dds_entity_t destination =
+        route.upstream ? upstream_participant : site_participant;
+    const std::string& source_partition =
+        route.upstream ? options.site_partition : options.upstream_partition;
+    const std::string& destination_partition =
+        route.upstream ? options.upstream_partition : options.site_partition;
+
+    std::unique_ptr<Channel> channel(new Channel);
+    channel->name = route.topic_name + (route.upstream ? " ->" : " <-");
+    channel->sub = std::make_shared<dds::DDSSerializedSubscribeHandler>(
+        source, route.desc, route.topic_name, true, source_partition,
+        route.qos);
+    channel->pub = std::make_shared<dds::DDSSerializedPublishHandler>(
+        destination, route.desc, route.topic_name, destination_partition,
+        route.qos);
+    ready = ready && channel->sub->is_ready() && channel->pub->is_ready();
+
+    (route.upstream ? site_channels : upstream_channels).push_back(
+        channel.get());
+    channels.push_back(std::move(channel));
+  }
+
+  if (!ready)
+  {
+    dds_delete(site_participant);
+    if (upstream_participant != site_participant)
+      dds_delete(upstream_participant);
+    return 1;
+  }
+
+  signal(SIGINT, signal_handler);
+  signal(SIGTERM, signal_handler);
+
+  std::vector<std::thread> threads;
+  threads.emplace_back(relay, site_participant, std::cref(site_channels));
+  threads.emplace_back(
+      relay, upstream_participant, std::cref(upstream_channels));
+
+  const auto start_time = std::chrono::steady_clock::now();
+  const auto end_time = options.duration > 0.0 ?
+      start_time +
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              std::chrono::duration<double>(options.duration)) :
+      std::chrono::steady_clock::time_point::max();
+  auto next_report_time = start_time;
+  while (running && std::chrono::steady_clock::now() < end_time)
+  {
+    next_report_time +=
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(options.report_period));
+    while (running &&
+        std::chrono::steady_clock::now() < std::min(next_report_time, end_time))
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    const double elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start_time).count();
+    printf("[%.1fs]\n", elapsed);
+    for (const auto& channel : channels)
+    {
+      const uint64_t sample_num = channel->sample_num.load();
+      printf("  %s relayed %lu (%.1f/s), %lu bytes, %lu failed\n",
+          channel->name.c_str(), sample_num, sample_num / elapsed,
+          channel->byte_num.load(), channel->failure_num.load());
+    }
+    fflush(stdout);
+  }
+
+  running = false;
+  for (auto& thread : threads)
+    thread.join();
+
+  dds_delete(site_participant);
+  if (upstream_participant != site_participant)
+    dds_delete(upstream_participant);
+  return 0;
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+
+#include <dds/dds.h>
+
+#include <free_fleet/ServerConfig.hpp>
+
+#include "dds_utils/DDSSerializedPublishHandler.hpp"
+#include "recording/RecordLog.hpp"
+#include "recording/RecordTopics.hpp"
+
+using namespace free_fleet;
+
+namespace {
+
+struct Options
+{
+  std::string input_path;
+  double speed = 1.0;
+  int loop_num = 1;
+  double discovery_wait = 1.0;
+  ServerConfig topics;
+};
+
+void print_usage()
+{
+  printf("Usage: fleet_replayer -i <file> [options]\n");
+  printf("  -i <file>      record log to replay\n");
+  printf("  -s <factor>    replay speed relative to the recording, as fast\n");
+  printf("                 as possible when not positive (default 1.0)\n");
+  printf("  -l <num>       number of times the log is replayed (default 1)\n");
+  printf("  -w <sec>       time to wait for discovery before replaying\n");
+  printf("                 (default 1.0)\n");
+  printf("  -D <domain>    DDS domain (default 42)\n");
+  printf("  -S <topic>     robot state topic (default robot_state)\n");
+  printf("  -M <topic>     mode request topic (default mode_request)\n");
+  printf("  -P <topic>     path request topic (default path_request)\n");
+  printf("  -G <topic>     destination request topic\n");
+  printf("                 (default destination_request)\n");
+  printf("  -C <topic>     compact robot state topic\n");
+  printf("                 (default compact_robot_state)\n");
+  printf("  -N <topic>     name registry topic (default name_registry)\n");
+  printf("  -E <topic>     priority mode request topic\n");
+  printf("                 (default priority_mode_request)\n");
+  printf("  -B <topic>     fleet path request topic\n");
+  printf("                 (default fleet_path_request)\n");
+  printf("  -X <topic>     extended robot state topic\n");
+  printf("                 (default extended_robot_state)\n");
+  printf("  -Y <topic>     extended path request topic\n");
+  printf("                 (default extended_path_request)\n");
+  printf("  -W <topic>     extended mode request topic\n");
+  printf("                 (default extended_mode_request)\n");
+  printf("  -Z <topic>     extended destination request topic\n");
+  printf("                 (default extended_destination_request)\n");
+}
+
+bool parse_options(int argc, char** argv, Options& options)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg(argv[i]);
+    if (arg == "-h" || arg == "--help" || i + 1 >= argc)
+      return false;
+
+    const char* value = argv[++i];
+    if (arg == "-i")
+      options.input_path = value;
+    else if (arg == "-s")
+      options.speed = std::atof(value);
+    else if (arg == "-l")
+      options.loop_num = std::atoi(value);
+    else if (arg == "-w")
+      options.discovery_wait = std::atof(value);
+    else if (arg == "-D")
+      options.topics.dds_domain = std::atoi(value);
+    else if (arg == "-S")
+      options.topics.dds_robot_state_topic = value;
+    else if (arg == "-M")
+      options.topics.dds_mode_request_topic = value;
+    else if (arg == "-P")
+      options.topics.dds_path_request_topic = value;
+    else if (arg == "-G")
+      options.topics.dds_destination_request_topic = value;
+    else if (arg == "-C")
+      options.topics.dds_compact_robot_state_topic = value;
+    else if (arg == "-N")
+      options.topics.dds_name_registry_topic = value;
+    else if (arg == "-E")
+      options.topics.dds_priority_mode_request_topic = value;
+    else if (arg == "-B")
+      options.topics.dds_fleet_path_request_topic = value;
+    else if (arg == "-X")
+      options.topics.dds_extended_robot_state_topic = value;
+    else if (arg == "-Y")
+      options.topics.dds_extended_path_request_topic = value;
+    else if (arg == "-W")
+      options.topics.dds_extended_mode_request_topic = value;
+    else if (arg == "-Z")
+      options.topics.dds_extended_destination_request_topic = value;
+    else
+      return false;
+  }
+  return !options.input_path.empty() && options.loop_num > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  Options options;
+  if (!parse_options(argc, argv, options))
+  {
+    print_usage();
+    return 1;
+  }
+
+  recording::RecordLogReader::SharedPtr log =
+      recording::RecordLogReader::make(options.input_path);
+  if (!log)
+  {
+    printf("failed to map %s as a record log\n", options.input_path.c_str());
+    return 1;
+  }
+
+  dds_entity_t participant = dds_create_participant(
+      static_cast<dds_domainid_t>(options.topics.dds_domain), NULL, NULL);
+  if (participant < 0)
+  {
+    DDS_FATAL("dds_create_participant: %s\n", dds_strretcode(-participant));
+    return 1;
+  }
+
+  // Indexed by RecordTopic
+  const auto topics = recording::get_record_topics(options.topics);
+  std::array<dds::DDSSerializedPublishHandler::SharedPtr,
+      recording::RecordTopicNum> pubs;
+  for (std::size_t i = 0; i < topics.size(); ++i)
+  {
+    pubs[i] = std::make_shared<dds::DDSSerializedPublishHandler>(
+        participant, topics[i].desc, topics[i].topic_name, "",
+        topics[i].qos);
+    if (!pubs[i]->is_ready())
+    {
+      dds_delete(participant);
+      return 1;
+    }
+  }
+
+  std::this_thread::sleep_for(
+      std::chrono::duration<double>(options.discovery_wait));
+
+  uint64_t record_num = 0;
+  uint64_t byte_num = 0;
+  uint64_t failure_num = 0;
+  const auto start_time = std::chrono::steady_clock::now();
+  for (int loop = 0; loop < options.loop_num; ++loop)
+  {
+    log->rewind();
+
+    recording::RecordLogReader::Record record;
+    bool first = true;
+    int64_t first_stamp = 0;
+    const auto loop_start_time = std::chrono::steady_clock::now();
+    while (log->next(record))
+    {
+      if (first)
+      {
+        first_stamp = record.stamp;
+        first = false;
+      }
+
+      // Keeps the original spacing between samples, scaled by the speed
+      if (options.speed > 0.0)
+      {
+        const double offset =
+            static_cast<double>(record.stamp - first_stamp) / 1e9 /
+            options.speed;
+        std::this_thread::sleep_until(loop_start_time +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(offset)));
+      }
+
+      if (!pubs[static_cast<std::size_t>(record.topic)]->write(
+          record.data, record.size))
+        ++failure_num;
+      ++record_num;
+      byte_num += record.size;
+    }
+  }
+
+  const double elapsed = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start_time).count();
+  printf("replayed %lu samples, %lu bytes in %.3fs (%.1f samples/s), "
+      "%lu failed writes\n",
+      record_num, byte_num, elapsed,
+      elapsed > 0.0 ? record_num / elapsed : 0.0, failure_num);
+
+  dds_delete(participant);
+  return failure_num == 0 ? 0 : 1;
+}
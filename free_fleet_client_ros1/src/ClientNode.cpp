@@ -82,6 +82,9 @@ ClientNode::ClientNode(const ClientNodeConfig& _config) :
 
 ClientNode::~ClientNode()
 {
+  if (robot_pose_spinner)
+    robot_pose_spinner->stop();
+
   if (update_thread.joinable())
   {
     update_thread.join();
@@ -93,6 +96,12 @@ ClientNode::~ClientNode()
     publish_thread.join();
     ROS_INFO("Client: publish_thread joined.");
   }
+
+  if (priority_thread.joinable())
+  {
+    priority_thread.join();
+    ROS_INFO("Client: priority_thread joined.");
+  }
 }
 
 void ClientNode::start(Fields _fields)
@@ -106,9 +115,63 @@ void ClientNode::start(Fields _fields)
       client_node_config.battery_state_topic, 1,
       &ClientNode::battery_state_callback_fn, this);
 
-  request_error = false;
-  emergency = false;
-  paused = false;
+  MotionHistory::Thresholds motion_thresholds;
+  motion_thresholds.moving_linear_speed =
+      client_node_config.moving_linear_speed_threshold;
+  motion_thresholds.moving_angular_speed =
+      client_node_config.moving_angular_speed_threshold;
+  motion_thresholds.idle_linear_speed =
+      client_node_config.idle_linear_speed_threshold;
+  motion_thresholds.idle_angular_speed =
+      client_node_config.idle_angular_speed_threshold;
+  motion_history.reset(new MotionHistory(
+      static_cast<std::size_t>(client_node_config.motion_history_size),
+      motion_thresholds));
+
+  robot_pose_node.reset(new ros::NodeHandle(*node));
+  robot_pose_node->setCallbackQueue(&robot_pose_callback_queue);
+  if (client_node_config.robot_pose_topic != "")
+  {
+    ROS_INFO("Client: using robot pose topic: %s",
+        client_node_config.robot_pose_topic.c_str());
+    robot_pose_sub = robot_pose_node->subscribe(
+        client_node_config.robot_pose_topic, 1,
+        &ClientNode::robot_pose_callback_fn, this);
+  }
+  else
+  {
+    robot_pose_timer = robot_pose_node->createTimer(
+        ros::Duration(1.0 / client_node_config.update_frequency),
+        &ClientNode::robot_pose_timer_fn, this);
+  }
+  robot_pose_spinner.reset(
+      new ros::AsyncSpinner(1, &robot_pose_callback_queue));
+  robot_pose_spinner->start();
+
+  Metrics::SharedPtr metrics = fields.client->get_metrics();
+  const Metrics::Labels robot_labels =
+      {{"robot", client_node_config.robot_name}};
+  goal_queue_depth_gauge = &metrics->gauge(
+      "free_fleet_client_goal_queue_depth",
+      "Number of goals of the current request not reached yet.",
+      robot_labels);
+  robot_pose_age_gauge = &metrics->gauge(
+      "free_fleet_client_robot_pose_age_seconds",
+      "Age of the latest robot pose when the robot state was updated.",
+      robot_labels);
+  stop_time_histogram = &metrics->histogram(
+      "free_fleet_client_stop_seconds",
+      "Time from receiving a priority pause or emergency request until the "
+      "goals were cancelled.",
+      robot_labels);
+  if (client_node_config.metrics_port > 0)
+  {
+    metrics_server =
+        MetricsServer::make(metrics, client_node_config.metrics_port);
+    if (!metrics_server)
+      ROS_ERROR("Client: unable to serve metrics on port %d.",
+          client_node_config.metrics_port);
+  }
 
   ROS_INFO("Client: starting update thread.");
   update_thread = std::thread(std::bind(&ClientNode::update_thread_fn, this));
@@ -116,6 +179,13 @@ void ClientNode::start(Fields _fields)
   ROS_INFO("Client: starting publish thread.");
   publish_thread = 
       std::thread(std::bind(&ClientNode::publish_thread_fn, this));
+
+  if (client_node_config.dds_priority_mode_request)
+  {
+    ROS_INFO("Client: starting priority thread.");
+    priority_thread =
+        std::thread(std::bind(&ClientNode::priority_thread_fn, this));
+  }
 }
 
 void ClientNode::print_config()
@@ -123,63 +193,130 @@ void ClientNode::print_config()
   client_node_config.print_config();
 }
 
+ClientNode::StateSnapshotReader ClientNode::get_state_snapshot() const
+{
+  return state_snapshot.read();
+}
+
+void ClientNode::update_state_snapshot(
+    const std::function<void(StateSnapshot&)>& _update_fn)
+{
+  state_snapshot.update([&](StateSnapshot& _snapshot)
+  {
+    _update_fn(_snapshot);
+    ++_snapshot.version;
+  });
+}
+
 void ClientNode::battery_state_callback_fn(
     const sensor_msgs::BatteryState& _msg)
 {
-  WriteLock battery_state_lock(battery_state_mutex);
-  current_battery_state = _msg;
+  update_state_snapshot([&](StateSnapshot& snapshot)
+  {
+    snapshot.battery_state = _msg;
+  });
 }
 
-bool ClientNode::get_robot_transform()
+void ClientNode::robot_pose_callback_fn(
+    const geometry_msgs::PoseWithCovarianceStamped& _msg)
 {
+  if (_msg.header.frame_id != client_node_config.map_frame)
+  {
+    ROS_WARN_THROTTLE(5.0, "robot pose is in frame %s instead of %s, ignoring.",
+        _msg.header.frame_id.c_str(), client_node_config.map_frame.c_str());
+    return;
+  }
+
+  geometry_msgs::TransformStamped tmp_transform_stamped;
+  tmp_transform_stamped.header = _msg.header;
+  tmp_transform_stamped.child_frame_id = client_node_config.robot_frame;
+  tmp_transform_stamped.transform.translation.x = _msg.pose.pose.position.x;
+  tmp_transform_stamped.transform.translation.y = _msg.pose.pose.position.y;
+  tmp_transform_stamped.transform.translation.z = _msg.pose.pose.position.z;
+  tmp_transform_stamped.transform.rotation = _msg.pose.pose.orientation;
+
+  WriteLock cached_robot_pose_lock(cached_robot_pose_mutex);
+  cached_robot_pose = tmp_transform_stamped;
+  cached_robot_pose_valid = true;
+}
+
+void ClientNode::robot_pose_timer_fn(const ros::TimerEvent&)
+{
+  // Checking first avoids throwing and catching an exception on every tick
+  // while localization is lost.
+  std::string error_msg;
+  if (!tf2_buffer.canTransform(
+      client_node_config.map_frame,
+      client_node_config.robot_frame,
+      ros::Time(0),
+      &error_msg))
+  {
+    ROS_WARN_THROTTLE(5.0, "%s", error_msg.c_str());
+    return;
+  }
+
   try {
     geometry_msgs::TransformStamped tmp_transform_stamped = 
         tf2_buffer.lookupTransform(
             client_node_config.map_frame,
             client_node_config.robot_frame,
             ros::Time(0));
-    WriteLock robot_transform_lock(robot_transform_mutex);
-    previous_robot_transform = current_robot_transform;
-    current_robot_transform = tmp_transform_stamped;
+    WriteLock cached_robot_pose_lock(cached_robot_pose_mutex);
+    cached_robot_pose = tmp_transform_stamped;
+    cached_robot_pose_valid = true;
   }
   catch (tf2::TransformException &ex) {
-    ROS_WARN("%s", ex.what());
-    return false;
+    ROS_WARN_THROTTLE(5.0, "%s", ex.what());
+  }
+}
+
+bool ClientNode::get_robot_transform()
+{
+  geometry_msgs::TransformStamped tmp_transform_stamped;
+  {
+    ReadLock cached_robot_pose_lock(cached_robot_pose_mutex);
+    if (!cached_robot_pose_valid)
+      return false;
+    tmp_transform_stamped = cached_robot_pose;
   }
+
+  const ros::Time now = ros::Time::now();
+  robot_pose_age_gauge->set((now - tmp_transform_stamped.header.stamp).toSec());
+
+  motion_history->add(tmp_transform_stamped);
+  const bool moving = motion_history->is_moving();
+
+  update_state_snapshot([&](StateSnapshot& snapshot)
+  {
+    snapshot.current_robot_transform = tmp_transform_stamped;
+    snapshot.moving = moving;
+  });
   return true;
 }
 
-messages::RobotMode ClientNode::get_robot_mode()
+messages::RobotMode ClientNode::get_robot_mode(
+    const StateSnapshot& _snapshot) const
 {
   /// Checks if robot has just received a request that causes an adapter error
-  if (request_error)
+  if (_snapshot.request_error)
     return messages::RobotMode{messages::RobotMode::MODE_REQUEST_ERROR};
 
   /// Checks if robot is under emergency
-  if (emergency)
+  if (_snapshot.emergency)
     return messages::RobotMode{messages::RobotMode::MODE_EMERGENCY};
 
   /// Checks if robot is charging
-  {
-    ReadLock battery_state_lock(battery_state_mutex);
-
-    if (current_battery_state.power_supply_status ==
-        current_battery_state.POWER_SUPPLY_STATUS_CHARGING)
-      return messages::RobotMode{messages::RobotMode::MODE_CHARGING};
-  }
+  if (_snapshot.battery_state.power_supply_status ==
+      _snapshot.battery_state.POWER_SUPPLY_STATUS_CHARGING)
+    return messages::RobotMode{messages::RobotMode::MODE_CHARGING};
 
   /// Checks if robot is moving
-  {
-    ReadLock robot_transform_lock(robot_transform_mutex);
-
-    if (!is_transform_close(
-        current_robot_transform, previous_robot_transform))
-      return messages::RobotMode{messages::RobotMode::MODE_MOVING};
-  }
+  if (_snapshot.moving)
+    return messages::RobotMode{messages::RobotMode::MODE_MOVING};
   
   /// Otherwise, robot is neither charging nor moving,
   /// Checks if the robot is paused
-  if (paused)
+  if (_snapshot.paused)
     return messages::RobotMode{messages::RobotMode::MODE_PAUSED};
 
   /// Otherwise, robot has queued tasks, it is paused or waiting,
@@ -189,60 +326,66 @@ messages::RobotMode ClientNode::get_robot_mode()
 
 void ClientNode::publish_robot_state()
 {
+  /// Everything is read off a single snapshot, so the published state is
+  /// always consistent with itself
+  StateSnapshotReader snapshot = get_state_snapshot();
+
   messages::RobotState new_robot_state;
   new_robot_state.name = client_node_config.robot_name;
   new_robot_state.model = client_node_config.robot_model;
+  new_robot_state.task_id = snapshot->task_id;
+  new_robot_state.mode = get_robot_mode(*snapshot);
+
+  /// RMF expects battery to have a percentage in the range for 0-100.
+  /// sensor_msgs/BatteryInfo on the other hand returns a value in 
+  /// the range of 0-1
+  new_robot_state.battery_percent = 100*snapshot->battery_state.percentage;
+
+  const geometry_msgs::TransformStamped& current_robot_transform =
+      snapshot->current_robot_transform;
+  new_robot_state.location.sec = current_robot_transform.header.stamp.sec;
+  new_robot_state.location.nanosec = 
+      current_robot_transform.header.stamp.nsec;
+  new_robot_state.location.x = 
+      current_robot_transform.transform.translation.x;
+  new_robot_state.location.y = 
+      current_robot_transform.transform.translation.y;
+  new_robot_state.location.yaw = 
+      get_yaw_from_transform(current_robot_transform);
+  new_robot_state.location.level_name = client_node_config.level_name;
+
+  if (snapshot->path)
+    new_robot_state.path = *snapshot->path;
 
-  {
-    ReadLock task_id_lock(task_id_mutex);
-    new_robot_state.task_id = current_task_id;    
-  }
-
-  new_robot_state.mode = get_robot_mode();
-
-  {
-    ReadLock battery_state_lock(battery_state_mutex);
-    /// RMF expects battery to have a percentage in the range for 0-100.
-    /// sensor_msgs/BatteryInfo on the other hand returns a value in 
-    /// the range of 0-1
-    new_robot_state.battery_percent = 100*current_battery_state.percentage;
-  }
+  if (!fields.client->send_robot_state(new_robot_state))
+    ROS_WARN("failed to send robot state: msg sec %u, snapshot version %lu",
+        new_robot_state.location.sec, snapshot->version);
+}
 
+void ClientNode::update_path_snapshot()
+{
+  std::vector<messages::Location> path;
+  path.reserve(goal_path.size());
+  for (size_t i = 0; i < goal_path.size(); ++i)
   {
-    ReadLock robot_transform_lock(robot_transform_mutex);
-    new_robot_state.location.sec = current_robot_transform.header.stamp.sec;
-    new_robot_state.location.nanosec = 
-        current_robot_transform.header.stamp.nsec;
-    new_robot_state.location.x = 
-        current_robot_transform.transform.translation.x;
-    new_robot_state.location.y = 
-        current_robot_transform.transform.translation.y;
-    new_robot_state.location.yaw = 
-        get_yaw_from_transform(current_robot_transform);
-    new_robot_state.location.level_name = client_node_config.level_name;
+    path.push_back(
+        messages::Location{
+            (int32_t)goal_path[i].goal.target_pose.header.stamp.sec,
+            goal_path[i].goal.target_pose.header.stamp.nsec,
+            (float)goal_path[i].goal.target_pose.pose.position.x,
+            (float)goal_path[i].goal.target_pose.pose.position.y,
+            (float)(get_yaw_from_quat(
+                goal_path[i].goal.target_pose.pose.orientation)),
+            goal_path[i].level_name
+        });
   }
 
-  new_robot_state.path.clear();
+  update_state_snapshot([&](StateSnapshot& snapshot)
   {
-    ReadLock goal_path_lock(goal_path_mutex);
-
-    for (size_t i = 0; i < goal_path.size(); ++i)
-    {
-      new_robot_state.path.push_back(
-          messages::Location{
-              (int32_t)goal_path[i].goal.target_pose.header.stamp.sec,
-              goal_path[i].goal.target_pose.header.stamp.nsec,
-              (float)goal_path[i].goal.target_pose.pose.position.x,
-              (float)goal_path[i].goal.target_pose.pose.position.y,
-              (float)(get_yaw_from_quat(
-                  goal_path[i].goal.target_pose.pose.orientation)),
-              goal_path[i].level_name
-          });
-    }
-  }
-
-  if (!fields.client->send_robot_state(new_robot_state))
-    ROS_WARN("failed to send robot state: msg sec %u", new_robot_state.location.sec);
+    snapshot.path =
+        std::make_shared<const std::vector<messages::Location>>(
+            std::move(path));
+  });
 }
 
 bool ClientNode::is_valid_request(
@@ -250,8 +393,7 @@ bool ClientNode::is_valid_request(
     const std::string& _request_robot_name,
     const std::string& _request_task_id)
 {
-  ReadLock task_id_lock(task_id_mutex);
-  if (current_task_id == _request_task_id ||
+  if (get_state_snapshot()->task_id == _request_task_id ||
       client_node_config.robot_name != _request_robot_name ||
       client_node_config.fleet_name != _request_fleet_name)
     return false;
@@ -272,6 +414,91 @@ move_base_msgs::MoveBaseGoal ClientNode::location_to_move_base_goal(
   return goal;
 }
 
+ros::Time ClientNode::to_client_time(const messages::Location& _location) const
+{
+  ros::Time server_time(_location.sec, _location.nanosec);
+
+  // Unscheduled waypoints are left as they are
+  int64_t offset_nanosec = 0;
+  if (!client_node_config.correct_server_clock_offset ||
+      server_time.isZero() ||
+      !fields.client->get_server_clock_offset(offset_nanosec))
+    return server_time;
+
+  ros::Duration offset;
+  offset.fromNSec(offset_nanosec);
+  return server_time + offset;
+}
+
+bool ClientNode::is_path_schedule_feasible(
+    const std::vector<messages::Location>& _path,
+    const StateSnapshot& _snapshot) const
+{
+  if (client_node_config.max_linear_velocity <= 0.0)
+    return true;
+
+  const ros::Time now = ros::Time::now();
+  double prev_x = _snapshot.current_robot_transform.transform.translation.x;
+  double prev_y = _snapshot.current_robot_transform.transform.translation.y;
+  double distance = 0.0;
+  for (size_t i = 0; i < _path.size(); ++i)
+  {
+    const double dx = _path[i].x - prev_x;
+    const double dy = _path[i].y - prev_y;
+    distance += sqrt(dx*dx + dy*dy);
+    prev_x = _path[i].x;
+    prev_y = _path[i].y;
+
+    const ros::Time scheduled_time = to_client_time(_path[i]);
+    if (scheduled_time.isZero())
+      continue;
+
+    const ros::Time earliest_arrival_time =
+        now + ros::Duration(distance / client_node_config.max_linear_velocity);
+    const double lateness = (earliest_arrival_time - scheduled_time).toSec();
+    if (lateness > client_node_config.path_schedule_tolerance)
+    {
+      ROS_WARN("waypoint %lu would be reached %.1f seconds late.", i, lateness);
+      return false;
+    }
+  }
+  return true;
+}
+
+void ClientNode::reject_path_request()
+{
+  fields.move_base_client->cancelAllGoals();
+  goal_path.clear();
+
+  update_state_snapshot([](StateSnapshot& snapshot)
+  {
+    snapshot.path.reset();
+    snapshot.request_error = true;
+    snapshot.emergency = false;
+    snapshot.paused = false;
+  });
+}
+
+void ClientNode::apply_mode(
+    const messages::RobotMode& _mode, StateSnapshot& _snapshot)
+{
+  if (_mode.mode == messages::RobotMode::MODE_PAUSED)
+  {
+    _snapshot.paused = true;
+    _snapshot.emergency = false;
+  }
+  else if (_mode.mode == messages::RobotMode::MODE_MOVING)
+  {
+    _snapshot.paused = false;
+    _snapshot.emergency = false;
+  }
+  else if (_mode.mode == messages::RobotMode::MODE_EMERGENCY)
+  {
+    _snapshot.paused = false;
+    _snapshot.emergency = true;
+  }
+}
+
 bool ClientNode::read_mode_request()
 {
   messages::ModeRequest mode_request;
@@ -285,24 +512,16 @@ bool ClientNode::read_mode_request()
       ROS_INFO("received a PAUSE command.");
 
       fields.move_base_client->cancelAllGoals();
-      WriteLock goal_path_lock(goal_path_mutex);
       if (!goal_path.empty())
         goal_path[0].sent = false;
-
-      paused = true;
-      emergency = false;
     }
     else if (mode_request.mode.mode == messages::RobotMode::MODE_MOVING)
     {
       ROS_INFO("received an explicit RESUME command.");
-      paused = false;
-      emergency = false;
     }
     else if (mode_request.mode.mode == messages::RobotMode::MODE_EMERGENCY)
     {
       ROS_INFO("received an EMERGENCY command.");
-      paused = false;
-      emergency = true;
     }
     else if (mode_request.mode.mode == messages::RobotMode::MODE_DOCKING)
     {
@@ -316,21 +535,71 @@ bool ClientNode::read_mode_request()
         {
           ROS_ERROR("Failed to trigger docking sequence, message: %s.",
             trigger_srv.response.message.c_str());
-          request_error = true;
+          update_state_snapshot([&](StateSnapshot& new_snapshot)
+          {
+            new_snapshot.request_error = true;
+          });
           return false;
         }
       }
     }
 
-    WriteLock task_id_lock(task_id_mutex);
-    current_task_id = mode_request.task_id;
-
-    request_error = false;
+    update_state_snapshot([&](StateSnapshot& new_snapshot)
+    {
+      new_snapshot.task_id = mode_request.task_id;
+      apply_mode(mode_request.mode, new_snapshot);
+      new_snapshot.request_error = false;
+    });
+    fields.client->get_tracer()->stamp(
+        mode_request.trace, "client_mode_applied");
     return true;
   }
   return false;
 }
 
+void ClientNode::handle_priority_mode_request(
+    const messages::ModeRequest& _mode_request)
+{
+  const auto start_time = std::chrono::steady_clock::now();
+  const bool stop =
+      _mode_request.mode.mode == messages::RobotMode::MODE_PAUSED ||
+      _mode_request.mode.mode == messages::RobotMode::MODE_EMERGENCY;
+
+  {
+    std::lock_guard<std::mutex> goal_lock(goal_mutex);
+    if (stop)
+    {
+      fields.move_base_client->cancelAllGoals();
+      goals_cancelled = true;
+    }
+
+    // The snapshot is updated before the lock is released, so the update
+    // thread sees the robot paused before it can send another goal
+    update_state_snapshot([&](StateSnapshot& new_snapshot)
+    {
+      new_snapshot.task_id = _mode_request.task_id;
+      apply_mode(_mode_request.mode, new_snapshot);
+      new_snapshot.request_error = false;
+    });
+  }
+
+  if (stop)
+  {
+    const double stop_time = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start_time).count();
+    stop_time_histogram->observe(stop_time);
+    ROS_INFO("received a priority %s command, goals cancelled in %.3f ms.",
+        _mode_request.mode.mode == messages::RobotMode::MODE_PAUSED ?
+            "PAUSE" : "EMERGENCY",
+        stop_time * 1e3);
+  }
+  else
+    ROS_INFO("received a priority RESUME command.");
+
+  fields.client->get_tracer()->stamp(
+      _mode_request.trace, "client_mode_applied");
+}
+
 bool ClientNode::read_path_request()
 {
   messages::PathRequest path_request;
@@ -346,8 +615,10 @@ bool ClientNode::read_path_request()
 
     // Sanity check: the first waypoint of the Path must be within N meters of
     // our current position. Otherwise, ignore the request.
+    StateSnapshotReader snapshot = get_state_snapshot();
     {
-      ReadLock robot_transform_lock(robot_transform_mutex);
+      const geometry_msgs::TransformStamped& current_robot_transform =
+          snapshot->current_robot_transform;
       const double dx =
           path_request.path[0].x - 
           current_robot_transform.transform.translation.x;
@@ -365,18 +636,23 @@ bool ClientNode::read_path_request()
             "waiting for next valid request.\n",
             client_node_config.max_dist_to_first_waypoint);
         
-        fields.move_base_client->cancelAllGoals();
-        WriteLock goal_path_lock(goal_path_mutex);
-        goal_path.clear();
-
-        request_error = true;
-        emergency = false;
-        paused = false;
+        reject_path_request();
         return false;
       }
     }
 
-    WriteLock goal_path_lock(goal_path_mutex);
+    // Sanity check: the schedule of the path must still be achievable from
+    // our current position. Otherwise, ignore the request instead of
+    // executing it late.
+    if (!is_path_schedule_feasible(path_request.path, *snapshot))
+    {
+      ROS_WARN("path schedule is no longer feasible ! Rejecting path, "
+          "waiting for next valid request.\n");
+
+      reject_path_request();
+      return false;
+    }
+
     goal_path.clear();
     for (size_t i = 0; i < path_request.path.size(); ++i)
     {
@@ -385,17 +661,20 @@ bool ClientNode::read_path_request()
               path_request.path[i].level_name,
               location_to_move_base_goal(path_request.path[i]),
               false,
-              ros::Time(
-                  path_request.path[i].sec, path_request.path[i].nanosec)});
+              to_client_time(path_request.path[i])});
     }
+    goal_path_trace = path_request.trace;
+    fields.client->get_tracer()->stamp(goal_path_trace, "client_node_accept");
 
-    WriteLock task_id_lock(task_id_mutex);
-    current_task_id = path_request.task_id;
-
-    if (paused)
-      paused = false;
-
-    request_error = false;
+    update_state_snapshot([&](StateSnapshot& new_snapshot)
+    {
+      new_snapshot.path =
+          std::make_shared<const std::vector<messages::Location>>(
+              path_request.path);
+      new_snapshot.task_id = path_request.task_id;
+      new_snapshot.paused = false;
+      new_snapshot.request_error = false;
+    });
     return true;
   }
   return false;
@@ -413,24 +692,25 @@ bool ClientNode::read_destination_request()
         destination_request.destination.x, destination_request.destination.y,
         destination_request.destination.yaw);
     
-    WriteLock goal_path_lock(goal_path_mutex);
     goal_path.clear();
     goal_path.push_back(
         Goal {
             destination_request.destination.level_name,
             location_to_move_base_goal(destination_request.destination),
             false,
-            ros::Time(
-                destination_request.destination.sec, 
-                destination_request.destination.nanosec)});
+            to_client_time(destination_request.destination)});
+    goal_path_trace = destination_request.trace;
+    fields.client->get_tracer()->stamp(goal_path_trace, "client_node_accept");
 
-    WriteLock task_id_lock(task_id_mutex);
-    current_task_id = destination_request.task_id;
-
-    if (paused)
-      paused = false;
-
-    request_error = false;
+    update_state_snapshot([&](StateSnapshot& new_snapshot)
+    {
+      new_snapshot.path =
+          std::make_shared<const std::vector<messages::Location>>(
+              1, destination_request.destination);
+      new_snapshot.task_id = destination_request.task_id;
+      new_snapshot.paused = false;
+      new_snapshot.request_error = false;
+    });
     return true;
   }
   return false;
@@ -444,14 +724,43 @@ void ClientNode::read_requests()
     return;
 }
 
+bool ClientNode::is_within_lookahead(const StateSnapshot& _snapshot) const
+{
+  if (client_node_config.path_lookahead_radius <= 0.0 ||
+      goal_path.size() < 2)
+    return false;
+
+  // Level changes are never blended, the robot has to properly arrive
+  const Goal& current_goal = goal_path[0];
+  const Goal& next_goal = goal_path[1];
+  if (current_goal.level_name != next_goal.level_name)
+    return false;
+
+  const double dx =
+      current_goal.goal.target_pose.pose.position.x -
+      _snapshot.current_robot_transform.transform.translation.x;
+  const double dy =
+      current_goal.goal.target_pose.pose.position.y -
+      _snapshot.current_robot_transform.transform.translation.y;
+  return sqrt(dx*dx + dy*dy) <= client_node_config.path_lookahead_radius;
+}
+
 void ClientNode::handle_requests()
 {
+  std::lock_guard<std::mutex> goal_lock(goal_mutex);
+  if (goals_cancelled)
+  {
+    if (!goal_path.empty())
+      goal_path[0].sent = false;
+    goals_cancelled = false;
+  }
+
   // there is an emergency or the robot is paused
-  if (emergency || request_error || paused)
+  StateSnapshotReader snapshot = get_state_snapshot();
+  if (snapshot->emergency || snapshot->request_error || snapshot->paused)
     return;
 
   // ooooh we have goals
-  WriteLock goal_path_lock(goal_path_mutex);
   if (!goal_path.empty())
   {
     // Goals must have been updated since last handling, execute them now
@@ -460,6 +769,10 @@ void ClientNode::handle_requests()
       ROS_INFO("sending next goal.");
       fields.move_base_client->sendGoal(goal_path.front().goal);
       goal_path.front().sent = true;
+
+      // Only the first goal of a request is traced
+      fields.client->get_tracer()->stamp(goal_path_trace, "client_goal_sent");
+      goal_path_trace = messages::Trace();
       return;
     }
 
@@ -475,6 +788,7 @@ void ClientNode::handle_requests()
       if (ros::Time::now() >= goal_path.front().goal_end_time)
       {
         goal_path.pop_front();
+        update_path_snapshot();
       }
       else
       {
@@ -488,6 +802,18 @@ void ClientNode::handle_requests()
     }
     else if (current_goal_state == GoalState::ACTIVE)
     {
+      // With look-ahead enabled, the next waypoint is streamed to move_base
+      // as soon as the robot is close enough to the current one and the
+      // schedule allows it to move on, so it does not stop at every waypoint.
+      if (is_within_lookahead(*snapshot) &&
+          ros::Time::now() >= goal_path.front().goal_end_time)
+      {
+        ROS_INFO("within look-ahead radius, sending next goal.");
+        goal_path.pop_front();
+        update_path_snapshot();
+        fields.move_base_client->sendGoal(goal_path.front().goal);
+        goal_path.front().sent = true;
+      }
       return;
     }
     else
@@ -501,8 +827,47 @@ void ClientNode::handle_requests()
   // otherwise, mode is correct, nothing in queue, nothing else to do then
 }
 
+void ClientNode::report_traces()
+{
+  if (client_node_config.trace_report_period <= 0.0)
+    return;
+
+  const ros::WallTime now = ros::WallTime::now();
+  if (now < next_trace_report_time)
+    return;
+  next_trace_report_time =
+      now + ros::WallDuration(client_node_config.trace_report_period);
+
+  const std::vector<Tracer::StageStatistics> statistics =
+      fields.client->get_tracer()->get_statistics();
+  if (!statistics.empty())
+    ROS_INFO("request latencies:\n%s",
+        fields.client->get_tracer()->dump().c_str());
+}
+
+void ClientNode::write_metrics_file()
+{
+  if (client_node_config.metrics_file.empty() ||
+      client_node_config.metrics_file_period <= 0.0)
+    return;
+
+  const ros::WallTime now = ros::WallTime::now();
+  if (now < next_metrics_file_time)
+    return;
+  next_metrics_file_time =
+      now + ros::WallDuration(client_node_config.metrics_file_period);
+
+  if (!fields.client->get_metrics()->write_to_file(
+      client_node_config.metrics_file))
+    ROS_WARN("Client: unable to write metrics to %s",
+        client_node_config.metrics_file.c_str());
+}
+
 void ClientNode::update_thread_fn()
 {
+  next_trace_report_time =
+      ros::WallTime::now() +
+      ros::WallDuration(client_node_config.trace_report_period);
   while (node->ok())
   {
     update_rate->sleep();
@@ -513,6 +878,25 @@ void ClientNode::update_thread_fn()
     read_requests();
 
     handle_requests();
+    goal_queue_depth_gauge->set(static_cast<double>(goal_path.size()));
+
+    report_traces();
+
+    write_metrics_file();
+  }
+}
+
+void ClientNode::priority_thread_fn()
+{
+  // The timeout only bounds how long it takes to notice a shutdown
+  while (node->ok())
+  {
+    messages::ModeRequest mode_request;
+    if (fields.client->wait_priority_mode_request(mode_request, 0.1) &&
+        is_valid_request(
+            mode_request.fleet_name, mode_request.robot_name,
+            mode_request.task_id))
+      handle_priority_mode_request(mode_request);
   }
 }
 
@@ -19,26 +19,36 @@
 #define FREE_FLEET_CLIENT_ROS1__SRC__CLIENTNODE_HPP
 
 #include <deque>
+#include <chrono>
 #include <mutex>
-#include <atomic>
 #include <memory>
 #include <thread>
 #include <vector>
+#include <cstdint>
+#include <functional>
 
 #include <ros/ros.h>
+#include <ros/spinner.h>
+#include <ros/callback_queue.h>
 #include <std_msgs/String.h>
 #include <std_srvs/Trigger.h>
 #include <sensor_msgs/BatteryState.h>
 #include <tf2_ros/transform_listener.h>
 #include <geometry_msgs/TransformStamped.h>
+#include <geometry_msgs/PoseWithCovarianceStamped.h>
 
 #include <move_base_msgs/MoveBaseGoal.h>
 #include <move_base_msgs/MoveBaseAction.h>
 #include <actionlib/client/simple_action_client.h>
 
 #include <free_fleet/Client.hpp>
+#include <free_fleet/Metrics.hpp>
+#include <free_fleet/MetricsServer.hpp>
+#include <free_fleet/messages/Trace.hpp>
 #include <free_fleet/messages/Location.hpp>
 
+#include "MotionHistory.hpp"
+#include "SnapshotBuffer.hpp"
 #include "ClientNodeConfig.hpp"
 
 namespace free_fleet
@@ -79,6 +89,47 @@ public:
 
 private:
 
+  // --------------------------------------------------------------------------
+  // Robot state snapshot
+
+  /// Versioned snapshot of everything that goes into a published robot
+  /// state. Writers update a copy of the latest snapshot and publish it,
+  /// readers such as the publish thread pin the latest one without locking,
+  /// see SnapshotBuffer.
+  struct StateSnapshot
+  {
+    uint64_t version = 0;
+
+    sensor_msgs::BatteryState battery_state;
+
+    geometry_msgs::TransformStamped current_robot_transform;
+
+    /// Classified over the recent motion history by the update thread
+    bool moving = false;
+
+    std::string task_id;
+
+    /// Shared between versions, so that updating any other field does not
+    /// copy it, null when there is no path
+    std::shared_ptr<const std::vector<messages::Location>> path;
+
+    // TODO: conditions to trigger emergency, however this is most likely for
+    // indicating emergency within the fleet and not in RMF
+    // TODO: figure out a better way to handle multiple triggered modes
+    bool request_error = false;
+    bool emergency = false;
+    bool paused = false;
+  };
+
+  using StateSnapshotReader = SnapshotBuffer<StateSnapshot>::Reader;
+
+  SnapshotBuffer<StateSnapshot> state_snapshot;
+
+  StateSnapshotReader get_state_snapshot() const;
+
+  void update_state_snapshot(
+      const std::function<void(StateSnapshot&)>& update_fn);
+
   // --------------------------------------------------------------------------
   // Basic ROS 1 items
 
@@ -93,10 +144,6 @@ private:
 
   ros::Subscriber battery_percent_sub;
 
-  std::mutex battery_state_mutex;
-
-  sensor_msgs::BatteryState current_battery_state;
-
   void battery_state_callback_fn(const sensor_msgs::BatteryState& msg);
 
   // --------------------------------------------------------------------------
@@ -106,31 +153,77 @@ private:
 
   tf2_ros::TransformListener tf2_listener;
 
-  std::mutex robot_transform_mutex;
+  /// The latest map to robot pose is acquired on a dedicated callback queue
+  /// and spinner, either from TF or from a localization pose topic, and
+  /// cached here for the update thread to pick up.
+  std::unique_ptr<ros::NodeHandle> robot_pose_node;
+
+  ros::CallbackQueue robot_pose_callback_queue;
+
+  std::unique_ptr<ros::AsyncSpinner> robot_pose_spinner;
+
+  ros::Subscriber robot_pose_sub;
+
+  ros::Timer robot_pose_timer;
+
+  std::mutex cached_robot_pose_mutex;
+
+  geometry_msgs::TransformStamped cached_robot_pose;
+
+  bool cached_robot_pose_valid = false;
+
+  void robot_pose_callback_fn(
+      const geometry_msgs::PoseWithCovarianceStamped& msg);
 
-  geometry_msgs::TransformStamped current_robot_transform;
+  void robot_pose_timer_fn(const ros::TimerEvent& event);
 
-  geometry_msgs::TransformStamped previous_robot_transform;
+  /// Only ever accessed by the update thread
+  std::unique_ptr<MotionHistory> motion_history;
 
   bool get_robot_transform();
 
   // --------------------------------------------------------------------------
   // Mode handling
 
-  // TODO: conditions to trigger emergency, however this is most likely for
-  // indicating emergency within the fleet and not in RMF
-  // TODO: figure out a better way to handle multiple triggered modes
-  std::atomic<bool> request_error;
-  std::atomic<bool> emergency;
-  std::atomic<bool> paused;
+  messages::RobotMode get_robot_mode(const StateSnapshot& snapshot) const;
 
-  messages::RobotMode get_robot_mode();
+  /// Sets the paused and emergency flags of a snapshot for the requested
+  /// mode, leaving them untouched for any other mode.
+  static void apply_mode(
+      const messages::RobotMode& mode, StateSnapshot& snapshot);
 
   bool read_mode_request();
 
+  /// Held by the priority thread while it cancels the goals and pauses the
+  /// robot, and by the update thread while it decides to send a goal, so
+  /// that no goal is ever sent after a stop was handled.
+  std::mutex goal_mutex;
+
+  /// Set by the priority thread once it cancelled the goals, so that the
+  /// update thread sends the current goal again on resume. Guarded by
+  /// goal_mutex.
+  bool goals_cancelled = false;
+
+  Metrics::Histogram* stop_time_histogram = nullptr;
+
+  void handle_priority_mode_request(
+      const messages::ModeRequest& mode_request);
+
   // --------------------------------------------------------------------------
   // Path request handling
 
+  /// Converts the time of a location scheduled by the server into this
+  /// client's clock, using the estimated clock offset if configured.
+  ros::Time to_client_time(const messages::Location& location) const;
+
+  /// Checks if every scheduled waypoint of the path can still be reached in
+  /// time, travelling at the configured maximum velocity.
+  bool is_path_schedule_feasible(
+      const std::vector<messages::Location>& path,
+      const StateSnapshot& snapshot) const;
+
+  void reject_path_request();
+
   bool read_path_request();
 
   // --------------------------------------------------------------------------
@@ -149,10 +242,6 @@ private:
   move_base_msgs::MoveBaseGoal location_to_move_base_goal(
       const messages::Location& location) const;
 
-  std::mutex task_id_mutex;
-
-  std::string current_task_id;
-
   struct Goal
   {
     std::string level_name;
@@ -161,10 +250,20 @@ private:
     ros::Time goal_end_time;
   };
 
-  std::mutex goal_path_mutex;
-
+  /// Only ever accessed by the update thread, the publish thread sees the
+  /// path through the state snapshot.
   std::deque<Goal> goal_path;
 
+  /// Trace of the request that produced the goal path, stamped once its first
+  /// goal is sent to move_base. Only ever accessed by the update thread.
+  messages::Trace goal_path_trace;
+
+  void update_path_snapshot();
+
+  /// Checks if the next goal in the path can already be sent, as the robot
+  /// is within the configured look-ahead radius of the current goal.
+  bool is_within_lookahead(const StateSnapshot& snapshot) const;
+
   void read_requests();
 
   void handle_requests();
@@ -178,8 +277,30 @@ private:
 
   std::thread publish_thread;
 
+  /// Only started when priority mode requests are configured
+  std::thread priority_thread;
+
   void update_thread_fn();
 
+  void priority_thread_fn();
+
+  ros::WallTime next_trace_report_time;
+
+  void report_traces();
+
+  // --------------------------------------------------------------------------
+  // Metrics exporting
+
+  MetricsServer::SharedPtr metrics_server;
+
+  Metrics::Gauge* goal_queue_depth_gauge = nullptr;
+
+  Metrics::Gauge* robot_pose_age_gauge = nullptr;
+
+  ros::WallTime next_metrics_file_time;
+
+  void write_metrics_file();
+
   void publish_thread_fn();
 
   // --------------------------------------------------------------------------
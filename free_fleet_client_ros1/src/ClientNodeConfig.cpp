@@ -63,6 +63,19 @@ void ClientNodeConfig::get_param_if_available(
   }
 }
 
+void ClientNodeConfig::get_param_if_available(
+    const ros::NodeHandle& _node, const std::string& _key,
+    bool& _param_out)
+{
+  bool tmp_param;
+  if (_node.getParam(_key, tmp_param))
+  {
+    ROS_INFO("Found %s on the parameter server. Setting %s to %s.",
+        _key.c_str(), _key.c_str(), tmp_param ? "true" : "false");
+    _param_out = tmp_param;
+  }
+}
+
 void ClientNodeConfig::print_config() const
 {
   printf("ROS 1 CLIENT CONFIGURATION\n");
@@ -75,8 +88,23 @@ void ClientNodeConfig::print_config() const
   printf("  publish state frequency: %.1f\n", publish_frequency);
   printf("  maximum distance to first waypoint: %.1f\n", 
       max_dist_to_first_waypoint);
+  printf("  motion history size: %d\n", motion_history_size);
+  printf("  moving speed thresholds: %.3f m/s, %.3f rad/s\n",
+      moving_linear_speed_threshold, moving_angular_speed_threshold);
+  printf("  idle speed thresholds: %.3f m/s, %.3f rad/s\n",
+      idle_linear_speed_threshold, idle_angular_speed_threshold);
+  printf("  path look-ahead radius: %.2f\n", path_lookahead_radius);
+  printf("  correct server clock offset: %s\n",
+      correct_server_clock_offset ? "true" : "false");
+  printf("  maximum linear velocity: %.2f\n", max_linear_velocity);
+  printf("  path schedule tolerance: %.1f\n", path_schedule_tolerance);
+  printf("  trace report period: %.1f\n", trace_report_period);
+  printf("  metrics port: %d\n", metrics_port);
+  printf("  metrics file: %s\n", metrics_file.c_str());
+  printf("  metrics file period: %.1f\n", metrics_file_period);
   printf("  TOPICS\n");
   printf("    battery state: %s\n", battery_state_topic.c_str());
+  printf("    robot pose: %s\n", robot_pose_topic.c_str());
   printf("    move base server: %s\n", move_base_server_name.c_str());
   printf("    docking trigger server: %s\n", docking_trigger_server_name.c_str());
   printf("  ROBOT FRAMES\n");
@@ -84,12 +112,33 @@ void ClientNodeConfig::print_config() const
   printf("    robot frame: %s\n", robot_frame.c_str());
   printf("CLIENT-SERVER DDS CONFIGURATION\n");
   printf("  dds domain: %d\n", dds_domain);
+  printf("  dds shared memory: %s\n", dds_shared_memory ? "true" : "false");
   printf("  TOPICS\n");
   printf("    robot state: %s\n", dds_state_topic.c_str());
   printf("    mode request: %s\n", dds_mode_request_topic.c_str());
   printf("    path request: %s\n", dds_path_request_topic.c_str());
   printf("    destination request: %s\n", 
       dds_destination_request_topic.c_str());
+  printf("  COMPRESS PATHS: %s\n", dds_compress_paths ? "true" : "false");
+  printf("    extended robot state: %s\n", dds_extended_state_topic.c_str());
+  printf("    extended path request: %s\n",
+      dds_extended_path_request_topic.c_str());
+  printf("  TRACE REQUESTS: %s\n", dds_trace_requests ? "true" : "false");
+  printf("    extended mode request: %s\n",
+      dds_extended_mode_request_topic.c_str());
+  printf("    extended destination request: %s\n",
+      dds_extended_destination_request_topic.c_str());
+  printf("  COMPACT STATE: %s\n", dds_compact_state ? "true" : "false");
+  printf("    compact robot state: %s\n", dds_compact_state_topic.c_str());
+  printf("    name registry: %s\n", dds_name_registry_topic.c_str());
+  printf("  FLEET PATH REQUEST: %s\n",
+      dds_fleet_path_request ? "true" : "false");
+  printf("    fleet path request: %s\n",
+      dds_fleet_path_request_topic.c_str());
+  printf("  PRIORITY MODE REQUEST: %s\n",
+      dds_priority_mode_request ? "true" : "false");
+  printf("    priority mode request: %s\n",
+      dds_priority_mode_request_topic.c_str());
 }
   
 ClientConfig ClientNodeConfig::get_client_config() const
@@ -100,6 +149,25 @@ ClientConfig ClientNodeConfig::get_client_config() const
   client_config.dds_mode_request_topic = dds_mode_request_topic;
   client_config.dds_path_request_topic = dds_path_request_topic;
   client_config.dds_destination_request_topic = dds_destination_request_topic;
+  client_config.dds_shared_memory = dds_shared_memory;
+  client_config.dds_compress_paths = dds_compress_paths;
+  client_config.dds_extended_state_topic = dds_extended_state_topic;
+  client_config.dds_extended_path_request_topic =
+      dds_extended_path_request_topic;
+  client_config.dds_trace_requests = dds_trace_requests;
+  client_config.dds_extended_mode_request_topic =
+      dds_extended_mode_request_topic;
+  client_config.dds_extended_destination_request_topic =
+      dds_extended_destination_request_topic;
+  client_config.dds_compact_state = dds_compact_state;
+  client_config.dds_compact_state_topic = dds_compact_state_topic;
+  client_config.dds_name_registry_topic = dds_name_registry_topic;
+  client_config.dds_fleet_path_request = dds_fleet_path_request;
+  client_config.dds_fleet_path_request_topic = dds_fleet_path_request_topic;
+  client_config.dds_priority_mode_request = dds_priority_mode_request;
+  client_config.dds_priority_mode_request_topic =
+      dds_priority_mode_request_topic;
+  client_config.robot_name = robot_name;
   return client_config;
 }
 
@@ -117,6 +185,8 @@ ClientNodeConfig ClientNodeConfig::make()
       node_private_ns, "level_name", config.level_name);
   config.get_param_if_available(
       node_private_ns, "battery_state_topic", config.battery_state_topic);
+  config.get_param_if_available(
+      node_private_ns, "robot_pose_topic", config.robot_pose_topic);
   config.get_param_if_available(node_private_ns, "map_frame", config.map_frame);
   config.get_param_if_available(
       node_private_ns, "robot_frame", config.robot_frame);
@@ -133,6 +203,44 @@ ClientNodeConfig ClientNodeConfig::make()
   config.get_param_if_available(
       node_private_ns, "dds_destination_request_topic", 
       config.dds_destination_request_topic);
+  config.get_param_if_available(
+      node_private_ns, "dds_shared_memory", config.dds_shared_memory);
+  config.get_param_if_available(
+      node_private_ns, "dds_compress_paths", config.dds_compress_paths);
+  config.get_param_if_available(
+      node_private_ns, "dds_extended_state_topic",
+      config.dds_extended_state_topic);
+  config.get_param_if_available(
+      node_private_ns, "dds_extended_path_request_topic",
+      config.dds_extended_path_request_topic);
+  config.get_param_if_available(
+      node_private_ns, "dds_trace_requests", config.dds_trace_requests);
+  config.get_param_if_available(
+      node_private_ns, "dds_extended_mode_request_topic",
+      config.dds_extended_mode_request_topic);
+  config.get_param_if_available(
+      node_private_ns, "dds_extended_destination_request_topic",
+      config.dds_extended_destination_request_topic);
+  config.get_param_if_available(
+      node_private_ns, "dds_compact_state", config.dds_compact_state);
+  config.get_param_if_available(
+      node_private_ns, "dds_compact_state_topic",
+      config.dds_compact_state_topic);
+  config.get_param_if_available(
+      node_private_ns, "dds_name_registry_topic",
+      config.dds_name_registry_topic);
+  config.get_param_if_available(
+      node_private_ns, "dds_fleet_path_request",
+      config.dds_fleet_path_request);
+  config.get_param_if_available(
+      node_private_ns, "dds_fleet_path_request_topic",
+      config.dds_fleet_path_request_topic);
+  config.get_param_if_available(
+      node_private_ns, "dds_priority_mode_request",
+      config.dds_priority_mode_request);
+  config.get_param_if_available(
+      node_private_ns, "dds_priority_mode_request_topic",
+      config.dds_priority_mode_request_topic);
   config.get_param_if_available(
       node_private_ns, "wait_timeout", config.wait_timeout);
   config.get_param_if_available(
@@ -142,6 +250,39 @@ ClientNodeConfig ClientNodeConfig::make()
   config.get_param_if_available(
       node_private_ns, "max_dist_to_first_waypoint", 
       config.max_dist_to_first_waypoint);
+  config.get_param_if_available(
+      node_private_ns, "motion_history_size", config.motion_history_size);
+  config.get_param_if_available(
+      node_private_ns, "moving_linear_speed_threshold",
+      config.moving_linear_speed_threshold);
+  config.get_param_if_available(
+      node_private_ns, "moving_angular_speed_threshold",
+      config.moving_angular_speed_threshold);
+  config.get_param_if_available(
+      node_private_ns, "idle_linear_speed_threshold",
+      config.idle_linear_speed_threshold);
+  config.get_param_if_available(
+      node_private_ns, "idle_angular_speed_threshold",
+      config.idle_angular_speed_threshold);
+  config.get_param_if_available(
+      node_private_ns, "path_lookahead_radius", 
+      config.path_lookahead_radius);
+  config.get_param_if_available(
+      node_private_ns, "correct_server_clock_offset",
+      config.correct_server_clock_offset);
+  config.get_param_if_available(
+      node_private_ns, "max_linear_velocity", config.max_linear_velocity);
+  config.get_param_if_available(
+      node_private_ns, "path_schedule_tolerance",
+      config.path_schedule_tolerance);
+  config.get_param_if_available(
+      node_private_ns, "trace_report_period", config.trace_report_period);
+  config.get_param_if_available(
+      node_private_ns, "metrics_port", config.metrics_port);
+  config.get_param_if_available(
+      node_private_ns, "metrics_file", config.metrics_file);
+  config.get_param_if_available(
+      node_private_ns, "metrics_file_period", config.metrics_file_period);
   return config;
 }
 
@@ -39,6 +39,10 @@ struct ClientNodeConfig
 
   std::string battery_state_topic = "/battery_state";
 
+  /// Localization pose topic of type geometry_msgs/PoseWithCovarianceStamped,
+  /// used as the source of the robot pose instead of TF when not empty.
+  std::string robot_pose_topic = "";
+
   std::string map_frame = "map";
   std::string robot_frame = "base_footprint";
 
@@ -51,6 +55,24 @@ struct ClientNodeConfig
   std::string dds_mode_request_topic = "mode_request";
   std::string dds_path_request_topic = "path_request";
   std::string dds_destination_request_topic = "destination_request";
+  bool dds_shared_memory = false;
+  bool dds_compress_paths = false;
+  std::string dds_extended_state_topic = "extended_robot_state";
+  std::string dds_extended_path_request_topic = "extended_path_request";
+  bool dds_trace_requests = false;
+  std::string dds_extended_mode_request_topic = "extended_mode_request";
+  std::string dds_extended_destination_request_topic =
+      "extended_destination_request";
+  bool dds_compact_state = false;
+  std::string dds_compact_state_topic = "compact_robot_state";
+  std::string dds_name_registry_topic = "name_registry";
+  bool dds_fleet_path_request = false;
+  std::string dds_fleet_path_request_topic = "fleet_path_request";
+
+  /// Pause, resume and emergency requests are received on a reliable topic
+  /// of their own, and handled by a dedicated thread as soon as they arrive.
+  bool dds_priority_mode_request = false;
+  std::string dds_priority_mode_request_topic = "priority_mode_request";
 
   double wait_timeout = 10.0;
   double update_frequency = 10.0;
@@ -58,6 +80,39 @@ struct ClientNodeConfig
 
   double max_dist_to_first_waypoint = 10.0;
 
+  /// Number of recent poses over which the robot is classified as moving or
+  /// idle, it only becomes moving above the moving thresholds and only
+  /// becomes idle again below the idle thresholds.
+  int motion_history_size = 5;
+  double moving_linear_speed_threshold = 0.02;
+  double moving_angular_speed_threshold = 0.02;
+  double idle_linear_speed_threshold = 0.01;
+  double idle_angular_speed_threshold = 0.01;
+
+  /// Radius around the current waypoint of a path, within which the next
+  /// waypoint is already sent to move_base. Disabled when not positive.
+  double path_lookahead_radius = 0.0;
+
+  /// Corrects waypoint times using the estimated offset between the server's
+  /// and this client's clocks. Only meaningful when both use wall time.
+  bool correct_server_clock_offset = false;
+
+  /// Maximum velocity used to check if the schedule of a path is still
+  /// feasible, paths which would be late by more than the tolerance in
+  /// seconds are rejected. Disabled when not positive.
+  double max_linear_velocity = 0.0;
+  double path_schedule_tolerance = 5.0;
+
+  /// Period in seconds at which the latencies of traced requests are logged.
+  /// Disabled when not positive.
+  double trace_report_period = 60.0;
+
+  /// Metrics are served in the Prometheus text format on the local port when
+  /// it is positive, and written periodically to the file when it is set.
+  int metrics_port = 0;
+  std::string metrics_file = "";
+  double metrics_file_period = 5.0;
+
   void get_param_if_available(
       const ros::NodeHandle& node, const std::string& key, 
       std::string& param_out);
@@ -70,6 +125,10 @@ struct ClientNodeConfig
       const ros::NodeHandle& node, const std::string& key,
       double& param_out);
 
+  void get_param_if_available(
+      const ros::NodeHandle& node, const std::string& key,
+      bool& param_out);
+
   void print_config() const;
 
   ClientConfig get_client_config() const;
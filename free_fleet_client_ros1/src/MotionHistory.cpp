@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "utilities.hpp"
+#include "MotionHistory.hpp"
+
+namespace free_fleet
+{
+namespace ros1
+{
+
+MotionHistory::MotionHistory(
+    std::size_t _capacity, const Thresholds& _thresholds) :
+  samples(std::max<std::size_t>(_capacity, 2)),
+  thresholds(_thresholds)
+{}
+
+bool MotionHistory::add(
+    const geometry_msgs::TransformStamped& _transform_stamped)
+{
+  const double time = _transform_stamped.header.stamp.toSec();
+  if (size > 0 && time <= sample_at(0).time)
+    return false;
+
+  samples[next] = Sample{
+      time,
+      _transform_stamped.transform.translation.x,
+      _transform_stamped.transform.translation.y,
+      get_yaw_from_transform(_transform_stamped)};
+  next = (next + 1) % samples.size();
+  size = std::min(size + 1, samples.size());
+
+  classify();
+  return true;
+}
+
+bool MotionHistory::is_moving() const
+{
+  return moving;
+}
+
+const MotionHistory::Sample& MotionHistory::sample_at(std::size_t _age) const
+{
+  return samples[(next + samples.size() - 1 - _age) % samples.size()];
+}
+
+void MotionHistory::classify()
+{
+  if (size < 2)
+    return;
+
+  // Velocities are the least squares slopes over the window, relative to
+  // the oldest sample to keep the sums small. The heading is unwrapped
+  // between consecutive samples, so that turning across +/- pi is
+  // continuous.
+  const Sample& oldest = sample_at(size - 1);
+  double mean_time = 0.0;
+  double mean_x = 0.0;
+  double mean_y = 0.0;
+  double mean_yaw = 0.0;
+  double yaw = 0.0;
+  for (std::size_t age = size; age-- > 0;)
+  {
+    const Sample& sample = sample_at(age);
+    if (age + 1 < size)
+      yaw += std::remainder(sample.yaw - sample_at(age + 1).yaw, 2.0 * M_PI);
+    mean_time += sample.time - oldest.time;
+    mean_x += sample.x - oldest.x;
+    mean_y += sample.y - oldest.y;
+    mean_yaw += yaw;
+  }
+  mean_time /= size;
+  mean_x /= size;
+  mean_y /= size;
+  mean_yaw /= size;
+
+  double time_variance = 0.0;
+  double x_covariance = 0.0;
+  double y_covariance = 0.0;
+  double yaw_covariance = 0.0;
+  yaw = 0.0;
+  for (std::size_t age = size; age-- > 0;)
+  {
+    const Sample& sample = sample_at(age);
+    if (age + 1 < size)
+      yaw += std::remainder(sample.yaw - sample_at(age + 1).yaw, 2.0 * M_PI);
+    const double time = sample.time - oldest.time - mean_time;
+    time_variance += time * time;
+    x_covariance += time * (sample.x - oldest.x - mean_x);
+    y_covariance += time * (sample.y - oldest.y - mean_y);
+    yaw_covariance += time * (yaw - mean_yaw);
+  }
+  if (time_variance <= 0.0)
+    return;
+
+  const double linear_speed =
+      std::hypot(x_covariance, y_covariance) / time_variance;
+  const double angular_speed = std::abs(yaw_covariance) / time_variance;
+
+  if (!moving)
+  {
+    moving =
+        linear_speed > thresholds.moving_linear_speed ||
+        angular_speed > thresholds.moving_angular_speed;
+  }
+  else
+  {
+    moving =
+        linear_speed >= thresholds.idle_linear_speed ||
+        angular_speed >= thresholds.idle_angular_speed;
+  }
+}
+
+} // namespace ros1
+} // namespace free_fleet
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET_CLIENT_ROS1__SRC__MOTIONHISTORY_HPP
+#define FREE_FLEET_CLIENT_ROS1__SRC__MOTIONHISTORY_HPP
+
+#include <vector>
+
+#include <ros/ros.h>
+#include <geometry_msgs/TransformStamped.h>
+
+namespace free_fleet
+{
+namespace ros1
+{
+
+/// Fixed size ring buffer of the most recent robot poses, used to classify
+/// whether the robot is moving over a window of samples instead of between
+/// two consecutive ones. The speeds are the least squares slopes of the
+/// position and heading over the window, so that zero mean jitter of a
+/// stationary robot averages out. Hysteresis between the moving and idle
+/// thresholds keeps a single noisy sample from flipping the classification.
+class MotionHistory
+{
+public:
+
+  struct Thresholds
+  {
+    /// Speeds above which an idle robot is classified as moving
+    double moving_linear_speed = 0.02;
+    double moving_angular_speed = 0.02;
+
+    /// Speeds below which a moving robot is classified as idle again
+    double idle_linear_speed = 0.01;
+    double idle_angular_speed = 0.01;
+  };
+
+  MotionHistory(std::size_t capacity, const Thresholds& thresholds);
+
+  /// Adds the latest pose of the robot, timed by its header stamp, and
+  /// updates the classification. Poses that are not newer than the latest
+  /// sample, such as the same cached pose seen again, are ignored, so that
+  /// pose sources slower than the caller do not read as idle.
+  ///
+  /// \return
+  ///   True if the pose was added, false if it was ignored.
+  bool add(const geometry_msgs::TransformStamped& transform_stamped);
+
+  bool is_moving() const;
+
+private:
+
+  struct Sample
+  {
+    double time;
+    double x;
+    double y;
+    double yaw;
+  };
+
+  std::vector<Sample> samples;
+
+  /// Index where the next sample will be written
+  std::size_t next = 0;
+
+  std::size_t size = 0;
+
+  Thresholds thresholds;
+
+  bool moving = false;
+
+  const Sample& sample_at(std::size_t age) const;
+
+  void classify();
+
+};
+
+} // namespace ros1
+} // namespace free_fleet
+
+#endif // FREE_FLEET_CLIENT_ROS1__SRC__MOTIONHISTORY_HPP
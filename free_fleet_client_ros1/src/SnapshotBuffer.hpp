@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#ifndef FREE_FLEET_CLIENT_ROS1__SRC__SNAPSHOTBUFFER_HPP
+#define FREE_FLEET_CLIENT_ROS1__SRC__SNAPSHOTBUFFER_HPP
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+
+namespace free_fleet
+{
+namespace ros1
+{
+
+/// Hands the latest version of a value over from writers to readers without
+/// readers ever taking a lock. Versions are kept in a fixed number of slots:
+/// readers pin the current slot for as long as they hold it, and writers
+/// copy the current version into a slot that no reader pinned, update it in
+/// place and publish it. Copies reuse the allocations of the slot they are
+/// made into, so that updating a value does not allocate once warmed up.
+///
+/// Writers are serialized by a mutex, and only ever wait for readers if
+/// every other slot is pinned, which needs more concurrent readers than
+/// there are slots.
+template<typename T, std::size_t SlotNum = 8>
+class SnapshotBuffer
+{
+public:
+
+  static_assert(SlotNum >= 2, "at least two slots are needed");
+
+  /// Pins a version for as long as it is held, move only.
+  class Reader
+  {
+  public:
+
+    Reader(Reader&& _other) :
+      buffer(_other.buffer),
+      slot(_other.slot)
+    {
+      _other.buffer = nullptr;
+    }
+
+    Reader(const Reader&) = delete;
+
+    Reader& operator=(const Reader&) = delete;
+
+    ~Reader()
+    {
+      if (buffer)
+        buffer->reader_nums[slot].fetch_sub(1, std::memory_order_release);
+    }
+
+    const T& operator*() const
+    {
+      return buffer->slots[slot];
+    }
+
+    const T* operator->() const
+    {
+      return &buffer->slots[slot];
+    }
+
+  private:
+
+    friend class SnapshotBuffer;
+
+    Reader(const SnapshotBuffer* _buffer, std::size_t _slot) :
+      buffer(_buffer),
+      slot(_slot)
+    {}
+
+    const SnapshotBuffer* buffer;
+
+    std::size_t slot;
+  };
+
+  SnapshotBuffer() :
+    current(0)
+  {
+    for (auto& reader_num : reader_nums)
+      reader_num.store(0);
+  }
+
+  /// Gets the latest version, lock free. Only retries when a writer
+  /// published a new version in the meantime.
+  Reader read() const
+  {
+    while (true)
+    {
+      const std::size_t slot = current.load();
+      reader_nums[slot].fetch_add(1);
+      // Writers only ever update slots that are not current, so once
+      // pinned, the slot stays untouched if it is still current now
+      if (current.load() == slot)
+        return Reader(this, slot);
+      reader_nums[slot].fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  /// Publishes a new version, made by applying the update function to a copy
+  /// of the latest one.
+  template<typename UpdateFn>
+  void update(UpdateFn&& _update_fn)
+  {
+    std::lock_guard<std::mutex> write_lock(write_mutex);
+    const std::size_t current_slot = current.load(std::memory_order_relaxed);
+    std::size_t slot = current_slot;
+    while (true)
+    {
+      slot = (slot + 1) % SlotNum;
+      if (slot != current_slot && reader_nums[slot].load() == 0)
+        break;
+      if (slot == current_slot)
+        std::this_thread::yield();
+    }
+
+    slots[slot] = slots[current_slot];
+    _update_fn(slots[slot]);
+    current.store(slot);
+  }
+
+private:
+
+  std::array<T, SlotNum> slots;
+
+  mutable std::array<std::atomic<uint32_t>, SlotNum> reader_nums;
+
+  std::atomic<std::size_t> current;
+
+  std::mutex write_mutex;
+
+};
+
+} // namespace ros1
+} // namespace free_fleet
+
+#endif // FREE_FLEET_CLIENT_ROS1__SRC__SNAPSHOTBUFFER_HPP
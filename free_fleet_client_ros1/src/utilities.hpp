@@ -33,10 +33,6 @@ double get_yaw_from_transform(
 
 geometry_msgs::Quaternion get_quat_from_yaw(double yaw);
 
-bool is_transform_close(
-    const geometry_msgs::TransformStamped& transform_1,
-    const geometry_msgs::TransformStamped& transform_2);
-
 } // namespace ros1
 } // namespace free_fleet
 
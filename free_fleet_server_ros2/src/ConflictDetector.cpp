@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "ConflictDetector.hpp"
+
+namespace free_fleet
+{
+namespace ros2
+{
+
+namespace {
+
+/// Bounds the cost of segments with implausible lengths or durations
+constexpr double MaxSegmentSamples = 1000.0;
+
+double to_seconds(const messages::Location& _location)
+{
+  return static_cast<double>(_location.sec) +
+      static_cast<double>(_location.nanosec) * 1e-9;
+}
+
+int64_t to_index(double _value, double _step)
+{
+  const double index = std::floor(_value / _step);
+  // Clamped with a margin, so that neighbouring indices stay representable
+  const double min = std::numeric_limits<int32_t>::min() + 1.0;
+  const double max = std::numeric_limits<int32_t>::max() - 1.0;
+  if (!(index > min))
+    return static_cast<int64_t>(min);
+  if (index >= max)
+    return static_cast<int64_t>(max);
+  return static_cast<int64_t>(index);
+}
+
+bool is_same_path(
+    const std::vector<messages::Location>& _first,
+    const std::vector<messages::Location>& _second)
+{
+  if (_first.size() != _second.size())
+    return false;
+
+  for (std::size_t i = 0; i < _first.size(); ++i)
+  {
+    const messages::Location& first = _first[i];
+    const messages::Location& second = _second[i];
+    if (first.sec != second.sec || first.nanosec != second.nanosec ||
+        first.x != second.x || first.y != second.y ||
+        first.level_name != second.level_name)
+      return false;
+  }
+  return true;
+}
+
+} // namespace
+
+constexpr uint32_t ConflictDetector::UnknownLevel;
+
+bool ConflictDetector::Key::operator==(const Key& _other) const
+{
+  return level_id == _other.level_id && cell_x == _other.cell_x &&
+      cell_y == _other.cell_y && bucket == _other.bucket;
+}
+
+bool ConflictDetector::Key::operator<(const Key& _other) const
+{
+  if (level_id != _other.level_id)
+    return level_id < _other.level_id;
+  if (cell_x != _other.cell_x)
+    return cell_x < _other.cell_x;
+  if (cell_y != _other.cell_y)
+    return cell_y < _other.cell_y;
+  return bucket < _other.bucket;
+}
+
+std::size_t ConflictDetector::KeyHash::operator()(const Key& _key) const
+{
+  uint64_t hash = _key.level_id;
+  hash = hash * 0x9e3779b97f4a7c15ULL + static_cast<uint32_t>(_key.cell_x);
+  hash = hash * 0x9e3779b97f4a7c15ULL + static_cast<uint32_t>(_key.cell_y);
+  hash = hash * 0x9e3779b97f4a7c15ULL + static_cast<uint64_t>(_key.bucket);
+  return static_cast<std::size_t>(hash ^ (hash >> 32));
+}
+
+ConflictDetector::ConflictDetector(double _cell_size, double _time_window) :
+  cell_size(_cell_size > 0.0 ? _cell_size : 1.0),
+  time_window(_time_window > 0.0 ? _time_window : 2.0)
+{}
+
+void ConflictDetector::reserve(
+    const std::string& _robot_name,
+    const std::vector<messages::Location>& _path)
+{
+  auto inserted = robot_ids.insert(
+      {_robot_name, static_cast<RobotId>(robot_names.size())});
+  const RobotId robot_id = inserted.first->second;
+  if (inserted.second)
+  {
+    robot_names.push_back(_robot_name);
+    reservations.emplace_back();
+  }
+  else if (is_same_path(reservations[robot_id].path, _path))
+    return;
+
+  release_keys(robot_id);
+
+  std::vector<uint32_t> path_level_ids;
+  path_level_ids.reserve(_path.size());
+  for (const auto& location : _path)
+    path_level_ids.push_back(intern_level(location.level_name));
+
+  std::vector<Sample> samples;
+  sample(_path, path_level_ids, samples);
+
+  Reservation& reservation = reservations[robot_id];
+  reservation.path = _path;
+  reservation.keys.clear();
+  for (const auto& sample : samples)
+    reservation.keys.push_back(sample.key);
+  std::sort(reservation.keys.begin(), reservation.keys.end());
+  reservation.keys.erase(
+      std::unique(reservation.keys.begin(), reservation.keys.end()),
+      reservation.keys.end());
+
+  for (const auto& key : reservation.keys)
+    cells[key].push_back(robot_id);
+}
+
+void ConflictDetector::release(const std::string& _robot_name)
+{
+  auto it = robot_ids.find(_robot_name);
+  if (it == robot_ids.end())
+    return;
+
+  release_keys(it->second);
+  reservations[it->second].path.clear();
+}
+
+void ConflictDetector::find_conflicts(
+    const std::string& _robot_name,
+    const std::vector<messages::Location>& _path,
+    std::vector<Conflict>& _conflicts) const
+{
+  _conflicts.clear();
+
+  auto it = robot_ids.find(_robot_name);
+  const RobotId self_id =
+      it == robot_ids.end() ? std::numeric_limits<RobotId>::max() : it->second;
+
+  std::vector<uint32_t> path_level_ids;
+  path_level_ids.reserve(_path.size());
+  for (const auto& location : _path)
+    path_level_ids.push_back(find_level(location.level_name));
+
+  std::vector<Sample> samples;
+  sample(_path, path_level_ids, samples);
+
+  std::vector<bool> reported(robot_names.size(), false);
+  for (const auto& sample : samples)
+  {
+    for (int dx = -1; dx <= 1; ++dx)
+    {
+      for (int dy = -1; dy <= 1; ++dy)
+      {
+        for (int db = -1; db <= 1; ++db)
+        {
+          const Key key{
+              sample.key.level_id,
+              sample.key.cell_x + dx,
+              sample.key.cell_y + dy,
+              sample.key.bucket + db};
+          auto cell = cells.find(key);
+          if (cell == cells.end())
+            continue;
+
+          for (RobotId robot_id : cell->second)
+          {
+            if (robot_id == self_id || reported[robot_id])
+              continue;
+            reported[robot_id] = true;
+
+            Conflict conflict;
+            conflict.robot_name = robot_names[robot_id];
+            const double sec = std::floor(sample.time);
+            conflict.location.sec = static_cast<int32_t>(sec);
+            conflict.location.nanosec =
+                static_cast<uint32_t>((sample.time - sec) * 1e9);
+            conflict.location.x = static_cast<float>(sample.x);
+            conflict.location.y = static_cast<float>(sample.y);
+            conflict.location.yaw = _path[sample.waypoint].yaw;
+            conflict.location.level_name =
+                _path[sample.waypoint].level_name;
+            _conflicts.push_back(conflict);
+          }
+        }
+      }
+    }
+  }
+}
+
+void ConflictDetector::sample(
+    const std::vector<messages::Location>& _path,
+    const std::vector<uint32_t>& _path_level_ids,
+    std::vector<Sample>& _samples) const
+{
+  _samples.clear();
+
+  const auto add_sample =
+      [&](std::size_t _waypoint, double _x, double _y, double _time)
+  {
+    const Key key{
+        _path_level_ids[_waypoint],
+        static_cast<int32_t>(to_index(_x, cell_size)),
+        static_cast<int32_t>(to_index(_y, cell_size)),
+        to_index(_time, time_window)};
+    if (!_samples.empty() && _samples.back().key == key)
+      return;
+    _samples.push_back(Sample{key, _waypoint, _x, _y, _time});
+  };
+
+  for (std::size_t i = 0; i < _path.size(); ++i)
+  {
+    if (_path_level_ids[i] == UnknownLevel)
+      continue;
+
+    const messages::Location& start = _path[i];
+    const double start_time = to_seconds(start);
+
+    // Level changes, such as lift rides, only reserve their end points
+    if (i + 1 == _path.size() || _path_level_ids[i + 1] != _path_level_ids[i])
+    {
+      add_sample(i, start.x, start.y, start_time);
+      continue;
+    }
+
+    const messages::Location& end = _path[i + 1];
+    const double end_time = to_seconds(end);
+    const double distance = std::hypot(end.x - start.x, end.y - start.y);
+    const double steps = std::min(
+        MaxSegmentSamples,
+        std::max({
+            std::ceil(2.0 * distance / cell_size),
+            std::ceil(2.0 * std::fabs(end_time - start_time) / time_window),
+            1.0}));
+
+    // The end point is sampled as the start of the next segment
+    const int step_num = static_cast<int>(steps);
+    for (int j = 0; j < step_num; ++j)
+    {
+      const double f = static_cast<double>(j) / steps;
+      add_sample(
+          i,
+          start.x + f * (end.x - start.x),
+          start.y + f * (end.y - start.y),
+          start_time + f * (end_time - start_time));
+    }
+  }
+}
+
+uint32_t ConflictDetector::find_level(const std::string& _level_name) const
+{
+  auto it = level_ids.find(_level_name);
+  return it == level_ids.end() ? UnknownLevel : it->second;
+}
+
+uint32_t ConflictDetector::intern_level(const std::string& _level_name)
+{
+  return level_ids.insert(
+      {_level_name, static_cast<uint32_t>(level_ids.size())}).first->second;
+}
+
+void ConflictDetector::release_keys(RobotId _robot_id)
+{
+  Reservation& reservation = reservations[_robot_id];
+  for (const auto& key : reservation.keys)
+  {
+    auto cell = cells.find(key);
+    if (cell == cells.end())
+      continue;
+
+    std::vector<RobotId>& robot_ids_in_cell = cell->second;
+    auto it = std::find(
+        robot_ids_in_cell.begin(), robot_ids_in_cell.end(), _robot_id);
+    if (it != robot_ids_in_cell.end())
+    {
+      *it = robot_ids_in_cell.back();
+      robot_ids_in_cell.pop_back();
+    }
+    if (robot_ids_in_cell.empty())
+      cells.erase(cell);
+  }
+  reservation.keys.clear();
+}
+
+} // namespace ros2
+} // namespace free_fleet
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET_SERVER_ROS2__SRC__CONFLICTDETECTOR_HPP
+#define FREE_FLEET_SERVER_ROS2__SRC__CONFLICTDETECTOR_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include <free_fleet/messages/Location.hpp>
+
+namespace free_fleet
+{
+namespace ros2
+{
+
+/// Reservations of the paths of every robot in a spatio-temporal hash, keyed
+/// by level, grid cell and time bucket. Each robot has a single reservation,
+/// which is replaced as its path changes, so checking or reserving a path
+/// only costs in proportion to its own length.
+class ConflictDetector
+{
+public:
+
+  struct Conflict
+  {
+    /// Robot whose reservation intersects the checked path
+    std::string robot_name;
+
+    /// First sampled location of the checked path where they intersect
+    messages::Location location;
+  };
+
+  /// \param[in] cell_size
+  ///   Width of the square grid cells in meters. Robots in the same or in
+  ///   neighbouring cells are considered in conflict.
+  /// \param[in] time_window
+  ///   Duration of the time buckets in seconds. Robots in the same or in
+  ///   neighbouring buckets are considered in conflict.
+  ConflictDetector(double cell_size = 1.0, double time_window = 2.0);
+
+  /// Replaces the reservation of a robot with a new path, nothing is done
+  /// if the path did not change.
+  void reserve(
+      const std::string& robot_name,
+      const std::vector<messages::Location>& path);
+
+  void release(const std::string& robot_name);
+
+  /// Finds the other robots whose reservations intersect a path, at most one
+  /// conflict is reported per robot.
+  void find_conflicts(
+      const std::string& robot_name,
+      const std::vector<messages::Location>& path,
+      std::vector<Conflict>& conflicts) const;
+
+private:
+
+  using RobotId = uint32_t;
+
+  struct Key
+  {
+    uint32_t level_id;
+    int32_t cell_x;
+    int32_t cell_y;
+    int64_t bucket;
+
+    bool operator==(const Key& other) const;
+
+    bool operator<(const Key& other) const;
+  };
+
+  struct KeyHash
+  {
+    std::size_t operator()(const Key& key) const;
+  };
+
+  struct Sample
+  {
+    Key key;
+    /// Index of the waypoint that starts the sampled segment
+    std::size_t waypoint;
+    double x;
+    double y;
+    double time;
+  };
+
+  struct Reservation
+  {
+    std::vector<messages::Location> path;
+    std::vector<Key> keys;
+  };
+
+  /// Samples the path along each segment, at least twice per cell and per
+  /// time bucket crossed. Waypoints on unknown levels are skipped.
+  void sample(
+      const std::vector<messages::Location>& path,
+      const std::vector<uint32_t>& path_level_ids,
+      std::vector<Sample>& samples) const;
+
+  /// Level ID used for levels without any reservation yet
+  static constexpr uint32_t UnknownLevel = UINT32_MAX;
+
+  uint32_t find_level(const std::string& level_name) const;
+
+  uint32_t intern_level(const std::string& level_name);
+
+  void release_keys(RobotId robot_id);
+
+  double cell_size;
+
+  double time_window;
+
+  std::unordered_map<std::string, RobotId> robot_ids;
+
+  std::vector<std::string> robot_names;
+
+  std::vector<Reservation> reservations;
+
+  std::unordered_map<std::string, uint32_t> level_ids;
+
+  std::unordered_map<Key, std::vector<RobotId>, KeyHash> cells;
+
+};
+
+} // namespace ros2
+} // namespace free_fleet
+
+#endif // FREE_FLEET_SERVER_ROS2__SRC__CONFLICTDETECTOR_HPP
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "FleetStore.hpp"
+
+namespace free_fleet
+{
+namespace ros2
+{
+
+bool FleetStore::update(
+    const messages::RobotState& _state,
+    Clock::time_point _update_time,
+    RobotId& _robot_id)
+{
+  auto inserted = robot_ids.insert(
+      {_state.name, static_cast<RobotId>(names.size())});
+  const RobotId robot_id = inserted.first->second;
+  _robot_id = robot_id;
+  if (inserted.second)
+  {
+    names.push_back(_state.name);
+    models.emplace_back();
+    task_ids.emplace_back();
+    modes.emplace_back();
+    battery_percents.emplace_back();
+    locations.emplace_back();
+    update_times.emplace_back();
+    path_offsets.push_back(static_cast<uint32_t>(path_waypoints.size()));
+    path_lengths.push_back(0);
+    path_capacities.push_back(0);
+  }
+
+  if (models[robot_id] != _state.model)
+    models[robot_id] = _state.model;
+  if (task_ids[robot_id] != _state.task_id)
+    task_ids[robot_id] = _state.task_id;
+  modes[robot_id] = _state.mode.mode;
+  battery_percents[robot_id] = _state.battery_percent;
+  convert(_state.location, locations[robot_id]);
+  update_times[robot_id] = _update_time;
+  update_path(robot_id, _state.path);
+  return inserted.second;
+}
+
+bool FleetStore::find(const std::string& _robot_name, RobotId& _robot_id) const
+{
+  auto it = robot_ids.find(_robot_name);
+  if (it == robot_ids.end())
+    return false;
+  _robot_id = it->second;
+  return true;
+}
+
+std::size_t FleetStore::size() const
+{
+  return names.size();
+}
+
+void FleetStore::clear()
+{
+  robot_ids.clear();
+  level_ids.clear();
+  level_names.clear();
+  names.clear();
+  models.clear();
+  task_ids.clear();
+  modes.clear();
+  battery_percents.clear();
+  locations.clear();
+  update_times.clear();
+  path_offsets.clear();
+  path_lengths.clear();
+  path_capacities.clear();
+  path_waypoints.clear();
+  unused_path_waypoints = 0;
+}
+
+FleetStore::LevelId FleetStore::intern_level(const std::string& _level_name)
+{
+  auto inserted = level_ids.insert(
+      {_level_name, static_cast<LevelId>(level_names.size())});
+  if (inserted.second)
+    level_names.push_back(_level_name);
+  return inserted.first->second;
+}
+
+void FleetStore::convert(
+    const messages::Location& _location, Waypoint& _waypoint)
+{
+  _waypoint.sec = _location.sec;
+  _waypoint.nanosec = _location.nanosec;
+  _waypoint.x = _location.x;
+  _waypoint.y = _location.y;
+  _waypoint.yaw = _location.yaw;
+  _waypoint.level_id = intern_level(_location.level_name);
+}
+
+void FleetStore::update_path(
+    RobotId _robot_id, const std::vector<messages::Location>& _path)
+{
+  const uint32_t length = static_cast<uint32_t>(_path.size());
+  if (length > path_capacities[_robot_id])
+  {
+    // Outgrown paths move to a new slot at the end, the old one is reclaimed
+    // once enough waypoints are unused
+    unused_path_waypoints += path_capacities[_robot_id];
+    path_offsets[_robot_id] = static_cast<uint32_t>(path_waypoints.size());
+    path_capacities[_robot_id] = length;
+    path_waypoints.resize(path_waypoints.size() + length);
+  }
+
+  Waypoint* waypoints = path_waypoints.data() + path_offsets[_robot_id];
+  for (uint32_t i = 0; i < length; ++i)
+    convert(_path[i], waypoints[i]);
+  path_lengths[_robot_id] = length;
+
+  if (unused_path_waypoints > path_waypoints.size() / 2)
+    compact_paths();
+}
+
+void FleetStore::compact_paths()
+{
+  std::vector<Waypoint> compacted;
+  compacted.reserve(path_waypoints.size() - unused_path_waypoints);
+  for (RobotId robot_id = 0; robot_id < names.size(); ++robot_id)
+  {
+    const auto begin = path_waypoints.begin() + path_offsets[robot_id];
+    path_offsets[robot_id] = static_cast<uint32_t>(compacted.size());
+    compacted.insert(
+        compacted.end(), begin, begin + path_capacities[robot_id]);
+  }
+  path_waypoints.swap(compacted);
+  unused_path_waypoints = 0;
+}
+
+} // namespace ros2
+} // namespace free_fleet
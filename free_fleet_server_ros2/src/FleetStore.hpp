@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET_SERVER_ROS2__SRC__FLEETSTORE_HPP
+#define FREE_FLEET_SERVER_ROS2__SRC__FLEETSTORE_HPP
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include <free_fleet/messages/Location.hpp>
+#include <free_fleet/messages/RobotState.hpp>
+
+namespace free_fleet
+{
+namespace ros2
+{
+
+/// Latest state of every robot in the fleet, kept as a structure of arrays
+/// indexed by dense robot IDs. IDs are interned from robot names the first
+/// time a robot is seen, and level names are interned the same way, so that
+/// publishing the fleet state is a linear scan over contiguous arrays.
+class FleetStore
+{
+public:
+
+  using RobotId = uint32_t;
+  using LevelId = uint32_t;
+  using Clock = std::chrono::steady_clock;
+
+  /// Location with its level name interned, for robots and their paths
+  struct Waypoint
+  {
+    int32_t sec;
+    uint32_t nanosec;
+    float x;
+    float y;
+    float yaw;
+    LevelId level_id;
+  };
+
+  /// Updates the state of a robot, registering it if it was never seen.
+  ///
+  /// \param[in] state
+  ///   New state of the robot.
+  /// \param[in] update_time
+  ///   Time at which the state was received.
+  /// \param[out] robot_id
+  ///   ID of the robot.
+  /// \return
+  ///   True if the robot was seen for the first time.
+  bool update(
+      const messages::RobotState& state,
+      Clock::time_point update_time,
+      RobotId& robot_id);
+
+  /// Looks up the ID of a robot that was already seen.
+  bool find(const std::string& robot_name, RobotId& robot_id) const;
+
+  /// Number of robots seen so far, their IDs range from 0 to size() - 1.
+  std::size_t size() const;
+
+  void clear();
+
+  const std::string& get_name(RobotId robot_id) const
+  {
+    return names[robot_id];
+  }
+
+  const std::string& get_model(RobotId robot_id) const
+  {
+    return models[robot_id];
+  }
+
+  const std::string& get_task_id(RobotId robot_id) const
+  {
+    return task_ids[robot_id];
+  }
+
+  uint32_t get_mode(RobotId robot_id) const
+  {
+    return modes[robot_id];
+  }
+
+  float get_battery_percent(RobotId robot_id) const
+  {
+    return battery_percents[robot_id];
+  }
+
+  const Waypoint& get_location(RobotId robot_id) const
+  {
+    return locations[robot_id];
+  }
+
+  Clock::time_point get_update_time(RobotId robot_id) const
+  {
+    return update_times[robot_id];
+  }
+
+  /// Path of the robot, as a range of contiguous waypoints.
+  const Waypoint* get_path(RobotId robot_id, std::size_t& length) const
+  {
+    length = path_lengths[robot_id];
+    return path_waypoints.data() + path_offsets[robot_id];
+  }
+
+  const std::string& get_level_name(LevelId level_id) const
+  {
+    return level_names[level_id];
+  }
+
+private:
+
+  LevelId intern_level(const std::string& level_name);
+
+  void convert(const messages::Location& location, Waypoint& waypoint);
+
+  void update_path(
+      RobotId robot_id, const std::vector<messages::Location>& path);
+
+  /// Moves every path back to the start of the waypoint array, in ID order,
+  /// dropping the space left behind by paths that outgrew their slot.
+  void compact_paths();
+
+  std::unordered_map<std::string, RobotId> robot_ids;
+
+  std::unordered_map<std::string, LevelId> level_ids;
+
+  std::vector<std::string> level_names;
+
+  // --------------------------------------------------------------------------
+  // One entry per robot, indexed by robot ID
+
+  std::vector<std::string> names;
+
+  std::vector<std::string> models;
+
+  std::vector<std::string> task_ids;
+
+  std::vector<uint32_t> modes;
+
+  std::vector<float> battery_percents;
+
+  std::vector<Waypoint> locations;
+
+  std::vector<Clock::time_point> update_times;
+
+  std::vector<uint32_t> path_offsets;
+
+  std::vector<uint32_t> path_lengths;
+
+  std::vector<uint32_t> path_capacities;
+
+  // --------------------------------------------------------------------------
+
+  /// Waypoints of all the paths, each robot owning a slot of its capacity
+  std::vector<Waypoint> path_waypoints;
+
+  /// Waypoints in slots that were abandoned by paths that outgrew them
+  std::size_t unused_path_waypoints = 0;
+
+};
+
+} // namespace ros2
+} // namespace free_fleet
+
+#endif // FREE_FLEET_SERVER_ROS2__SRC__FLEETSTORE_HPP
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#include <algorithm>
+
+#include "IngestPool.hpp"
+
+namespace free_fleet
+{
+namespace ros2
+{
+
+IngestPool::IngestPool(std::size_t _shard_num) :
+  shard_num(std::max<std::size_t>(_shard_num, 1))
+{
+  workers.reserve(shard_num - 1);
+  for (std::size_t shard = 1; shard < shard_num; ++shard)
+    workers.emplace_back(&IngestPool::worker_fn, this, shard);
+}
+
+IngestPool::~IngestPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  work_cv.notify_all();
+  for (auto& worker : workers)
+    worker.join();
+}
+
+std::size_t IngestPool::get_shard_num() const
+{
+  return shard_num;
+}
+
+std::size_t IngestPool::get_shard(const std::string& _robot_name) const
+{
+  if (shard_num == 1)
+    return 0;
+  return std::hash<std::string>()(_robot_name) % shard_num;
+}
+
+void IngestPool::run(const Task& _task)
+{
+  if (shard_num > 1)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    task = &_task;
+    pending_workers = workers.size();
+    ++generation;
+  }
+  work_cv.notify_all();
+
+  _task(0);
+
+  if (shard_num > 1)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [this]() { return pending_workers == 0; });
+    task = nullptr;
+  }
+}
+
+void IngestPool::worker_fn(std::size_t _shard)
+{
+  uint64_t done_generation = 0;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    work_cv.wait(lock, [&]()
+    {
+      return stopping || generation != done_generation;
+    });
+    if (stopping)
+      return;
+    done_generation = generation;
+
+    const Task& current_task = *task;
+    lock.unlock();
+    current_task(_shard);
+    lock.lock();
+
+    if (--pending_workers == 0)
+      done_cv.notify_one();
+  }
+}
+
+} // namespace ros2
+} // namespace free_fleet
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#ifndef FREE_FLEET_SERVER_ROS2__SRC__INGESTPOOL_HPP
+#define FREE_FLEET_SERVER_ROS2__SRC__INGESTPOOL_HPP
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <condition_variable>
+
+namespace free_fleet
+{
+namespace ros2
+{
+
+/// Fixed pool of workers, one per shard, that ingest the robot states of
+/// their shard in parallel. Robots are assigned to shards by the hash of
+/// their names, so every robot is always handled by the same worker and
+/// each shard can keep its own state store.
+class IngestPool
+{
+public:
+
+  using Task = std::function<void(std::size_t shard)>;
+
+  /// \param[in] shard_num
+  ///   Number of shards, at least one. The calling thread of run() handles
+  ///   the first shard, so shard_num - 1 threads are started.
+  IngestPool(std::size_t shard_num);
+
+  ~IngestPool();
+
+  std::size_t get_shard_num() const;
+
+  /// Gets the shard that a robot always belongs to.
+  std::size_t get_shard(const std::string& robot_name) const;
+
+  /// Runs the task once for every shard in parallel, returning once all of
+  /// them are done. Only one run may be in progress at a time.
+  void run(const Task& task);
+
+private:
+
+  void worker_fn(std::size_t shard);
+
+  const std::size_t shard_num;
+
+  std::mutex mutex;
+
+  std::condition_variable work_cv;
+
+  std::condition_variable done_cv;
+
+  /// Only set while a run is in progress
+  const Task* task = nullptr;
+
+  /// Incremented by every run, so that each worker runs each task once
+  uint64_t generation = 0;
+
+  std::size_t pending_workers = 0;
+
+  bool stopping = false;
+
+  std::vector<std::thread> workers;
+
+};
+
+} // namespace ros2
+} // namespace free_fleet
+
+#endif // FREE_FLEET_SERVER_ROS2__SRC__INGESTPOOL_HPP
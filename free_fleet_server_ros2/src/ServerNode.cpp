@@ -16,6 +16,10 @@
  */
 
 #include <chrono>
+#include <vector>
+#include <cstdint>
+#include <iterator>
+#include <algorithm>
 
 #include <Eigen/Geometry>
 
@@ -104,7 +108,18 @@ void ServerNode::setup_config()
   get_parameter(
       "destination_request_topic", 
       server_node_config.destination_request_topic);
+  get_parameter(
+      "query_robots_service", server_node_config.query_robots_service);
+  get_parameter(
+      "spatial_index_cell_size", server_node_config.spatial_index_cell_size);
+  get_parameter("ingest_worker_num", server_node_config.ingest_worker_num);
   get_parameter("dds_domain", server_node_config.dds_domain);
+  std::vector<int64_t> dds_extra_domains;
+  if (get_parameter("dds_extra_domains", dds_extra_domains))
+  {
+    server_node_config.dds_extra_domains.assign(
+        dds_extra_domains.begin(), dds_extra_domains.end());
+  }
   get_parameter("dds_robot_state_topic", 
       server_node_config.dds_robot_state_topic);
   get_parameter("dds_mode_request_topic", 
@@ -114,6 +129,46 @@ void ServerNode::setup_config()
   get_parameter(
       "dds_destination_request_topic",
       server_node_config.dds_destination_request_topic);
+  get_parameter("dds_shared_memory", server_node_config.dds_shared_memory);
+  get_parameter("dds_compress_paths", server_node_config.dds_compress_paths);
+  get_parameter(
+      "dds_extended_robot_state_topic",
+      server_node_config.dds_extended_robot_state_topic);
+  get_parameter(
+      "dds_extended_path_request_topic",
+      server_node_config.dds_extended_path_request_topic);
+  get_parameter(
+      "dds_extended_mode_request_topic",
+      server_node_config.dds_extended_mode_request_topic);
+  get_parameter(
+      "dds_extended_destination_request_topic",
+      server_node_config.dds_extended_destination_request_topic);
+  get_parameter(
+      "request_ack_timeout", server_node_config.request_ack_timeout);
+  get_parameter(
+      "request_max_retransmissions",
+      server_node_config.request_max_retransmissions);
+  get_parameter(
+      "dds_compact_robot_state", server_node_config.dds_compact_robot_state);
+  get_parameter(
+      "dds_compact_robot_state_topic",
+      server_node_config.dds_compact_robot_state_topic);
+  get_parameter(
+      "dds_name_registry_topic", server_node_config.dds_name_registry_topic);
+  get_parameter(
+      "dds_priority_mode_request",
+      server_node_config.dds_priority_mode_request);
+  get_parameter(
+      "dds_priority_mode_request_topic",
+      server_node_config.dds_priority_mode_request_topic);
+  get_parameter(
+      "dds_fleet_path_request", server_node_config.dds_fleet_path_request);
+  get_parameter(
+      "dds_fleet_path_request_topic",
+      server_node_config.dds_fleet_path_request_topic);
+  get_parameter(
+      "path_request_batch_period",
+      server_node_config.path_request_batch_period);
   get_parameter("update_state_frequency", 
       server_node_config.update_state_frequency);
   get_parameter(
@@ -123,6 +178,25 @@ void ServerNode::setup_config()
   get_parameter("translation_y", server_node_config.translation_y);
   get_parameter("rotation", server_node_config.rotation);
   get_parameter("scale", server_node_config.scale);
+
+  get_parameter("enable_tracing", server_node_config.enable_tracing);
+  get_parameter(
+      "trace_report_period", server_node_config.trace_report_period);
+
+  get_parameter("metrics_port", server_node_config.metrics_port);
+  get_parameter("metrics_file", server_node_config.metrics_file);
+  get_parameter(
+      "metrics_file_period", server_node_config.metrics_file_period);
+
+  get_parameter("history_file", server_node_config.history_file);
+  get_parameter("history_capacity", server_node_config.history_capacity);
+
+  get_parameter(
+      "enable_conflict_detection",
+      server_node_config.enable_conflict_detection);
+  get_parameter("conflict_cell_size", server_node_config.conflict_cell_size);
+  get_parameter(
+      "conflict_time_window", server_node_config.conflict_time_window);
 }
 
 bool ServerNode::is_ready()
@@ -136,10 +210,18 @@ void ServerNode::start(Fields _fields)
 {
   fields = std::move(_fields);
 
+  const std::size_t shard_num = static_cast<std::size_t>(
+      std::max(server_node_config.ingest_worker_num, 1));
+  state_shards.clear();
+  for (std::size_t i = 0; i < shard_num; ++i)
   {
-    WriteLock robot_states_lock(robot_states_mutex);
-    robot_states.clear();
+    state_shards.push_back(
+        std::make_unique<StateShard>(
+            server_node_config.spatial_index_cell_size));
   }
+  ingest_pool.reset(new IngestPool(shard_num));
+  robot_state_batches.clear();
+  robot_state_batches.resize(shard_num);
 
   using namespace std::chrono_literals;
 
@@ -171,11 +253,15 @@ void ServerNode::start(Fields _fields)
       fleet_state_pub_callback_group);
 
   // --------------------------------------------------------------------------
-  // Mode request handling
+  // Third callback group that handles mode requests on their own, so that
+  // stopping robots never waits behind path requests
+
+  mode_request_callback_group = create_callback_group(
+      rclcpp::callback_group::CallbackGroupType::MutuallyExclusive);
 
   auto mode_request_sub_opt = rclcpp::SubscriptionOptions();
   
-  mode_request_sub_opt.callback_group = fleet_state_pub_callback_group;
+  mode_request_sub_opt.callback_group = mode_request_callback_group;
 
   mode_request_sub = create_subscription<rmf_fleet_msgs::msg::ModeRequest>(
       server_node_config.mode_request_topic, rclcpp::QoS(10),
@@ -200,6 +286,16 @@ void ServerNode::start(Fields _fields)
       },
       path_request_sub_opt);
 
+  if (server_node_config.path_request_batch_period > 0.0)
+  {
+    path_request_batch_timer = create_wall_timer(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::duration<double>(
+                server_node_config.path_request_batch_period)),
+        std::bind(&ServerNode::send_path_request_batch, this),
+        fleet_state_pub_callback_group);
+  }
+
   // --------------------------------------------------------------------------
   // Destination reqeust handling
 
@@ -215,19 +311,119 @@ void ServerNode::start(Fields _fields)
             handle_destination_request(std::move(msg));
           },
           destination_request_sub_opt);
+
+  // --------------------------------------------------------------------------
+  // Spatial queries over the latest robot locations
+
+  query_robots_service =
+      create_service<free_fleet_server_ros2::srv::QueryRobots>(
+          server_node_config.query_robots_service,
+          std::bind(
+              &ServerNode::handle_query_robots, this,
+              std::placeholders::_1, std::placeholders::_2),
+          rmw_qos_profile_services_default,
+          fleet_state_pub_callback_group);
+
+  // --------------------------------------------------------------------------
+  // Requests that were never acknowledged by their robot
+
+  fields.server->set_delivery_callback(
+      [this](const Server::DeliveryReport& report)
+      {
+        if (report.status != Server::DeliveryReport::Status::TimedOut)
+          return;
+        RCLCPP_WARN(
+            get_logger(),
+            "robot %s never acknowledged task %s after %u retransmissions.",
+            report.robot_name.c_str(), report.task_id.c_str(),
+            report.retransmissions);
+      });
+
+  // --------------------------------------------------------------------------
+  // Periodic trace reports
+
+  if (server_node_config.enable_tracing &&
+      server_node_config.trace_report_period > 0.0)
+  {
+    trace_report_timer = create_wall_timer(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::duration<double>(
+                server_node_config.trace_report_period)),
+        std::bind(&ServerNode::report_traces, this),
+        update_state_callback_group);
+  }
+
+  // --------------------------------------------------------------------------
+  // Metrics exporting
+
+  Metrics::SharedPtr metrics = fields.server->get_metrics();
+  robot_num_gauge = &metrics->gauge(
+      "free_fleet_robots", "Number of robots registered with the server.",
+      {{"fleet", server_node_config.fleet_name}});
+
+  if (server_node_config.metrics_port > 0)
+  {
+    metrics_server =
+        MetricsServer::make(metrics, server_node_config.metrics_port);
+    if (!metrics_server)
+      RCLCPP_ERROR(
+          get_logger(), "unable to serve metrics on port %d.",
+          server_node_config.metrics_port);
+  }
+
+  if (!server_node_config.metrics_file.empty() &&
+      server_node_config.metrics_file_period > 0.0)
+  {
+    metrics_file_timer = create_wall_timer(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::duration<double>(
+                server_node_config.metrics_file_period)),
+        std::bind(&ServerNode::write_metrics_file, this),
+        update_state_callback_group);
+  }
+
+  // --------------------------------------------------------------------------
+  // State history
+
+  if (!server_node_config.history_file.empty() &&
+      server_node_config.history_capacity > 0)
+  {
+    state_history = StateHistory::make(
+        server_node_config.history_file,
+        static_cast<std::size_t>(server_node_config.history_capacity));
+    if (!state_history)
+      RCLCPP_ERROR(
+          get_logger(), "unable to map state history file " +
+              server_node_config.history_file);
+  }
+
+  // --------------------------------------------------------------------------
+  // Path conflict detection
+
+  if (server_node_config.enable_conflict_detection)
+  {
+    conflict_detector.reset(
+        new ConflictDetector(
+            server_node_config.conflict_cell_size,
+            server_node_config.conflict_time_window));
+    path_conflicts = &metrics->counter(
+        "free_fleet_path_conflicts_total",
+        "Path requests intersecting the reserved path of another robot.",
+        {{"fleet", server_node_config.fleet_name}});
+  }
 }
 
+
 bool ServerNode::is_request_valid(
     const std::string& _fleet_name, const std::string& _robot_name)
 {
   if (_fleet_name != server_node_config.fleet_name)
     return false;
 
-  ReadLock robot_states_lock(robot_states_mutex);
-  auto it = robot_states.find(_robot_name);
-  if (it == robot_states.end())
-    return false;
-  return true;
+  StateShard& shard = get_state_shard(_robot_name);
+  ReadLock robot_states_lock(shard.mutex);
+  FleetStore::RobotId robot_id;
+  return shard.fleet_store.find(_robot_name, robot_id);
 }
 
 void ServerNode::transform_fleet_to_rmf(
@@ -309,14 +505,39 @@ void ServerNode::transform_rmf_to_fleet(
 void ServerNode::handle_mode_request(
     rmf_fleet_msgs::msg::ModeRequest::UniquePtr _msg)
 {
+  const int64_t received_time = Tracer::now();
+
   messages::ModeRequest ff_msg;
   to_ff_message(*(_msg.get()), ff_msg);
-  fields.server->send_mode_request(ff_msg);
+  start_trace(ff_msg.fleet_name, ff_msg.robot_name, ff_msg.task_id,
+      received_time, ff_msg.trace);
+
+  // A batched path request would get a stopped robot moving again
+  const bool stop =
+      ff_msg.mode.mode == messages::RobotMode::MODE_PAUSED ||
+      ff_msg.mode.mode == messages::RobotMode::MODE_EMERGENCY;
+  if (stop && path_request_batch_timer)
+  {
+    std::lock_guard<std::mutex> lock(path_request_batch_mutex);
+    path_request_batch.erase(
+        std::remove_if(
+            path_request_batch.begin(), path_request_batch.end(),
+            [&ff_msg](const messages::PathRequest& _path_request)
+            {
+              return _path_request.robot_name == ff_msg.robot_name;
+            }),
+        path_request_batch.end());
+  }
+
+  fields.server->send_mode_request_async(
+      ff_msg, warn_if_not_sent("mode", ff_msg.robot_name, ff_msg.task_id));
 }
 
 void ServerNode::handle_path_request(
     rmf_fleet_msgs::msg::PathRequest::UniquePtr _msg)
 {
+  const int64_t received_time = Tracer::now();
+
   for (std::size_t i = 0; i < _msg->path.size(); ++i)
   {
     rmf_fleet_msgs::msg::Location fleet_frame_waypoint;
@@ -326,39 +547,339 @@ void ServerNode::handle_path_request(
 
   messages::PathRequest ff_msg;
   to_ff_message(*(_msg.get()), ff_msg);
-  fields.server->send_path_request(ff_msg);
+  start_trace(ff_msg.fleet_name, ff_msg.robot_name, ff_msg.task_id,
+      received_time, ff_msg.trace);
+  if (conflict_detector)
+    check_path_conflicts(ff_msg);
+
+  if (path_request_batch_timer)
+  {
+    std::lock_guard<std::mutex> lock(path_request_batch_mutex);
+    for (auto& path_request : path_request_batch)
+    {
+      if (path_request.robot_name == ff_msg.robot_name)
+      {
+        path_request = std::move(ff_msg);
+        return;
+      }
+    }
+    path_request_batch.push_back(std::move(ff_msg));
+    return;
+  }
+
+  fields.server->send_path_request_async(
+      ff_msg, warn_if_not_sent("path", ff_msg.robot_name, ff_msg.task_id));
+}
+
+void ServerNode::send_path_request_batch()
+{
+  std::vector<messages::PathRequest> path_requests;
+  {
+    std::lock_guard<std::mutex> lock(path_request_batch_mutex);
+    path_requests.swap(path_request_batch);
+  }
+  if (path_requests.empty())
+    return;
+
+  if (!fields.server->send_batch(path_requests))
+    RCLCPP_WARN(
+        get_logger(), "unable to send a batch of %lu path requests.",
+        path_requests.size());
+}
+
+void ServerNode::check_path_conflicts(
+    const messages::PathRequest& _path_request)
+{
+  std::vector<ConflictDetector::Conflict> conflicts;
+  {
+    std::lock_guard<std::mutex> lock(conflict_detector_mutex);
+    conflict_detector->find_conflicts(
+        _path_request.robot_name, _path_request.path, conflicts);
+    conflict_detector->reserve(_path_request.robot_name, _path_request.path);
+  }
+
+  for (const auto& conflict : conflicts)
+  {
+    path_conflicts->increment();
+    RCLCPP_WARN(
+        get_logger(),
+        "path request %s for robot %s conflicts with the path of robot %s "
+        "around (%.2f, %.2f) on level %s at %d.%09u.",
+        _path_request.task_id.c_str(), _path_request.robot_name.c_str(),
+        conflict.robot_name.c_str(),
+        conflict.location.x, conflict.location.y,
+        conflict.location.level_name.c_str(),
+        conflict.location.sec, conflict.location.nanosec);
+  }
 }
 
 void ServerNode::handle_destination_request(
     rmf_fleet_msgs::msg::DestinationRequest::UniquePtr _msg)
 {
+  const int64_t received_time = Tracer::now();
+
   rmf_fleet_msgs::msg::Location fleet_frame_destination;
   transform_rmf_to_fleet(_msg->destination, fleet_frame_destination);
   _msg->destination = fleet_frame_destination;
 
   messages::DestinationRequest ff_msg;
   to_ff_message(*(_msg.get()), ff_msg);
-  fields.server->send_destination_request(ff_msg);
+  start_trace(ff_msg.fleet_name, ff_msg.robot_name, ff_msg.task_id,
+      received_time, ff_msg.trace);
+  fields.server->send_destination_request_async(
+      ff_msg,
+      warn_if_not_sent("destination", ff_msg.robot_name, ff_msg.task_id));
+}
+
+Server::SendCallback ServerNode::warn_if_not_sent(
+    const std::string& _request_type,
+    const std::string& _robot_name,
+    const std::string& _task_id)
+{
+  return [this, _request_type, _robot_name, _task_id](bool _sent)
+  {
+    if (!_sent)
+      RCLCPP_WARN(
+          get_logger(), "unable to send %s request %s to robot %s.",
+          _request_type.c_str(), _task_id.c_str(), _robot_name.c_str());
+  };
+}
+
+void ServerNode::start_trace(
+    const std::string& _fleet_name,
+    const std::string& _robot_name,
+    const std::string& _task_id,
+    int64_t _received_time,
+    messages::Trace& _trace)
+{
+  if (!server_node_config.enable_tracing)
+    return;
+
+  // The trace starts when the subscription callback is called, so the time
+  // spent transforming and converting the request is accounted for too
+  Tracer::SharedPtr tracer = fields.server->get_tracer();
+  tracer->start(
+      _trace, _fleet_name + "/" + _robot_name + "/" + _task_id,
+      "server_node_receive", _received_time);
+  tracer->stamp(_trace, "server_node_convert");
+}
+
+void ServerNode::write_metrics_file()
+{
+  if (!fields.server->get_metrics()->write_to_file(
+      server_node_config.metrics_file))
+    RCLCPP_WARN(
+        get_logger(), "unable to write metrics to " +
+            server_node_config.metrics_file);
+}
+
+void ServerNode::update_robot_metrics(
+    StateShard& _shard,
+    FleetStore::RobotId _robot_id,
+    const std::chrono::steady_clock::time_point& _now)
+{
+  std::vector<Metrics::Gauge*>& gauges = _shard.update_age_gauges;
+  while (gauges.size() <= _robot_id)
+  {
+    const std::string& robot_name =
+        _shard.fleet_store.get_name(
+            static_cast<FleetStore::RobotId>(gauges.size()));
+    gauges.push_back(&fields.server->get_metrics()->gauge(
+        "free_fleet_robot_update_age_seconds",
+        "Time since the last state update of each robot.",
+        {{"fleet", server_node_config.fleet_name}, {"robot", robot_name}}));
+  }
+  gauges[_robot_id]->set(
+      std::chrono::duration<double>(
+          _now - _shard.fleet_store.get_update_time(_robot_id)).count());
+}
+
+void ServerNode::report_traces()
+{
+  RCLCPP_INFO(
+      get_logger(), "request latencies:\n" +
+          fields.server->get_tracer()->dump());
+}
+
+ServerNode::StateShard::StateShard(double _spatial_index_cell_size) :
+  spatial_index(_spatial_index_cell_size)
+{}
+
+ServerNode::StateShard& ServerNode::get_state_shard(
+    const std::string& _robot_name)
+{
+  return *state_shards[ingest_pool->get_shard(_robot_name)];
 }
 
 void ServerNode::update_state_callback()
 {
-  std::vector<messages::RobotState> new_robot_states;
-  fields.server->read_robot_states(new_robot_states);
+  // Every sample available is taken, as each take only takes a few of them
+  // from each domain. Samples are only sorted by robot here, the ingest
+  // workers deserialize them.
+  const Server::ShardFn get_shard = [&](const std::string& _robot_name)
+  {
+    return ingest_pool->get_shard(_robot_name);
+  };
+  bool taken = false;
+  while (fields.server->take_robot_states(get_shard, robot_state_batches))
+    taken = true;
+  if (!taken)
+    return;
+
+  const int64_t received_time =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count();
+
+  const auto update_time = std::chrono::steady_clock::now();
+  ingest_pool->run([&](std::size_t _shard)
+  {
+    StateShard& shard = *state_shards[_shard];
+    fields.server->deserialize_robot_states(
+        robot_state_batches[_shard], shard.new_robot_states);
+    record_robot_states(shard.new_robot_states, received_time);
+    ingest_robot_states(shard, update_time);
+  });
+}
+
+void ServerNode::record_robot_states(
+    const std::vector<messages::RobotState>& _robot_states,
+    int64_t _received_time)
+{
+  if (_robot_states.empty())
+    return;
 
-  for (const messages::RobotState& ff_rs : new_robot_states)
+  if (state_history)
   {
-    rmf_fleet_msgs::msg::RobotState ros_rs;
-    to_ros_message(ff_rs, ros_rs);
+    std::lock_guard<std::mutex> lock(state_history_mutex);
+    for (const messages::RobotState& ff_rs : _robot_states)
+      state_history->append(ff_rs, _received_time);
+  }
 
-    WriteLock robot_states_lock(robot_states_mutex);
-    auto it = robot_states.find(ros_rs.name);
-    if (it == robot_states.end())
+  if (conflict_detector)
+  {
+    std::lock_guard<std::mutex> lock(conflict_detector_mutex);
+    for (const messages::RobotState& ff_rs : _robot_states)
+      conflict_detector->reserve(ff_rs.name, ff_rs.path);
+  }
+}
+
+void ServerNode::ingest_robot_states(
+    StateShard& _shard,
+    const std::chrono::steady_clock::time_point& _update_time)
+{
+  if (_shard.new_robot_states.empty())
+    return;
+
+  WriteLock robot_states_lock(_shard.mutex);
+  for (const messages::RobotState& ff_rs : _shard.new_robot_states)
+  {
+    FleetStore::RobotId robot_id;
+    if (_shard.fleet_store.update(ff_rs, _update_time, robot_id))
       RCLCPP_INFO(
           get_logger(),
-          "registered a new robot: " + ros_rs.name);
+          "registered a new robot: " + ff_rs.name);
+
+    rmf_fleet_msgs::msg::Location fleet_frame_location;
+    rmf_fleet_msgs::msg::Location rmf_frame_location;
+    to_ros_message(ff_rs.location, fleet_frame_location);
+    transform_fleet_to_rmf(fleet_frame_location, rmf_frame_location);
+    _shard.spatial_index.update(
+        robot_id, rmf_frame_location.level_name,
+        rmf_frame_location.x, rmf_frame_location.y);
+  }
+  _shard.new_robot_states.clear();
+}
 
-    robot_states[ros_rs.name] = ros_rs;
+std::vector<ServerNode::RobotDistance> ServerNode::find_robots_within(
+    const std::string& _level_name, double _x, double _y, double _radius)
+{
+  std::vector<RobotDistance> robot_distances;
+  std::vector<SpatialIndex::Result> results;
+  for (const auto& shard : state_shards)
+  {
+    ReadLock robot_states_lock(shard->mutex);
+    shard->spatial_index.find_within(_level_name, _x, _y, _radius, results);
+    append_robot_distances(*shard, results, robot_distances);
+  }
+  std::sort(robot_distances.begin(), robot_distances.end(),
+      [](const RobotDistance& _first, const RobotDistance& _second)
+      {
+        return _first.distance < _second.distance;
+      });
+  return robot_distances;
+}
+
+std::vector<ServerNode::RobotDistance> ServerNode::find_nearest_robots(
+    const std::string& _level_name, double _x, double _y, std::size_t _k,
+    double _max_radius)
+{
+  // The k nearest of every shard are merged, then the nearest k of those
+  std::vector<RobotDistance> robot_distances;
+  std::vector<SpatialIndex::Result> results;
+  for (const auto& shard : state_shards)
+  {
+    ReadLock robot_states_lock(shard->mutex);
+    shard->spatial_index.find_nearest(
+        _level_name, _x, _y, _k, results, _max_radius);
+    append_robot_distances(*shard, results, robot_distances);
+  }
+  std::sort(robot_distances.begin(), robot_distances.end(),
+      [](const RobotDistance& _first, const RobotDistance& _second)
+      {
+        return _first.distance < _second.distance;
+      });
+  if (robot_distances.size() > _k)
+    robot_distances.resize(_k);
+  return robot_distances;
+}
+
+void ServerNode::append_robot_distances(
+    const StateShard& _shard,
+    const std::vector<SpatialIndex::Result>& _results,
+    std::vector<RobotDistance>& _robot_distances) const
+{
+  for (const auto& result : _results)
+  {
+    _robot_distances.push_back(
+        RobotDistance{
+            _shard.fleet_store.get_name(result.robot_id), result.distance});
+  }
+}
+
+void ServerNode::handle_query_robots(
+    const std::shared_ptr<free_fleet_server_ros2::srv::QueryRobots::Request>
+        _request,
+    std::shared_ptr<free_fleet_server_ros2::srv::QueryRobots::Response>
+        _response)
+{
+  using QueryRobots = free_fleet_server_ros2::srv::QueryRobots;
+
+  std::vector<RobotDistance> robot_distances;
+  if (_request->type == QueryRobots::Request::WITHIN_RADIUS)
+  {
+    robot_distances = find_robots_within(
+        _request->level_name, _request->x, _request->y, _request->radius);
+  }
+  else if (_request->type == QueryRobots::Request::NEAREST)
+  {
+    robot_distances = find_nearest_robots(
+        _request->level_name, _request->x, _request->y, _request->k,
+        _request->radius > 0.0 ?
+            _request->radius : std::numeric_limits<double>::infinity());
+  }
+  else
+  {
+    RCLCPP_WARN(
+        get_logger(), "unknown robot query type %u.",
+        static_cast<unsigned int>(_request->type));
+  }
+
+  _response->robot_names.reserve(robot_distances.size());
+  _response->distances.reserve(robot_distances.size());
+  for (const auto& robot_distance : robot_distances)
+  {
+    _response->robot_names.push_back(robot_distance.robot_name);
+    _response->distances.push_back(robot_distance.distance);
   }
 }
 
@@ -366,44 +887,59 @@ void ServerNode::publish_fleet_state()
 {
   rmf_fleet_msgs::msg::FleetState fleet_state;
   fleet_state.name = server_node_config.fleet_name;
-  fleet_state.robots.clear();
 
-  ReadLock robot_states_lock(robot_states_mutex);
-  for (const auto it : robot_states)
+  const auto to_fleet_frame_location =
+      [](const FleetStore& _fleet_store, const FleetStore::Waypoint& _waypoint)
   {
-    const auto fleet_frame_rs = it.second;
-    rmf_fleet_msgs::msg::RobotState rmf_frame_rs;
-
-    transform_fleet_to_rmf(fleet_frame_rs.location, rmf_frame_rs.location);
-
-    // RCLCPP_INFO(
-    //     get_logger(), 
-    //     "robot location: (%.1f, %.1f, %.1f) -> (%.1f, %.1f, %.1f)",
-    //     fleet_frame_rs.location.x,
-    //     fleet_frame_rs.location.y,
-    //     fleet_frame_rs.location.yaw,
-    //     rmf_frame_rs.location.x,
-    //     rmf_frame_rs.location.y,
-    //     rmf_frame_rs.location.yaw);
-    
-    rmf_frame_rs.name = fleet_frame_rs.name;
-    rmf_frame_rs.model = fleet_frame_rs.model;
-    rmf_frame_rs.task_id = fleet_frame_rs.task_id;
-    rmf_frame_rs.mode = fleet_frame_rs.mode;
-    rmf_frame_rs.battery_percent = fleet_frame_rs.battery_percent;
-  
-    rmf_frame_rs.path.clear();
-    for (const auto& fleet_frame_path_loc : fleet_frame_rs.path)
+    rmf_fleet_msgs::msg::Location location;
+    location.t.sec = _waypoint.sec;
+    location.t.nanosec = _waypoint.nanosec;
+    location.x = _waypoint.x;
+    location.y = _waypoint.y;
+    location.yaw = _waypoint.yaw;
+    location.level_name = _fleet_store.get_level_name(_waypoint.level_id);
+    return location;
+  };
+
+  // Shards are locked one at a time, robots are ordered by shard then ID
+  const auto now = std::chrono::steady_clock::now();
+  for (const auto& shard : state_shards)
+  {
+    ReadLock robot_states_lock(shard->mutex);
+    const FleetStore& fleet_store = shard->fleet_store;
+    const std::size_t robot_num = fleet_store.size();
+    const std::size_t begin = fleet_state.robots.size();
+    fleet_state.robots.resize(begin + robot_num);
+    for (FleetStore::RobotId id = 0; id < robot_num; ++id)
     {
-      rmf_fleet_msgs::msg::Location rmf_frame_path_loc;
-
-      transform_fleet_to_rmf(fleet_frame_path_loc, rmf_frame_path_loc);
+      rmf_fleet_msgs::msg::RobotState& rmf_frame_rs =
+          fleet_state.robots[begin + id];
+
+      transform_fleet_to_rmf(
+          to_fleet_frame_location(fleet_store, fleet_store.get_location(id)),
+          rmf_frame_rs.location);
+
+      rmf_frame_rs.name = fleet_store.get_name(id);
+      rmf_frame_rs.model = fleet_store.get_model(id);
+      rmf_frame_rs.task_id = fleet_store.get_task_id(id);
+      rmf_frame_rs.mode.mode = fleet_store.get_mode(id);
+      rmf_frame_rs.battery_percent = fleet_store.get_battery_percent(id);
+
+      std::size_t path_length;
+      const FleetStore::Waypoint* path =
+          fleet_store.get_path(id, path_length);
+      rmf_frame_rs.path.resize(path_length);
+      for (std::size_t i = 0; i < path_length; ++i)
+      {
+        transform_fleet_to_rmf(
+            to_fleet_frame_location(fleet_store, path[i]),
+            rmf_frame_rs.path[i]);
+      }
 
-      rmf_frame_rs.path.push_back(rmf_frame_path_loc);
+      update_robot_metrics(*shard, id, now);
     }
-
-    fleet_state.robots.push_back(rmf_frame_rs);
   }
+  robot_num_gauge->set(static_cast<double>(fleet_state.robots.size()));
   fleet_state_pub->publish(fleet_state);
 }
 
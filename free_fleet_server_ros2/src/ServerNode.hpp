@@ -19,8 +19,11 @@
 #define FREE_FLEET_SERVER_ROS2__SRC__SERVERNODE_HPP
 
 #include <mutex>
+#include <limits>
+#include <chrono>
 #include <memory>
-#include <unordered_map>
+#include <string>
+#include <vector>
 
 #include <rclcpp/rclcpp.hpp>
 #include <rclcpp/node_options.hpp>
@@ -35,9 +38,21 @@
 #include <rmf_fleet_msgs/msg/destination_request.hpp>
 
 #include <free_fleet/Server.hpp>
+#include <free_fleet/Tracer.hpp>
+#include <free_fleet/Metrics.hpp>
+#include <free_fleet/MetricsServer.hpp>
+#include <free_fleet/StateHistory.hpp>
+#include <free_fleet/messages/Trace.hpp>
 #include <free_fleet/messages/Location.hpp>
+#include <free_fleet/messages/PathRequest.hpp>
 #include <free_fleet/messages/RobotState.hpp>
 
+#include <free_fleet_server_ros2/srv/query_robots.hpp>
+
+#include "FleetStore.hpp"
+#include "IngestPool.hpp"
+#include "SpatialIndex.hpp"
+#include "ConflictDetector.hpp"
 #include "ServerNodeConfig.hpp"
 
 namespace free_fleet
@@ -70,6 +85,23 @@ public:
 
   void print_config();
 
+  struct RobotDistance
+  {
+    std::string robot_name;
+    double distance;
+  };
+
+  /// Finds the robots on a level within a radius of a point in the RMF
+  /// frame, ordered by increasing distance.
+  std::vector<RobotDistance> find_robots_within(
+      const std::string& level_name, double x, double y, double radius);
+
+  /// Finds the k robots on a level nearest to a point in the RMF frame,
+  /// ordered by increasing distance.
+  std::vector<RobotDistance> find_nearest_robots(
+      const std::string& level_name, double x, double y, std::size_t k,
+      double max_radius = std::numeric_limits<double>::infinity());
+
 private:
 
   bool is_request_valid(
@@ -97,6 +129,28 @@ private:
 
   void handle_path_request(rmf_fleet_msgs::msg::PathRequest::UniquePtr msg);
 
+  /// Serializes path requests against robot state updates
+  std::mutex conflict_detector_mutex;
+
+  /// Only set when conflict detection is enabled
+  std::unique_ptr<ConflictDetector> conflict_detector;
+
+  /// Path requests received since the last batch was sent, only used when
+  /// the batch period is positive
+  std::mutex path_request_batch_mutex;
+
+  std::vector<messages::PathRequest> path_request_batch;
+
+  rclcpp::TimerBase::SharedPtr path_request_batch_timer;
+
+  void send_path_request_batch();
+
+  Metrics::Counter* path_conflicts = nullptr;
+
+  /// Reports the robots whose reserved paths intersect the requested path,
+  /// then reserves it for the requested robot.
+  void check_path_conflicts(const messages::PathRequest& path_request);
+
   // --------------------------------------------------------------------------
 
   rclcpp::Subscription<rmf_fleet_msgs::msg::DestinationRequest>::SharedPtr
@@ -107,14 +161,98 @@ private:
 
   // --------------------------------------------------------------------------
 
+  rclcpp::TimerBase::SharedPtr trace_report_timer;
+
+  /// Requests are sent asynchronously so that subscription callbacks never
+  /// wait on DDS, failures are only logged.
+  Server::SendCallback warn_if_not_sent(
+      const std::string& request_type,
+      const std::string& robot_name,
+      const std::string& task_id);
+
+  void start_trace(
+      const std::string& fleet_name,
+      const std::string& robot_name,
+      const std::string& task_id,
+      int64_t received_time,
+      messages::Trace& trace);
+
+  void report_traces();
+
+  // --------------------------------------------------------------------------
+
+  MetricsServer::SharedPtr metrics_server;
+
+  rclcpp::TimerBase::SharedPtr metrics_file_timer;
+
+  Metrics::Gauge* robot_num_gauge = nullptr;
+
+  struct StateShard;
+
+  void update_robot_metrics(
+      StateShard& shard,
+      FleetStore::RobotId robot_id,
+      const std::chrono::steady_clock::time_point& now);
+
+  void write_metrics_file();
+
+  // --------------------------------------------------------------------------
+
   rclcpp::callback_group::CallbackGroup::SharedPtr update_state_callback_group;
 
   rclcpp::TimerBase::SharedPtr update_state_timer;
 
-  std::mutex robot_states_mutex;
+  /// Latest states of the robots of one shard of the ingest pool, robot IDs
+  /// are only unique within their shard
+  struct StateShard
+  {
+    StateShard(double spatial_index_cell_size);
+
+    std::mutex mutex;
+
+    FleetStore fleet_store;
+
+    /// Latest robot locations in the RMF frame, by robot ID of the fleet
+    /// store
+    SpatialIndex spatial_index;
+
+    /// Deserialized from the robot state batch of the shard on each run of
+    /// the ingest pool
+    std::vector<messages::RobotState> new_robot_states;
+
+    /// Indexed by robot ID, only ever accessed while publishing fleet states
+    std::vector<Metrics::Gauge*> update_age_gauges;
+  };
+
+  std::vector<std::unique_ptr<StateShard>> state_shards;
 
-  std::unordered_map<std::string, rmf_fleet_msgs::msg::RobotState> 
-      robot_states;
+  std::unique_ptr<IngestPool> ingest_pool;
+
+  /// Robot states taken by the update state callback, one batch per shard,
+  /// each deserialized by the ingest worker of its shard
+  std::vector<Server::RobotStateBatch> robot_state_batches;
+
+  StateShard& get_state_shard(const std::string& robot_name);
+
+  /// Appends new robot states to the state history and reserves their paths
+  /// in the conflict detector, called by the ingest workers.
+  void record_robot_states(
+      const std::vector<messages::RobotState>& robot_states,
+      int64_t received_time);
+
+  void ingest_robot_states(
+      StateShard& shard,
+      const std::chrono::steady_clock::time_point& update_time);
+
+  void append_robot_distances(
+      const StateShard& shard,
+      const std::vector<SpatialIndex::Result>& results,
+      std::vector<RobotDistance>& robot_distances) const;
+
+  /// Appended to by the ingest workers, one at a time
+  std::mutex state_history_mutex;
+
+  StateHistory::SharedPtr state_history;
 
   void update_state_callback();
 
@@ -123,6 +261,9 @@ private:
   rclcpp::callback_group::CallbackGroup::SharedPtr 
       fleet_state_pub_callback_group;
 
+  rclcpp::callback_group::CallbackGroup::SharedPtr
+      mode_request_callback_group;
+
   rclcpp::TimerBase::SharedPtr fleet_state_pub_timer;
 
   rclcpp::Publisher<rmf_fleet_msgs::msg::FleetState>::SharedPtr 
@@ -132,6 +273,17 @@ private:
 
   // --------------------------------------------------------------------------
 
+  rclcpp::Service<free_fleet_server_ros2::srv::QueryRobots>::SharedPtr
+      query_robots_service;
+
+  void handle_query_robots(
+      const std::shared_ptr<free_fleet_server_ros2::srv::QueryRobots::Request>
+          request,
+      std::shared_ptr<free_fleet_server_ros2::srv::QueryRobots::Response>
+          response);
+
+  // --------------------------------------------------------------------------
+
   ServerNodeConfig server_node_config;
 
   void setup_config();
@@ -33,34 +33,104 @@ void ServerNodeConfig::print_config() const
   printf("  fleet name: %s\n", fleet_name.c_str());
   printf("  update state frequency: %.1f\n", update_state_frequency);
   printf("  publish state frequency: %.1f\n", publish_state_frequency);
+  printf("  spatial index cell size: %.1f\n", spatial_index_cell_size);
+  printf("  ingest worker num: %d\n", ingest_worker_num);
+  printf("  path request batch period: %.3f\n", path_request_batch_period);
   printf("  TOPICS\n");
   printf("    fleet state: %s\n", fleet_state_topic.c_str());
   printf("    mode request: %s\n", mode_request_topic.c_str());
   printf("    path request: %s\n", path_request_topic.c_str());
   printf("    destination request: %s\n", destination_request_topic.c_str());
+  printf("    query robots service: %s\n", query_robots_service.c_str());
   printf("SERVER-CLIENT DDS CONFIGURATION\n");
   printf("  dds domain: %d\n", dds_domain);
+  printf("  dds extra domains:");
+  for (int domain : dds_extra_domains)
+    printf(" %d", domain);
+  printf("\n");
+  printf("  dds shared memory: %s\n", dds_shared_memory ? "true" : "false");
+  printf("  request ack timeout: %.2f\n", request_ack_timeout);
+  printf("  request max retransmissions: %d\n", request_max_retransmissions);
   printf("  TOPICS\n");
   printf("    robot state: %s\n", dds_robot_state_topic.c_str());
   printf("    mode request: %s\n", dds_mode_request_topic.c_str());
   printf("    path request: %s\n", dds_path_request_topic.c_str());
   printf("    destination request: %s\n",
       dds_destination_request_topic.c_str());
+  printf("  COMPRESS PATHS: %s\n", dds_compress_paths ? "true" : "false");
+  printf("    extended robot state: %s\n",
+      dds_extended_robot_state_topic.c_str());
+  printf("    extended path request: %s\n",
+      dds_extended_path_request_topic.c_str());
+  printf("  TRACE REQUESTS: %s\n", enable_tracing ? "true" : "false");
+  printf("    extended mode request: %s\n",
+      dds_extended_mode_request_topic.c_str());
+  printf("    extended destination request: %s\n",
+      dds_extended_destination_request_topic.c_str());
+  printf("  COMPACT ROBOT STATE: %s\n",
+      dds_compact_robot_state ? "true" : "false");
+  printf("    compact robot state: %s\n",
+      dds_compact_robot_state_topic.c_str());
+  printf("    name registry: %s\n", dds_name_registry_topic.c_str());
+  printf("  PRIORITY MODE REQUEST: %s\n",
+      dds_priority_mode_request ? "true" : "false");
+  printf("    priority mode request: %s\n",
+      dds_priority_mode_request_topic.c_str());
+  printf("  FLEET PATH REQUEST: %s\n",
+      dds_fleet_path_request ? "true" : "false");
+  printf("    fleet path request: %s\n",
+      dds_fleet_path_request_topic.c_str());
   printf("COORDINATE TRANSFORMATION\n");
   printf("  translation x (meters): %.3f\n", translation_x);
   printf("  translation y (meters): %.3f\n", translation_y);
   printf("  rotation (radians): %.3f\n", rotation);
   printf("  scale: %.3f\n", scale);
+  printf("TRACING\n");
+  printf("  enabled: %s\n", enable_tracing ? "true" : "false");
+  printf("  report period (seconds): %.1f\n", trace_report_period);
+  printf("METRICS\n");
+  printf("  port: %d\n", metrics_port);
+  printf("  file: %s\n", metrics_file.c_str());
+  printf("  file period (seconds): %.1f\n", metrics_file_period);
+  printf("STATE HISTORY\n");
+  printf("  file: %s\n", history_file.c_str());
+  printf("  capacity: %d\n", history_capacity);
+  printf("CONFLICT DETECTION\n");
+  printf("  enabled: %s\n", enable_conflict_detection ? "true" : "false");
+  printf("  cell size (meters): %.2f\n", conflict_cell_size);
+  printf("  time window (seconds): %.2f\n", conflict_time_window);
 }
 
 ServerConfig ServerNodeConfig::get_server_config() const
 {
   ServerConfig server_config;
   server_config.dds_domain = dds_domain;
+  server_config.dds_extra_domains = dds_extra_domains;
   server_config.dds_robot_state_topic = dds_robot_state_topic;
   server_config.dds_mode_request_topic = dds_mode_request_topic;
   server_config.dds_path_request_topic = dds_path_request_topic;
   server_config.dds_destination_request_topic = dds_destination_request_topic;
+  server_config.dds_shared_memory = dds_shared_memory;
+  server_config.dds_compress_paths = dds_compress_paths;
+  server_config.dds_extended_robot_state_topic =
+      dds_extended_robot_state_topic;
+  server_config.dds_extended_path_request_topic =
+      dds_extended_path_request_topic;
+  server_config.dds_trace_requests = enable_tracing;
+  server_config.dds_extended_mode_request_topic =
+      dds_extended_mode_request_topic;
+  server_config.dds_extended_destination_request_topic =
+      dds_extended_destination_request_topic;
+  server_config.request_ack_timeout = request_ack_timeout;
+  server_config.request_max_retransmissions = request_max_retransmissions;
+  server_config.dds_compact_robot_state = dds_compact_robot_state;
+  server_config.dds_compact_robot_state_topic = dds_compact_robot_state_topic;
+  server_config.dds_name_registry_topic = dds_name_registry_topic;
+  server_config.dds_priority_mode_request = dds_priority_mode_request;
+  server_config.dds_priority_mode_request_topic =
+      dds_priority_mode_request_topic;
+  server_config.dds_fleet_path_request = dds_fleet_path_request;
+  server_config.dds_fleet_path_request_topic = dds_fleet_path_request_topic;
   return server_config;
 }
 
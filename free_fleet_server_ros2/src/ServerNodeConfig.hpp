@@ -19,6 +19,7 @@
 #define FREE_FLEET_SERVER_ROS2__SRC__SERVERNODECONFIG_HPP
 
 #include <string>
+#include <vector>
 
 namespace free_fleet
 {
@@ -34,16 +35,47 @@ struct ServerNodeConfig
   std::string mode_request_topic = "mode_request";
   std::string path_request_topic = "path_request";
   std::string destination_request_topic = "destination_request";
+  std::string query_robots_service = "query_robots";
 
   int dds_domain = 42;
+  std::vector<int> dds_extra_domains;
   std::string dds_robot_state_topic = "robot_state";
   std::string dds_mode_request_topic = "mode_request";
   std::string dds_path_request_topic = "path_request";
   std::string dds_destination_request_topic = "destination_request";
+  bool dds_shared_memory = false;
+  bool dds_compress_paths = false;
+  std::string dds_extended_robot_state_topic = "extended_robot_state";
+  std::string dds_extended_path_request_topic = "extended_path_request";
+  std::string dds_extended_mode_request_topic = "extended_mode_request";
+  std::string dds_extended_destination_request_topic =
+      "extended_destination_request";
+  double request_ack_timeout = 0.0;
+  int request_max_retransmissions = 3;
+  bool dds_compact_robot_state = false;
+  std::string dds_compact_robot_state_topic = "compact_robot_state";
+  std::string dds_name_registry_topic = "name_registry";
+  bool dds_priority_mode_request = false;
+  std::string dds_priority_mode_request_topic = "priority_mode_request";
+  bool dds_fleet_path_request = false;
+  std::string dds_fleet_path_request_topic = "fleet_path_request";
 
   double update_state_frequency = 10.0;
   double publish_state_frequency = 10.0;
 
+  // width in meters of the grid cells indexing robot locations, best chosen
+  // around the typical radius of robot queries
+  double spatial_index_cell_size = 2.0;
+
+  // robot states are ingested by this many workers in parallel, each
+  // keeping the states of the robots whose name hashes to its shard
+  int ingest_worker_num = 1;
+
+  // path requests received within each period are sent together, as a
+  // single fleet path request when it is enabled, the latest request of each
+  // robot replacing earlier ones. Disabled when not positive.
+  double path_request_batch_period = 0.0;
+
   // the transformation order of operations from the server to the client is:
   // 1) scale
   // 2) rotate
@@ -53,6 +85,30 @@ struct ServerNodeConfig
   double translation_x = 0.0;
   double translation_y = 0.0;
 
+  // when enabled, every request from RMF starts a trace that follows it down
+  // to the client on the extended request topics, and the latency of each
+  // stage is reported periodically. Clients need dds_trace_requests.
+  bool enable_tracing = false;
+  double trace_report_period = 60.0;
+
+  // metrics are served in the Prometheus text format on the local port when
+  // it is positive, and written periodically to the file when it is set
+  int metrics_port = 0;
+  std::string metrics_file = "";
+  double metrics_file_period = 5.0;
+
+  // every ingested robot state is appended to a memory mapped ring file when
+  // it is set, keeping the latest history_capacity states of the fleet
+  std::string history_file = "";
+  int history_capacity = 1000000;
+
+  // when enabled, the paths of robot states and path requests are reserved
+  // in a grid of cells and time windows, and path requests intersecting the
+  // reservations of other robots are reported
+  bool enable_conflict_detection = false;
+  double conflict_cell_size = 1.0;
+  double conflict_time_window = 2.0;
+
   void print_config() const;
 
   ServerConfig get_server_config() const;
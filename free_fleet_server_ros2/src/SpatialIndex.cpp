@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "SpatialIndex.hpp"
+
+namespace free_fleet
+{
+namespace ros2
+{
+
+namespace {
+
+bool closer(
+    const SpatialIndex::Result& _first, const SpatialIndex::Result& _second)
+{
+  return _first.distance < _second.distance;
+}
+
+} // namespace
+
+SpatialIndex::SpatialIndex(double _cell_size) :
+  cell_size(_cell_size > 0.0 ? _cell_size : 2.0)
+{}
+
+void SpatialIndex::update(
+    RobotId _robot_id, const std::string& _level_name, double _x, double _y)
+{
+  // A robot without a valid position can not be found by location, and
+  // would otherwise stretch the level bounds to the edges of the grid
+  if (!std::isfinite(_x) || !std::isfinite(_y))
+  {
+    if (_robot_id < entries.size())
+      remove(_robot_id);
+    return;
+  }
+
+  auto inserted = level_indices.insert({_level_name, levels.size()});
+  if (inserted.second)
+    levels.emplace_back();
+  const std::size_t level_index = inserted.first->second;
+  Level& level = levels[level_index];
+
+  if (entries.size() <= _robot_id)
+    entries.resize(_robot_id + 1);
+  Entry& entry = entries[_robot_id];
+
+  const int32_t cell_x = to_cell(_x);
+  const int32_t cell_y = to_cell(_y);
+  const CellKey cell = make_key(cell_x, cell_y);
+  entry.x = _x;
+  entry.y = _y;
+  if (entry.indexed && entry.level_index == level_index && entry.cell == cell)
+    return;
+
+  remove(_robot_id);
+  std::vector<RobotId>& robot_ids = level.cells[cell];
+  entry.indexed = true;
+  entry.level_index = level_index;
+  entry.cell = cell;
+  entry.slot = robot_ids.size();
+  robot_ids.push_back(_robot_id);
+  ++level.robot_num;
+
+  level.min_x = std::min(level.min_x, cell_x);
+  level.min_y = std::min(level.min_y, cell_y);
+  level.max_x = std::max(level.max_x, cell_x);
+  level.max_y = std::max(level.max_y, cell_y);
+}
+
+void SpatialIndex::clear()
+{
+  level_indices.clear();
+  levels.clear();
+  entries.clear();
+}
+
+void SpatialIndex::find_within(
+    const std::string& _level_name, double _x, double _y, double _radius,
+    std::vector<Result>& _results) const
+{
+  _results.clear();
+  const Level* level = find_level(_level_name);
+  if (!level || !(_radius >= 0.0) || !std::isfinite(_x) || !std::isfinite(_y))
+    return;
+
+  const int32_t begin_x = std::max(to_cell(_x - _radius), level->min_x);
+  const int32_t end_x = std::min(to_cell(_x + _radius), level->max_x);
+  const int32_t begin_y = std::max(to_cell(_y - _radius), level->min_y);
+  const int32_t end_y = std::min(to_cell(_y + _radius), level->max_y);
+  if (begin_x > end_x || begin_y > end_y)
+    return;
+
+  // Large radii visit the occupied cells rather than every cell in range
+  const double range_cells =
+      (static_cast<double>(end_x) - begin_x + 1) *
+      (static_cast<double>(end_y) - begin_y + 1);
+  if (range_cells > static_cast<double>(level->cells.size()))
+    collect_all(*level, _x, _y, _radius, _results);
+  else
+  {
+    for (int32_t cell_x = begin_x; cell_x <= end_x; ++cell_x)
+    {
+      for (int32_t cell_y = begin_y; cell_y <= end_y; ++cell_y)
+        collect(*level, cell_x, cell_y, _x, _y, _radius, _results);
+    }
+  }
+  std::sort(_results.begin(), _results.end(), closer);
+}
+
+void SpatialIndex::find_nearest(
+    const std::string& _level_name, double _x, double _y, std::size_t _k,
+    std::vector<Result>& _results, double _max_radius) const
+{
+  _results.clear();
+  const Level* level = find_level(_level_name);
+  if (!level || level->robot_num == 0 || _k == 0 || !(_max_radius >= 0.0) ||
+      !std::isfinite(_x) || !std::isfinite(_y))
+    return;
+
+  // Searches rings of cells of growing size around the query cell, clamped
+  // to the level bounds. Robots beyond ring r are at least r cells away, so
+  // the search stops as soon as the k nearest robots found so far are all
+  // closer than that. Rings before the first one that reaches the bounds
+  // are empty and skipped.
+  const int64_t center_x = to_cell(_x);
+  const int64_t center_y = to_cell(_y);
+  const int64_t first_ring = std::max<int64_t>(
+      std::max(
+          std::max<int64_t>(level->min_x - center_x, center_x - level->max_x),
+          std::max<int64_t>(level->min_y - center_y, center_y - level->max_y)),
+      0);
+  const int64_t max_ring = std::max(
+      std::max(center_x - level->min_x, level->max_x - center_x),
+      std::max(center_y - level->min_y, level->max_y - center_y));
+  std::size_t visited = 0;
+  for (int64_t ring = first_ring; ring <= max_ring; ++ring)
+  {
+    // Robots in ring r are further than r - 1 cells away
+    if (static_cast<double>(ring - 1) * cell_size > _max_radius)
+      break;
+
+    const int64_t begin_x = std::max<int64_t>(center_x - ring, level->min_x);
+    const int64_t end_x = std::min<int64_t>(center_x + ring, level->max_x);
+    const int64_t begin_y = std::max<int64_t>(center_y - ring, level->min_y);
+    const int64_t end_y = std::min<int64_t>(center_y + ring, level->max_y);
+
+    // Once the rings cover more cells than are occupied, for example around
+    // a robot far away from the others, the occupied cells are visited
+    // instead, all at once
+    const double covered_cells =
+        static_cast<double>(end_x - begin_x + 1) *
+        static_cast<double>(end_y - begin_y + 1);
+    if (covered_cells > static_cast<double>(level->cells.size()))
+    {
+      _results.clear();
+      collect_all(*level, _x, _y, _max_radius, _results);
+      break;
+    }
+
+    for (int64_t cell_x = begin_x; cell_x <= end_x; ++cell_x)
+    {
+      const std::size_t before = _results.size();
+
+      // Only the top and bottom rows of the ring span its whole width
+      if (cell_x == center_x - ring || cell_x == center_x + ring)
+      {
+        for (int64_t cell_y = begin_y; cell_y <= end_y; ++cell_y)
+          collect(
+              *level, static_cast<int32_t>(cell_x),
+              static_cast<int32_t>(cell_y), _x, _y, _max_radius, _results);
+      }
+      else
+      {
+        if (center_y - ring >= begin_y)
+          collect(
+              *level, static_cast<int32_t>(cell_x),
+              static_cast<int32_t>(center_y - ring), _x, _y, _max_radius,
+              _results);
+        if (center_y + ring <= end_y)
+          collect(
+              *level, static_cast<int32_t>(cell_x),
+              static_cast<int32_t>(center_y + ring), _x, _y, _max_radius,
+              _results);
+      }
+      visited += _results.size() - before;
+    }
+
+    if (_results.size() >= _k)
+    {
+      std::nth_element(
+          _results.begin(), _results.begin() + (_k - 1), _results.end(),
+          closer);
+      if (_results[_k - 1].distance <= static_cast<double>(ring) * cell_size)
+        break;
+    }
+    if (visited == level->robot_num)
+      break;
+  }
+
+  if (_results.size() > _k)
+  {
+    std::partial_sort(
+        _results.begin(), _results.begin() + _k, _results.end(), closer);
+    _results.resize(_k);
+  }
+  else
+    std::sort(_results.begin(), _results.end(), closer);
+}
+
+int32_t SpatialIndex::to_cell(double _coordinate) const
+{
+  const double cell = std::floor(_coordinate / cell_size);
+  if (!(cell > std::numeric_limits<int32_t>::min()))
+    return std::numeric_limits<int32_t>::min();
+  if (cell >= std::numeric_limits<int32_t>::max())
+    return std::numeric_limits<int32_t>::max();
+  return static_cast<int32_t>(cell);
+}
+
+SpatialIndex::CellKey SpatialIndex::make_key(int32_t _cell_x, int32_t _cell_y)
+{
+  return (static_cast<CellKey>(static_cast<uint32_t>(_cell_x)) << 32) |
+      static_cast<uint32_t>(_cell_y);
+}
+
+void SpatialIndex::remove(RobotId _robot_id)
+{
+  Entry& entry = entries[_robot_id];
+  if (!entry.indexed)
+    return;
+
+  Level& level = levels[entry.level_index];
+  auto it = level.cells.find(entry.cell);
+  std::vector<RobotId>& robot_ids = it->second;
+  const RobotId moved_robot_id = robot_ids.back();
+  robot_ids[entry.slot] = moved_robot_id;
+  entries[moved_robot_id].slot = entry.slot;
+  robot_ids.pop_back();
+  if (robot_ids.empty())
+    level.cells.erase(it);
+  --level.robot_num;
+  entry.indexed = false;
+}
+
+const SpatialIndex::Level* SpatialIndex::find_level(
+    const std::string& _level_name) const
+{
+  auto it = level_indices.find(_level_name);
+  if (it == level_indices.end())
+    return nullptr;
+  return &levels[it->second];
+}
+
+void SpatialIndex::collect(
+    const Level& _level, int32_t _cell_x, int32_t _cell_y,
+    double _x, double _y, double _radius, std::vector<Result>& _results) const
+{
+  auto it = _level.cells.find(make_key(_cell_x, _cell_y));
+  if (it == _level.cells.end())
+    return;
+
+  for (RobotId robot_id : it->second)
+  {
+    const Entry& entry = entries[robot_id];
+    const double distance = std::hypot(entry.x - _x, entry.y - _y);
+    if (distance <= _radius)
+      _results.push_back(Result{robot_id, distance});
+  }
+}
+
+void SpatialIndex::collect_all(
+    const Level& _level, double _x, double _y, double _radius,
+    std::vector<Result>& _results) const
+{
+  for (const auto& cell : _level.cells)
+  {
+    for (RobotId robot_id : cell.second)
+    {
+      const Entry& entry = entries[robot_id];
+      const double distance = std::hypot(entry.x - _x, entry.y - _y);
+      if (distance <= _radius)
+        _results.push_back(Result{robot_id, distance});
+    }
+  }
+}
+
+} // namespace ros2
+} // namespace free_fleet
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef FREE_FLEET_SERVER_ROS2__SRC__SPATIALINDEX_HPP
+#define FREE_FLEET_SERVER_ROS2__SRC__SPATIALINDEX_HPP
+
+#include <limits>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+namespace free_fleet
+{
+namespace ros2
+{
+
+/// Uniform grid over the latest robot positions, one per level. Moving a
+/// robot only touches the cells it leaves and enters, and queries only visit
+/// the cells around the query point.
+class SpatialIndex
+{
+public:
+
+  using RobotId = uint32_t;
+
+  struct Result
+  {
+    RobotId robot_id;
+    double distance;
+  };
+
+  /// \param[in] cell_size
+  ///   Width of the square grid cells in meters, best chosen around the
+  ///   typical query radius.
+  SpatialIndex(double cell_size = 2.0);
+
+  /// Inserts a robot, or moves it if it was already indexed. Robots whose
+  /// position is not finite are removed from the index instead, until they
+  /// report a valid one again.
+  void update(
+      RobotId robot_id, const std::string& level_name, double x, double y);
+
+  void clear();
+
+  /// Finds the robots on a level within a radius of a point.
+  ///
+  /// \param[out] results
+  ///   Robots found, ordered by increasing distance.
+  void find_within(
+      const std::string& level_name, double x, double y, double radius,
+      std::vector<Result>& results) const;
+
+  /// Finds the robots on a level nearest to a point.
+  ///
+  /// \param[in] k
+  ///   Maximum number of robots returned.
+  /// \param[in] max_radius
+  ///   Robots further than this are ignored.
+  /// \param[out] results
+  ///   Robots found, ordered by increasing distance.
+  void find_nearest(
+      const std::string& level_name, double x, double y, std::size_t k,
+      std::vector<Result>& results,
+      double max_radius = std::numeric_limits<double>::infinity()) const;
+
+private:
+
+  using CellKey = uint64_t;
+
+  struct Level
+  {
+    std::unordered_map<CellKey, std::vector<RobotId>> cells;
+
+    std::size_t robot_num = 0;
+
+    /// Bounds of every cell that was ever occupied, in cell coordinates
+    int32_t min_x = std::numeric_limits<int32_t>::max();
+    int32_t min_y = std::numeric_limits<int32_t>::max();
+    int32_t max_x = std::numeric_limits<int32_t>::min();
+    int32_t max_y = std::numeric_limits<int32_t>::min();
+  };
+
+  struct Entry
+  {
+    bool indexed = false;
+    std::size_t level_index;
+    CellKey cell;
+    /// Position of the robot within its cell
+    std::size_t slot;
+    double x;
+    double y;
+  };
+
+  int32_t to_cell(double coordinate) const;
+
+  static CellKey make_key(int32_t cell_x, int32_t cell_y);
+
+  void remove(RobotId robot_id);
+
+  const Level* find_level(const std::string& level_name) const;
+
+  /// Appends the robots of a cell that are within the radius of a point.
+  void collect(
+      const Level& level, int32_t cell_x, int32_t cell_y,
+      double x, double y, double radius, std::vector<Result>& results) const;
+
+  /// Appends the robots of every occupied cell of a level that are within
+  /// the radius of a point, cheaper than visiting a range of cells that is
+  /// larger than the number of occupied ones.
+  void collect_all(
+      const Level& level, double x, double y, double radius,
+      std::vector<Result>& results) const;
+
+  double cell_size;
+
+  std::unordered_map<std::string, std::size_t> level_indices;
+
+  std::vector<Level> levels;
+
+  /// Indexed by robot ID
+  std::vector<Entry> entries;
+
+};
+
+} // namespace ros2
+} // namespace free_fleet
+
+#endif // FREE_FLEET_SERVER_ROS2__SRC__SPATIALINDEX_HPP
@@ -36,7 +36,7 @@ int main(int argc, char** argv)
     return 1;
 
   rclcpp::executors::MultiThreadedExecutor executor {
-      rclcpp::executor::ExecutorArgs(), 2};
+      rclcpp::executor::ExecutorArgs(), 3};
   executor.add_node(server_node);
   executor.spin();
 
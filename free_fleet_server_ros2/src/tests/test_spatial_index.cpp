@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2019 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+
+#include <cmath>
+#include <cstdio>
+#include <chrono>
+#include <limits>
+#include <vector>
+
+#include "../SpatialIndex.hpp"
+
+using free_fleet::ros2::SpatialIndex;
+
+namespace {
+
+int failures = 0;
+
+void check(bool _condition, const char* _description)
+{
+  if (!_condition)
+  {
+    printf("FAILED: %s\n", _description);
+    ++failures;
+  }
+}
+
+double seconds_since(const std::chrono::steady_clock::time_point& _start)
+{
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - _start).count();
+}
+
+/// 100 robots on a 10 x 10 grid, 1 meter apart.
+void add_grid(SpatialIndex& _index)
+{
+  for (SpatialIndex::RobotId id = 0; id < 100; ++id)
+    _index.update(id, "L1", id % 10, id / 10);
+}
+
+void test_outlier_robot()
+{
+  SpatialIndex index;
+  add_grid(index);
+  index.update(100, "L1", 200000.0, 0.0);
+
+  std::vector<SpatialIndex::Result> results;
+  const auto start = std::chrono::steady_clock::now();
+  index.find_nearest("L1", 0.0, 0.0, 200, results);
+  check(seconds_since(start) < 1.0, "nearest with an outlier is fast");
+  check(results.size() == 101, "nearest with an outlier finds every robot");
+  check(results.back().robot_id == 100, "the outlier is the furthest");
+
+  index.find_nearest("L1", 0.0, 0.0, 3, results);
+  check(results.size() == 3 && results[0].robot_id == 0,
+      "nearest with an outlier finds the closest robots");
+
+  index.find_nearest("L1", 199999.0, 0.0, 1, results);
+  check(results.size() == 1 && results[0].robot_id == 100,
+      "nearest to the outlier finds it");
+
+  index.find_within("L1", 0.0, 0.0, 1.5, results);
+  check(results.size() == 4, "within with an outlier finds the close robots");
+}
+
+void test_non_finite_pose()
+{
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  SpatialIndex index;
+  add_grid(index);
+  index.update(100, "L1", nan, nan);
+  index.update(5, "L1", 0.0, nan);
+
+  std::vector<SpatialIndex::Result> results;
+  const auto start = std::chrono::steady_clock::now();
+  index.find_nearest("L1", 0.0, 0.0, 200, results);
+  check(seconds_since(start) < 1.0, "nearest with a NaN pose is fast");
+  check(results.size() == 99, "robots with a NaN pose are not indexed");
+  for (const auto& result : results)
+    check(result.robot_id != 5 && result.robot_id != 100,
+        "robots with a NaN pose are never found");
+
+  index.find_nearest("L1", nan, 0.0, 1, results);
+  check(results.empty(), "nearest to a NaN point finds nothing");
+  index.find_within("L1", 0.0, nan, 1.0, results);
+  check(results.empty(), "within a NaN point finds nothing");
+
+  index.update(5, "L1", 5.0, 0.0);
+  index.find_nearest("L1", 5.0, 0.0, 1, results);
+  check(results.size() == 1 && results[0].robot_id == 5,
+      "a robot is indexed again once its pose is valid");
+}
+
+} // namespace
+
+int main()
+{
+  test_outlier_robot();
+  test_non_finite_pose();
+  if (failures == 0)
+    printf("all spatial index checks passed\n");
+  return failures == 0 ? 0 : 1;
+}